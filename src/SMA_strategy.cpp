@@ -1,5 +1,6 @@
 #include "SMA_strategy.h"
-#include <iostream>
+#include "window_kernels.h"
+#include "logger.h"
 #include <thread>
 #include <chrono>
 #include <numeric>
@@ -15,13 +16,31 @@ SMAStrategy::SMAStrategy(BinanceAPI& api, OrderManager& orderManager,
     , symbol(symbol)
     , shortPeriod(shortPeriod)
     , longPeriod(longPeriod)
-    , running(false) {}
+    , running(false)
+    , marketData(nullptr)
+    , priceHistory(longPeriod) {}
 
 void SMAStrategy::run() {
     running = true;
     while (running) {
-        std::cout << "Strategy running..." << std::endl;
-        std::this_thread::sleep_for(std::chrono::seconds(1));
+        if (!marketData) {
+            LOG_INFO("Strategy running...");
+            std::this_thread::sleep_for(std::chrono::seconds(1));
+            continue;
+        }
+
+        // React to each event as it arrives
+        MarketEvent event;
+        if (!marketData->pop(event, std::chrono::milliseconds(1000))) continue;
+        if (!event.isUpdate() || event.symbol != symbol) continue;
+
+        updateMarketData(event.price);
+        bool enter = shouldEnterLong();
+        bool exit = shouldExitLong();
+        marketData->recordSignal(event);
+        if (enter || exit) {
+            LOG_INFO(symbol, " ", (enter ? "enter" : "exit"), " signal at ", event.price);
+        }
     }
 }
 
@@ -30,10 +49,8 @@ void SMAStrategy::stop() {
 }
 
 void SMAStrategy::updateMarketData(double historicalPrice) {
+    // Ring buffer keeps the last longPeriod prices without moving memory
     priceHistory.push_back(historicalPrice);
-    if (priceHistory.size() > longPeriod) {
-        priceHistory.erase(priceHistory.begin());
-    }
 }
 
 bool SMAStrategy::shouldEnterLong() const {
@@ -57,10 +74,5 @@ bool SMAStrategy::shouldExitLong() const {
 double SMAStrategy::calculateSMA(int period) const {
     if (priceHistory.size() < period) return 0.0;
     
-    double sum = std::accumulate(
-        priceHistory.end() - period,
-        priceHistory.end(),
-        0.0
-    );
-    return sum / period;
+    return windowMean(priceHistory.last(period).data(), period);
 } 
\ No newline at end of file
@@ -2,6 +2,8 @@
 
 #include "api.h"
 #include "order_manager.h"
+#include "series_buffer.h"
+#include "market_stream.h"
 #include <string>
 #include <atomic>
 #include <vector>
@@ -11,6 +13,9 @@ public:
     SMAStrategy(BinanceAPI& api, OrderManager& orderManager, 
                 const std::string& symbol, int shortPeriod, int longPeriod);
     
+    // Feed run() from `stream` instead of idling; events for other symbols are ignored
+    void attachMarketData(MarketDataStream& stream) { marketData = &stream; }
+
     void run();
     void stop();
     void updateMarketData(double historicalPrice);
@@ -24,7 +29,8 @@ private:
     int shortPeriod;
     int longPeriod;
     std::atomic<bool> running;
+    MarketDataStream* marketData;
     double lastPrice;
-    std::vector<double> priceHistory;
+    SeriesBuffer<double> priceHistory;
     double calculateSMA(int period) const;
 }; 
\ No newline at end of file
@@ -1,11 +1,12 @@
-#include <iostream>
-#include <openssl/hmac.h>
-#include <openssl/sha.h>
-#include <iomanip>
-#include <sstream>
 #include <curl/curl.h>
 #include "api.h"
 #include "config/config.h"
+#include "connection_pool.h"
+#include "async_http.h"
+#include "request_scheduler.h"
+#include "clock_sync.h"
+#include "response_decoder.h"
+#include "logger.h"
 
 // Define the static member function
 size_t BinanceAPI::WriteCallback(void* contents, size_t size, size_t nmemb, std::string* userp) {
@@ -13,74 +14,98 @@ size_t BinanceAPI::WriteCallback(void* contents, size_t size, size_t nmemb, std:
     return size * nmemb;
 }
 
-// Generate HMAC-SHA256 signature for API request authentication
-std::string BinanceAPI::hmac_sha256(const std::string &key, const std::string &data) {
-    unsigned char* digest;
-    digest = HMAC(EVP_sha256(), key.c_str(), key.length(), (unsigned char*)data.c_str(), data.length(), NULL, NULL);
-    if (!digest) {
-        std::cerr << "HMAC calculation failed!" << std::endl;
-        return "";
+BinanceAPI::BinanceAPI()
+    : config(Config::getInstance())
+    , signer(config.getApiSecret())
+    , base_url(config.getSetting("base_url"))
+    , auth_headers(nullptr) {
+    auth_headers = curl_slist_append(auth_headers, ("X-MBX-APIKEY: " + config.getApiKey()).c_str());
+
+    public_retry.attempts = std::stoi(config.getSetting("retry_attempts", "3"));
+    public_retry.backoff = std::chrono::milliseconds(std::stoi(config.getSetting("retry_delay", "100")));
+    public_retry.maxBackoff = std::chrono::milliseconds(std::stoi(config.getSetting("retry_max_delay", "2000")));
+    public_retry.attemptTimeout = std::chrono::milliseconds(std::stoi(config.getSetting("attempt_timeout", "2000")));
+    public_retry.hedge = config.getSetting("hedge_requests", "true") == "true";
+    public_retry.minHedgeDelay = std::chrono::milliseconds(std::stoi(config.getSetting("hedge_min_delay", "20")));
+}
+
+BinanceAPI::~BinanceAPI() {
+    curl_slist_free_all(auth_headers);
+}
+
+// recvWindow and the exchange-clock timestamp, right before signing
+void BinanceAPI::add_timing(RequestBuilder &request) {
+    ClockSync& clock = ClockSync::getInstance();
+    if (clock.recvWindowMs() > 0) request.add("recvWindow", clock.recvWindowMs());
+    request.addTimestamp(clock.exchangeTimeMs());
+}
+
+// -1021 means the timestamp was outside recvWindow: the clock estimate is off
+static void check_timestamp_error(const std::string &body) {
+    ApiError error;
+    if (decodeApiError(body, error) && error.code == -1021) {
+        ClockSync::getInstance().requestSync();
     }
-    
-    std::ostringstream oss;
-    for (int i = 0; i < SHA256_DIGEST_LENGTH; i++) {
-        oss << std::hex << std::setw(2) << std::setfill('0') << (int)digest[i];
+}
+
+// Append timestamp and signature to an engine request's URL; called when
+// the scheduler admits it, so time spent queued does not count against
+// recvWindow (the blocking path signs after acquire() the same way)
+bool BinanceAPI::sign_request(HttpRequest &request) {
+    std::string_view url = request.url;
+    size_t query = url.find('?');
+    RequestBuilder builder;
+    builder.url(url.substr(0, query), "");
+    if (query != std::string_view::npos) builder.addQuery(url.substr(query + 1));
+    add_timing(builder);
+    if (!builder.sign(signer) || !builder.ok()) {
+        LOG_ERROR("Failed to build signed request (longer than ", RequestBuilder::CAPACITY, " bytes?)");
+        return false;
     }
-    return oss.str();
+    request.url.assign(builder.str());
+    return true;
 }
 
-// Send authenticated request to Binance API
 std::string BinanceAPI::send_signed_request(const std::string &endpoint, const std::string &query, const std::string &method) {
-    // Get current timestamp in milliseconds using chrono
-    auto now = std::chrono::system_clock::now();
-    auto millis = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count();
-    
-    // Build the query string carefully
-    std::string params = query;
-    if (!params.empty() && params.back() != '&') {
-        params += '&';
+    RequestBuilder request;
+    begin_request(request, endpoint.c_str());
+    request.addQuery(query);
+    return send_signed_request(request, method.c_str());
+}
+
+// Send authenticated request to Binance API
+std::string BinanceAPI::send_signed_request(RequestBuilder &request, const char *method, long *http_status) {
+    if (http_status) *http_status = 0;
+    // Wait for the rate limits first so the timestamp is taken when it is sent
+    RequestScheduler& scheduler = RequestScheduler::getInstance();
+    scheduler.acquire(requestCost(method, request.str().substr(base_url.size())));
+
+    add_timing(request);
+    if (!request.sign(signer) || !request.ok()) {
+        LOG_ERROR("Failed to build signed request (longer than ", RequestBuilder::CAPACITY, " bytes?)");
+        return "";
     }
-    params += "timestamp=" + std::to_string(millis);
-    
-    // Calculate signature
-    std::string signature = hmac_sha256(config.getApiSecret(), params);
-    
-    // Build final query with signature
-    std::string final_params = params + "&signature=" + signature;
-    
-    std::string url = config.getSetting("base_url") + endpoint;
-    
-    CURL* curl = curl_easy_init();
-    if (!curl) return "";
 
-    // Set up headers
-    struct curl_slist* headers = NULL;
-    headers = curl_slist_append(headers, ("X-MBX-APIKEY: " + config.getApiKey()).c_str());
-    
+    // Pooled handle: reuses a kept-alive connection when one is open
+    ConnectionPool::Handle handle = ConnectionPool::getInstance().acquire();
+    if (!handle) return "";
+    CURL* curl = handle.get();
+
     std::string response;
     
-    curl_easy_setopt(curl, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_1_1);
-    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
+    curl_easy_setopt(curl, CURLOPT_URL, request.c_str());
+    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, auth_headers);
     curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallback);
     curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response);
-    curl_easy_setopt(curl, CURLOPT_VERBOSE, 1L);
     
-    if (method == "POST") {
-        // For POST requests
-        curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+    if (std::string_view(method) == "POST") {
+        // Parameters stay in the URL with an empty POST body
         curl_easy_setopt(curl, CURLOPT_POST, 1L);
-        
-        // Use COPYPOSTFIELDS and append parameters to URL instead
-        std::string full_url = url + "?" + final_params;
-        curl_easy_setopt(curl, CURLOPT_URL, full_url.c_str());
-        curl_easy_setopt(curl, CURLOPT_POSTFIELDS, "");  // Empty POST body
-        
-        // Minimal debug output
-        std::cout << "Sending order to: " << url << std::endl;
+        curl_easy_setopt(curl, CURLOPT_POSTFIELDS, "");
+        LOG_DEBUG("Sending order to: ", request.endpoint());
+    } else if (std::string_view(method) == "DELETE") {
+        curl_easy_setopt(curl, CURLOPT_CUSTOMREQUEST, "DELETE");  // cleared when the handle goes back to the pool
     } else {
-        // For GET requests
-        std::string full_url = url + "?" + final_params;
-        curl_easy_setopt(curl, CURLOPT_URL, full_url.c_str());
         curl_easy_setopt(curl, CURLOPT_HTTPGET, 1L);
     }
 
@@ -90,66 +115,87 @@ std::string BinanceAPI::send_signed_request(const std::string &endpoint, const s
     // Get HTTP response code and headers
     long http_code = 0;
     curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &http_code);
+    if (res == CURLE_OK) scheduler.observe(curl, http_code);
+    if (http_status) *http_status = http_code;
     
-    // Print response headers for debugging
     if (http_code >= 400) {
         char* content_type;
         curl_easy_getinfo(curl, CURLINFO_CONTENT_TYPE, &content_type);
-        std::cerr << "HTTP error " << http_code << std::endl;
-        std::cerr << "Content-Type: " << (content_type ? content_type : "unknown") << std::endl;
-        std::cerr << "Response: " << response << std::endl;
+        LOG_ERROR("HTTP error ", http_code, " (", (content_type ? content_type : "unknown"), "): ", response);
+        check_timestamp_error(response);
     }
     
-    curl_slist_free_all(headers);
-    curl_easy_cleanup(curl);
-    
     if (res != CURLE_OK) {
-        std::cerr << "Failed to execute request: " << curl_easy_strerror(res) << std::endl;
+        LOG_ERROR("Failed to execute request: ", curl_easy_strerror(res));
         return "";
     }
 
     return response;
 }
 
-// Send unauthenticated request to Binance API
+// Send unauthenticated request to Binance API. Runs on the engine so the
+// same request from several callers at once goes out only once.
 std::string BinanceAPI::send_public_request(const std::string &endpoint) {
-    CURL* curl = curl_easy_init();
-    if (!curl) return "";
+    return send_public_request_async(endpoint).get();
+}
 
-    std::string url = config.getSetting("base_url") + endpoint;
-    std::string response;
-    
-    // Configure CURL options
-    CURLcode code = CURLE_OK;
-    int timeout = std::stoi(config.getSetting("timeout", "30"));
-    if ((code = curl_easy_setopt(curl, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_1_1)) != CURLE_OK ||
-        (code = curl_easy_setopt(curl, CURLOPT_URL, url.c_str())) != CURLE_OK ||
-        (code = curl_easy_setopt(curl, CURLOPT_HTTPGET, 1L)) != CURLE_OK ||
-        (code = curl_easy_setopt(curl, CURLOPT_TIMEOUT, timeout)) != CURLE_OK ||
-        (code = curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallback)) != CURLE_OK ||
-        (code = curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response)) != CURLE_OK ||
-        (code = curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, 1L)) != CURLE_OK ||
-        (code = curl_easy_setopt(curl, CURLOPT_SSL_VERIFYHOST, 2L)) != CURLE_OK ||
-        (code = curl_easy_setopt(curl, CURLOPT_VERBOSE, 1L)) != CURLE_OK) {
-        curl_easy_cleanup(curl);
+// Build an engine request for a signed endpoint, signed by sign_request()
+// once admitted. Not retried: a POST may have reached the exchange even
+// when the response was lost.
+HttpRequest BinanceAPI::signed_request(const std::string &endpoint, const std::string &query, const std::string &method) {
+    HttpRequest request;
+    request.url = base_url + endpoint + "?" + query;
+    request.method = method;
+    request.headers.push_back("X-MBX-APIKEY: " + config.getApiKey());
+    return request;
+}
+
+// Public endpoints only read, so a slow try may be raced by a second copy
+HttpRequest BinanceAPI::public_request(const std::string &endpoint) {
+    HttpRequest request;
+    request.url = base_url + endpoint;
+    request.retry = public_retry;
+    return request;
+}
+
+// Same result as the blocking calls: the body, or "" on a transport failure
+static std::string response_body(const HttpResponse &response) {
+    if (!response.ok()) {
+        LOG_ERROR("Failed to execute request: ", curl_easy_strerror(response.result));
         return "";
     }
-
-    // Execute request with retry logic
-    int retry_attempts = std::stoi(config.getSetting("retry_attempts", "3"));
-    int retry_delay = std::stoi(config.getSetting("retry_delay", "1000"));
-    
-    CURLcode res;
-    for (int i = 0; i < retry_attempts; i++) {
-        res = curl_easy_perform(curl);
-        if (res == CURLE_OK) break;
-        if (i < retry_attempts - 1) {
-            std::cerr << "Request failed, retrying in " << retry_delay << "ms..." << std::endl;
-            std::this_thread::sleep_for(std::chrono::milliseconds(retry_delay));
-        }
+    if (response.status >= 400) {
+        LOG_ERROR("HTTP error ", response.status, ": ", response.body);
+        check_timestamp_error(response.body);
     }
+    return response.body;
+}
 
-    curl_easy_cleanup(curl);
-    
-    return (res == CURLE_OK) ? response : "";
+std::future<std::string> BinanceAPI::send_signed_request_async(const std::string &endpoint, const std::string &query, const std::string &method) {
+    auto promise = std::make_shared<std::promise<std::string>>();
+    std::future<std::string> result = promise->get_future();
+    send_signed_request_async(endpoint, query, method, [promise](const std::string &body) {
+        promise->set_value(body);
+    });
+    return result;
+}
+
+void BinanceAPI::send_signed_request_async(const std::string &endpoint, const std::string &query, const std::string &method, ResponseCallback callback) {
+    RequestScheduler::getInstance().submit(signed_request(endpoint, query, method), requestCost(method, endpoint + "?" + query),
+        [callback](HttpResponse &response) { callback(response_body(response)); },
+        [this](HttpRequest &request) { return sign_request(request); });
+}
+
+std::future<std::string> BinanceAPI::send_public_request_async(const std::string &endpoint) {
+    auto promise = std::make_shared<std::promise<std::string>>();
+    std::future<std::string> result = promise->get_future();
+    send_public_request_async(endpoint, [promise](const std::string &body) {
+        promise->set_value(body);
+    });
+    return result;
+}
+
+void BinanceAPI::send_public_request_async(const std::string &endpoint, ResponseCallback callback) {
+    RequestScheduler::getInstance().submitShared(public_request(endpoint), requestCost("GET", endpoint),
+        [callback](HttpResponse &response) { callback(response_body(response)); });
 }
@@ -2,18 +2,69 @@
 #include <string>
 #include <chrono>
 #include <thread>
+#include <functional>
+#include <future>
 #include "config/config.h"
+#include "hmac_signer.h"
+#include "request_builder.h"
+#include "retry_policy.h"
 
+struct HttpRequest;
+struct curl_slist;
+
+// Settings for public requests (config.json, all optional):
+//   retry_attempts    tries per request (default 3)
+//   retry_delay       ms before the first retry, doubling after (default 100)
+//   retry_max_delay   longest wait between tries in ms (default 2000)
+//   attempt_timeout   ms one try may take (default 2000)
+//   hedge_requests    "true" (default) sends a second copy of a try that runs
+//                     past the endpoint's recent p95 latency
+//   hedge_min_delay   ms before a second copy at the earliest (default 20)
 class BinanceAPI {
 private:
     const Config& config;
+    HmacSigner signer;  // keyed with the API secret once
+    std::string base_url;
+    curl_slist* auth_headers;  // X-MBX-APIKEY, built once and only read by curl
+    RetryPolicy public_retry;  // retries and hedging of public requests
     static size_t WriteCallback(void* contents, size_t size, size_t nmemb, std::string* userp);
-    std::string hmac_sha256(const std::string &key, const std::string &data);
+    void add_timing(RequestBuilder &request);
+    bool sign_request(HttpRequest &request);
+    HttpRequest signed_request(const std::string &endpoint, const std::string &query, const std::string &method);
+    HttpRequest public_request(const std::string &endpoint);
 
 public:
-    BinanceAPI() : config(Config::getInstance()) {}
+    using ResponseCallback = std::function<void(const std::string&)>;
+
+    BinanceAPI();
+    ~BinanceAPI();
+    BinanceAPI(const BinanceAPI&) = delete;
+    BinanceAPI& operator=(const BinanceAPI&) = delete;
+
     std::string send_signed_request(const std::string &endpoint, const std::string &query, const std::string &method = "GET");
+
+    // Allocation-free signed path: start `request` with begin_request(), add
+    // the parameters, then send; recvWindow, the timestamp (exchange clock,
+    // see ClockSync) and the signature are appended here. `http_status` gets
+    // the response status, 0 if none arrived.
+    void begin_request(RequestBuilder &request, const char *endpoint) const { request.url(base_url, endpoint); }
+    std::string send_signed_request(RequestBuilder &request, const char *method = "GET", long *http_status = nullptr);
     std::string send_public_request(const std::string &endpoint);
+
+    // Non-blocking variants run on the shared AsyncHttpClient event loop, so
+    // many requests can be in flight at once. They resolve to the same value
+    // as the blocking calls; callbacks run on the event loop thread and must
+    // not block. Public requests get a per-try deadline, are retried with
+    // backoff and hedged when slow (see RetryPolicy); signed ones are sent once.
+    // Every call, blocking or not, waits its turn in the RequestScheduler:
+    // orders go first, and identical public requests in flight are shared.
+    // Signed requests are timestamped and signed when the scheduler starts
+    // them, so time spent queued does not run down recvWindow; this object
+    // must outlive them.
+    std::future<std::string> send_signed_request_async(const std::string &endpoint, const std::string &query, const std::string &method = "GET");
+    void send_signed_request_async(const std::string &endpoint, const std::string &query, const std::string &method, ResponseCallback callback);
+    std::future<std::string> send_public_request_async(const std::string &endpoint);
+    void send_public_request_async(const std::string &endpoint, ResponseCallback callback);
     bool is_initialized() const { 
         return !config.getApiKey().empty() && !config.getApiSecret().empty(); 
     }
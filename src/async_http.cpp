@@ -0,0 +1,343 @@
+// async_http.cpp
+#include "async_http.h"
+#include <cctype>
+#include "config/config.h"
+#include "logger.h"
+
+std::string_view HttpResponse::header(std::string_view name) const {
+    for (const auto& entry : headers) {
+        if (entry.first.size() != name.size()) continue;
+        bool same = true;
+        for (size_t i = 0; same && i < name.size(); i++) {
+            same = std::tolower(static_cast<unsigned char>(entry.first[i])) == std::tolower(static_cast<unsigned char>(name[i]));
+        }
+        if (same) return entry.second;
+    }
+    return {};
+}
+
+AsyncHttpClient& AsyncHttpClient::getInstance() {
+    static AsyncHttpClient instance;
+    return instance;
+}
+
+AsyncHttpClient::AsyncHttpClient()
+    : multi(nullptr)
+    , stopping(false)
+    , outstanding(0)
+    , random(std::random_device{}()) {
+    // Make sure the pool (and curl_global_init) outlives this engine
+    ConnectionPool::getInstance();
+
+    multi = curl_multi_init();
+    if (!multi) {
+        LOG_ERROR("Failed to initialize CURL multi handle.");
+        return;
+    }
+    const Config& config = Config::getInstance();
+    long maxHostConnections = std::stol(config.getSetting("max_host_connections", "8"));
+    curl_multi_setopt(multi, CURLMOPT_MAX_HOST_CONNECTIONS, maxHostConnections);
+    curl_multi_setopt(multi, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+
+    loop = std::thread(&AsyncHttpClient::run, this);
+}
+
+AsyncHttpClient::~AsyncHttpClient() {
+    if (!multi) return;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    curl_multi_wakeup(multi);
+    loop.join();
+    curl_multi_cleanup(multi);
+}
+
+void AsyncHttpClient::submit(HttpRequest request, Callback callback) {
+    auto call = std::make_shared<Call>();
+    call->request = std::move(request);
+    call->callback = std::move(callback);
+    call->endpoint = call->request.url.substr(0, call->request.url.find('?'));
+
+    std::unique_lock<std::mutex> lock(mutex);
+    if (!multi || stopping) {
+        lock.unlock();
+        HttpResponse response;
+        response.result = CURLE_FAILED_INIT;
+        call->callback(response);
+        return;
+    }
+    submitted.push_back(std::move(call));
+    outstanding++;
+    lock.unlock();
+    curl_multi_wakeup(multi);
+}
+
+std::future<HttpResponse> AsyncHttpClient::submit(HttpRequest request) {
+    auto promise = std::make_shared<std::promise<HttpResponse>>();
+    std::future<HttpResponse> future = promise->get_future();
+    submit(std::move(request), [promise](HttpResponse& response) {
+        promise->set_value(std::move(response));
+    });
+    return future;
+}
+
+size_t AsyncHttpClient::inFlight() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return outstanding;
+}
+
+AsyncHttpClient::Stats AsyncHttpClient::getStats() const {
+    Stats result;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        result = stats;
+    }
+    result.latency = latency.summary();
+    return result;
+}
+
+size_t AsyncHttpClient::writeCallback(void* contents, size_t size, size_t nmemb, void* userp) {
+    static_cast<std::string*>(userp)->append(static_cast<char*>(contents), size * nmemb);
+    return size * nmemb;
+}
+
+void AsyncHttpClient::run() {
+    while (true) {
+        std::vector<std::shared_ptr<Call>> incoming;
+        bool stop;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            incoming.swap(submitted);
+            stop = stopping;
+        }
+        if (stop) break;
+
+        for (const auto& call : incoming) {
+            startTry(call, false);
+        }
+        runDueTimers();
+
+        int running = 0;
+        curl_multi_perform(multi, &running);
+
+        int queued = 0;
+        while (CURLMsg* message = curl_multi_info_read(multi, &queued)) {
+            if (message->msg == CURLMSG_DONE) {
+                finish(message->easy_handle, message->data.result);
+            }
+        }
+
+        curl_multi_poll(multi, nullptr, 0, pollTimeoutMs(), nullptr);
+    }
+
+    // Shutting down: fail whatever has not completed so no caller waits forever
+    std::vector<std::shared_ptr<Call>> abandoned;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        abandoned.swap(submitted);
+    }
+    for (auto& entry : active) {
+        curl_multi_remove_handle(multi, entry.first);
+        abandoned.push_back(entry.second->call);
+    }
+    for (auto& entry : timers) {
+        abandoned.push_back(entry.second.call);
+    }
+    active.clear();
+    timers.clear();
+    for (const auto& call : abandoned) {
+        if (call->done) continue;
+        HttpResponse response;
+        response.result = CURLE_ABORTED_BY_CALLBACK;
+        complete(*call, response);
+    }
+}
+
+// Start a try, or with `hedge` a second copy of the running one
+void AsyncHttpClient::startTry(const std::shared_ptr<Call>& call, bool hedge) {
+    auto transfer = std::make_unique<Transfer>();
+    transfer->call = call;
+    transfer->hedge = hedge;
+    transfer->handle = ConnectionPool::getInstance().acquire();
+    if (!transfer->handle) {
+        if (call->running == 0) {
+            HttpResponse response;
+            response.result = CURLE_FAILED_INIT;
+            complete(*call, response);
+        }
+        return;
+    }
+
+    CURL* curl = transfer->handle.get();
+    const HttpRequest& request = call->request;
+    if (!call->headers) {
+        for (const std::string& header : request.headers) {
+            call->headers = curl_slist_append(call->headers, header.c_str());
+        }
+    }
+    curl_easy_setopt(curl, CURLOPT_URL, request.url.c_str());
+    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, call->headers);
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, writeCallback);
+    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &transfer->response.body);
+    curl_easy_setopt(curl, CURLOPT_PIPEWAIT, 1L);  // prefer multiplexing over a new connection
+    if (request.retry.attemptTimeout.count() > 0) {
+        curl_easy_setopt(curl, CURLOPT_TIMEOUT_MS, static_cast<long>(request.retry.attemptTimeout.count()));
+    }
+    if (request.method == "POST") {
+        curl_easy_setopt(curl, CURLOPT_POST, 1L);
+        curl_easy_setopt(curl, CURLOPT_POSTFIELDS, "");
+    } else if (request.method == "DELETE") {
+        curl_easy_setopt(curl, CURLOPT_CUSTOMREQUEST, "DELETE");
+    } else {
+        curl_easy_setopt(curl, CURLOPT_HTTPGET, 1L);
+    }
+
+    CURLMcode code = curl_multi_add_handle(multi, curl);
+    if (code != CURLM_OK) {
+        LOG_ERROR("Failed to start request: ", curl_multi_strerror(code));
+        if (call->running == 0) {
+            HttpResponse response;
+            response.result = CURLE_FAILED_INIT;
+            complete(*call, response);
+        }
+        return;
+    }
+    if (hedge) call->hedges++;
+    else call->tries++;
+    call->running++;
+    transfer->started = Clock::now();
+    active[curl] = std::move(transfer);
+
+    // Race a copy if this try is still out after the endpoint's usual p95
+    if (!hedge && request.retry.hedge) {
+        Clock::duration delay = latency.p95(call->endpoint);
+        if (delay > Clock::duration::zero()) {
+            delay = std::max<Clock::duration>(delay, request.retry.minHedgeDelay);
+            timers.emplace(Clock::now() + delay, Timer{call, call->tries});
+        }
+    }
+}
+
+void AsyncHttpClient::finish(CURL* curl, CURLcode result) {
+    curl_multi_remove_handle(multi, curl);
+    auto it = active.find(curl);
+    if (it == active.end()) return;
+    std::unique_ptr<Transfer> transfer = std::move(it->second);
+    active.erase(it);
+
+    Call& call = *transfer->call;
+    call.running--;
+    HttpResponse& response = transfer->response;
+    response.result = result;
+    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &response.status);
+    curl_header* header = nullptr;
+    while ((header = curl_easy_nextheader(curl, CURLH_HEADER, -1, header))) {
+        response.headers.emplace_back(header->name, header->value);
+    }
+    if (result == CURLE_OPERATION_TIMEDOUT) {
+        std::lock_guard<std::mutex> lock(mutex);
+        stats.timeouts++;
+    }
+
+    if (result == CURLE_OK && response.status < 500) {
+        latency.record(call.endpoint, Clock::now() - transfer->started);
+        if (transfer->hedge) {
+            std::lock_guard<std::mutex> lock(mutex);
+            stats.hedgeWins++;
+        }
+        response.hedged = transfer->hedge;
+        cancelOthers(&call);
+        complete(call, response);
+        return;
+    }
+
+    // Failed; a copy still out may yet answer
+    if (call.running > 0) return;
+    if (call.tries < call.request.retry.attempts) {
+        std::chrono::milliseconds delay = call.request.retry.retryDelay(call.tries, random);
+        LOG_WARN("Request failed (", (result != CURLE_OK ? curl_easy_strerror(result) : "HTTP " + std::to_string(response.status)), "), retrying in ", delay.count(), "ms...");
+        timers.emplace(Clock::now() + delay, Timer{transfer->call, 0});
+        return;
+    }
+    complete(call, response);
+}
+
+// Drop the copies of `call` still in flight once one has answered. A slow
+// try that lost still counts towards the latency, as at least its time so
+// far; leaving it out would pull the hedge delay down.
+void AsyncHttpClient::cancelOthers(const Call* call) {
+    Clock::time_point now = Clock::now();
+    for (auto it = active.begin(); it != active.end();) {
+        if (it->second->call.get() == call) {
+            if (!it->second->hedge) latency.record(call->endpoint, now - it->second->started);
+            curl_multi_remove_handle(multi, it->first);
+            it = active.erase(it);
+            std::lock_guard<std::mutex> lock(mutex);
+            stats.cancelled++;
+        } else {
+            ++it;
+        }
+    }
+}
+
+void AsyncHttpClient::complete(Call& call, HttpResponse& response) {
+    call.done = true;
+    call.running = 0;
+    if (call.headers) {
+        curl_slist_free_all(call.headers);
+        call.headers = nullptr;
+    }
+    response.attempts = call.tries + call.hedges;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        outstanding--;
+    }
+
+    try {
+        call.callback(response);
+    } catch (const std::exception& e) {
+        LOG_ERROR("Request callback failed: ", e.what());
+    }
+}
+
+// Retries whose backoff is over, and hedges for tries that are still out
+void AsyncHttpClient::runDueTimers() {
+    Clock::time_point now = Clock::now();
+    while (!timers.empty() && timers.begin()->first <= now) {
+        Timer timer = std::move(timers.begin()->second);
+        timers.erase(timers.begin());
+        Call& call = *timer.call;
+        if (call.done) continue;
+
+        const std::function<bool()>& admit = call.request.admitExtra;
+        if (timer.tryNumber == 0) {
+            if (admit && !admit()) {
+                timers.emplace(now + call.request.retry.retryDelay(call.tries, random), std::move(timer));
+                continue;
+            }
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stats.retries++;
+            }
+            startTry(timer.call, false);
+        } else if (timer.tryNumber == call.tries && call.running == 1 && (!admit || admit())) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stats.hedges++;
+            }
+            startTry(timer.call, true);
+        }
+    }
+}
+
+int AsyncHttpClient::pollTimeoutMs() const {
+    // Wake for the next timer; curl shortens this further for its own timers
+    int timeout = 1000;
+    if (!timers.empty()) {
+        auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(
+            timers.begin()->first - Clock::now()).count();
+        timeout = static_cast<int>(std::max<long long>(0, std::min<long long>(wait + 1, timeout)));
+    }
+    return timeout;
+}
@@ -0,0 +1,139 @@
+// async_http.h
+#pragma once
+#include <curl/curl.h>
+#include <chrono>
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "connection_pool.h"
+#include "retry_policy.h"
+
+struct HttpRequest {
+    std::string url;
+    std::string method = "GET";           // GET, POST or DELETE (query in the URL, empty body)
+    std::vector<std::string> headers;     // "Name: value"
+    RetryPolicy retry;                    // default: one try, no hedging
+
+    // Asked before a retry or hedge copy is sent (e.g. for rate limit
+    // budget); false skips the hedge and holds the retry back another backoff
+    std::function<bool()> admitExtra;
+};
+
+struct HttpResponse {
+    CURLcode result = CURLE_OK;
+    long status = 0;                      // HTTP status, 0 if no response arrived
+    std::string body;
+    std::vector<std::pair<std::string, std::string>> headers;  // of the try that answered
+    int attempts = 0;                     // tries and hedge copies started
+    bool hedged = false;                  // answered by a hedge copy
+
+    bool ok() const { return result == CURLE_OK; }
+
+    // Value of the first header called `name` (any case), empty if absent
+    std::string_view header(std::string_view name) const;
+};
+
+// Runs HTTP requests concurrently on a curl multi handle driven by one event
+// loop thread. Callers submit and immediately get a future (or a callback);
+// many requests can be in flight at once and a retry is a timer on the loop
+// instead of a sleeping caller. Each request's RetryPolicy sets its per-try
+// deadline, backoff and hedging; the hedge delay comes from the latency of
+// recent tries on the same endpoint.
+//
+// Easy handles are leased from ConnectionPool, so requests share its DNS and
+// TLS session caches and defaults; connections are kept alive in the multi
+// handle's cache and, with http_version "2", multiplexed over one connection.
+//
+// Setting (config.json, optional):
+//   max_host_connections  parallel connections per host (default 8); more
+//                         requests than that queue inside curl
+class AsyncHttpClient {
+public:
+    using Callback = std::function<void(HttpResponse&)>;
+
+    // Process-wide engine; the loop thread starts on first use
+    static AsyncHttpClient& getInstance();
+
+    AsyncHttpClient();
+    ~AsyncHttpClient();
+
+    AsyncHttpClient(const AsyncHttpClient&) = delete;
+    AsyncHttpClient& operator=(const AsyncHttpClient&) = delete;
+
+    // The callback runs on the event loop thread, so it must not block
+    void submit(HttpRequest request, Callback callback);
+    std::future<HttpResponse> submit(HttpRequest request);
+
+    struct Stats {
+        uint64_t retries = 0;
+        uint64_t timeouts = 0;       // tries cut off by attemptTimeout (or the pool timeout)
+        uint64_t hedges = 0;         // second copies sent
+        uint64_t hedgeWins = 0;      // ... that answered first
+        uint64_t cancelled = 0;      // copies dropped when the other answered
+        std::vector<LatencyTracker::Summary> latency;
+    };
+
+    size_t inFlight() const;
+    Stats getStats() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    // One submitted request across its tries and hedge copies
+    struct Call {
+        HttpRequest request;
+        Callback callback;
+        std::string endpoint;             // latency key: the URL without its query
+        curl_slist* headers = nullptr;
+        int tries = 0;
+        int hedges = 0;
+        int running = 0;
+        bool done = false;
+    };
+
+    struct Transfer {
+        std::shared_ptr<Call> call;
+        ConnectionPool::Handle handle;
+        HttpResponse response;
+        Clock::time_point started;
+        bool hedge = false;
+    };
+
+    struct Timer {
+        std::shared_ptr<Call> call;
+        int tryNumber;                    // hedge for this try, or 0 for a retry
+    };
+
+    void run();
+    void startTry(const std::shared_ptr<Call>& call, bool hedge);
+    void finish(CURL* curl, CURLcode result);
+    void cancelOthers(const Call* call);
+    void complete(Call& call, HttpResponse& response);
+    void runDueTimers();
+    int pollTimeoutMs() const;
+
+    static size_t writeCallback(void* contents, size_t size, size_t nmemb, void* userp);
+
+    CURLM* multi;
+    std::thread loop;
+
+    mutable std::mutex mutex;
+    bool stopping;
+    std::vector<std::shared_ptr<Call>> submitted;
+    size_t outstanding;
+    Stats stats;
+    LatencyTracker latency;
+
+    // Loop thread only
+    std::map<CURL*, std::unique_ptr<Transfer>> active;
+    std::multimap<Clock::time_point, Timer> timers;
+    std::minstd_rand random;
+};
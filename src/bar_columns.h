@@ -0,0 +1,17 @@
+// bar_columns.h
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include "series_buffer.h"
+
+// Column views over a bar dataset. Each column holds `count` values; the
+// views point either into a memory-mapped bar store or into a BarTable.
+struct BarColumns {
+    size_t count = 0;
+    SeriesView<int64_t> timestamp;  // epoch seconds (UTC)
+    SeriesView<double> open;
+    SeriesView<double> high;
+    SeriesView<double> low;
+    SeriesView<double> close;
+    SeriesView<double> volume;
+};
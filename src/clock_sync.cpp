@@ -0,0 +1,189 @@
+// clock_sync.cpp
+#include "clock_sync.h"
+#include <curl/curl.h>
+#include <algorithm>
+#include "config/config.h"
+#include "connection_pool.h"
+#include "rate_limiter.h"
+#include "request_scheduler.h"
+#include "response_decoder.h"
+#include "logger.h"
+
+static int64_t microsSinceEpoch(std::chrono::steady_clock::time_point time) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(time.time_since_epoch()).count();
+}
+
+static int64_t microsSinceEpoch(std::chrono::system_clock::time_point time) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(time.time_since_epoch()).count();
+}
+
+ClockSync& ClockSync::getInstance() {
+    static ClockSync instance;
+    return instance;
+}
+
+ClockSync::ClockSync()
+    : synced(false)
+    , steadyToExchangeUs(0)
+    , lastIssuedMs(0)
+    , stopping(false)
+    , resyncRequested(false)
+    , nextSlot(0) {
+    // Both are used by the sync thread and must outlive it
+    ConnectionPool::getInstance();
+    RequestScheduler::getInstance();
+
+    const Config& config = Config::getInstance();
+    url = config.getSetting("base_url") + "/api/v3/time";
+    recvWindow = std::stoll(config.getSetting("recv_window", "5000"));
+    interval = std::chrono::seconds(std::max(1L, std::stol(config.getSetting("time_sync_interval", "60"))));
+    samplesPerRound = std::max(1, std::stoi(config.getSetting("time_sync_samples", "4")));
+
+    worker = std::thread(&ClockSync::syncLoop, this);
+}
+
+ClockSync::~ClockSync() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_one();
+    worker.join();
+}
+
+int64_t ClockSync::exchangeTimeMs() {
+    int64_t now;
+    if (synced.load(std::memory_order_acquire)) {
+        now = (microsSinceEpoch(std::chrono::steady_clock::now()) + steadyToExchangeUs.load(std::memory_order_relaxed)) / 1000;
+    } else {
+        now = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+    }
+
+    // A new estimate may be a little behind the old one; hold the last
+    // timestamp instead of going back. A bigger step down corrects stamps
+    // that ran ahead (the local clock before the first sample, or an
+    // estimate a resync lowered), and holding those would keep requests
+    // stamped in the exchange's future
+    int64_t last = lastIssuedMs.load(std::memory_order_relaxed);
+    while (true) {
+        if (now <= last && last - now <= MAX_HOLD_MS) return last;
+        if (lastIssuedMs.compare_exchange_weak(last, now, std::memory_order_relaxed)) return now;
+    }
+}
+
+bool ClockSync::waitForSync(std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> lock(mutex);
+    return firstSync.wait_for(lock, timeout, [this] { return synced.load(); });
+}
+
+void ClockSync::requestSync() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        resyncRequested = true;
+        stats.resyncs++;
+    }
+    wake.notify_one();
+}
+
+ClockSync::Stats ClockSync::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return stats;
+}
+
+size_t ClockSync::writeCallback(void* contents, size_t size, size_t nmemb, void* userp) {
+    static_cast<std::string*>(userp)->append(static_cast<char*>(contents), size * nmemb);
+    return size * nmemb;
+}
+
+void ClockSync::syncLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (!stopping) {
+        for (int i = 0; i < samplesPerRound && !stopping; i++) {
+            lock.unlock();
+            Sample sample;
+            bool ok = takeSample(sample);
+            lock.lock();
+
+            if (!ok) {
+                stats.failures++;
+                continue;
+            }
+            stats.samples++;
+            if (recent.size() < RECENT_SAMPLES) recent.push_back(sample);
+            else recent[nextSlot] = sample;
+            nextSlot = (nextSlot + 1) % RECENT_SAMPLES;
+        }
+        applyBestSample();
+
+        wake.wait_for(lock, interval, [this] { return stopping || resyncRequested; });
+        resyncRequested = false;
+    }
+}
+
+// One /api/v3/time round trip, timed by curl
+bool ClockSync::takeSample(Sample& sample) {
+    RequestScheduler& scheduler = RequestScheduler::getInstance();
+    scheduler.acquire(requestCost("GET", "/api/v3/time"));
+
+    ConnectionPool::Handle handle = ConnectionPool::getInstance().acquire();
+    if (!handle) return false;
+    CURL* curl = handle.get();
+
+    std::string body;
+    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+    curl_easy_setopt(curl, CURLOPT_HTTPGET, 1L);
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, writeCallback);
+    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &body);
+
+    std::chrono::system_clock::time_point systemStart = std::chrono::system_clock::now();
+    std::chrono::steady_clock::time_point steadyStart = std::chrono::steady_clock::now();
+    CURLcode result = curl_easy_perform(curl);
+
+    long status = 0;
+    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &status);
+    if (result != CURLE_OK) {
+        LOG_ERROR("Time sync failed: ", curl_easy_strerror(result));
+        return false;
+    }
+    scheduler.observe(curl, status);
+
+    ServerTime serverTime;
+    if (status != 200 || !decodeServerTime(body, serverTime)) {
+        LOG_ERROR("Time sync failed: HTTP ", status, " ", body);
+        return false;
+    }
+
+    // The exchange read its clock between sending the request and the first
+    // response byte; take the midpoint, and the middle of the truncated ms
+    curl_off_t requestSent = 0;
+    curl_off_t firstByte = 0;
+    curl_easy_getinfo(curl, CURLINFO_PRETRANSFER_TIME_T, &requestSent);
+    curl_easy_getinfo(curl, CURLINFO_STARTTRANSFER_TIME_T, &firstByte);
+    int64_t midpointUs = (requestSent + firstByte) / 2;
+    int64_t exchangeUs = serverTime.serverTime * 1000 + 500;
+
+    sample.rttUs = firstByte - requestSent;
+    sample.offsetUs = exchangeUs - (microsSinceEpoch(systemStart) + midpointUs);
+    sample.steadyToExchangeUs = exchangeUs - (microsSinceEpoch(steadyStart) + midpointUs);
+    return true;
+}
+
+// Called locked
+void ClockSync::applyBestSample() {
+    if (recent.empty()) return;
+    const Sample& best = *std::min_element(recent.begin(), recent.end(),
+        [](const Sample& a, const Sample& b) { return a.rttUs < b.rttUs; });
+
+    bool first = !synced.load();
+    steadyToExchangeUs.store(best.steadyToExchangeUs, std::memory_order_relaxed);
+    synced.store(true, std::memory_order_release);
+    stats.synced = true;
+    stats.offsetMs = best.offsetUs / 1000.0;
+    stats.rttMs = best.rttUs / 1000.0;
+
+    if (first) {
+        LOG_INFO("Exchange clock offset: ", stats.offsetMs, " ms (round trip ", stats.rttMs, " ms)");
+        firstSync.notify_all();
+    }
+}
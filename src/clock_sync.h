@@ -0,0 +1,96 @@
+// clock_sync.h
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Estimate of the exchange clock for signed request timestamps. A background
+// thread samples /api/v3/time in rounds; each sample is timed from curl's
+// pre-transfer to first-byte times, so DNS, TCP and TLS setup do not count,
+// and the sample with the shortest round trip out of the recent ones is used
+// (its offset error is at most half that round trip). Timestamps are the
+// steady clock plus that offset, so a jump of the local wall clock does not
+// move them, and a new estimate a little behind the old one does not take
+// them backwards (one more than MAX_HOLD_MS behind does).
+//
+// Settings (config.json, all optional):
+//   recv_window          ms a signed request stays valid at the exchange
+//                        (default 5000, 0 leaves it to the exchange)
+//   time_sync_interval   seconds between sync rounds (default 60)
+//   time_sync_samples    samples per round (default 4)
+class ClockSync {
+public:
+    struct Stats {
+        bool synced = false;
+        double offsetMs = 0;      // exchange clock minus local system clock
+        double rttMs = 0;         // round trip of the sample in use
+        uint64_t samples = 0;
+        uint64_t failures = 0;
+        uint64_t resyncs = 0;     // requestSync() calls
+    };
+
+    // Process-wide clock; the sync thread starts on first use
+    static ClockSync& getInstance();
+
+    ClockSync(const ClockSync&) = delete;
+    ClockSync& operator=(const ClockSync&) = delete;
+
+    // Exchange time in ms for a request timestamp; the local clock until
+    // the first sample has arrived
+    int64_t exchangeTimeMs();
+
+    // recv_window, 0 if not sent
+    int64_t recvWindowMs() const { return recvWindow; }
+
+    // Wait up to `timeout` for the first estimate; false if there is none
+    bool waitForSync(std::chrono::milliseconds timeout);
+
+    // Sample again right away, e.g. after the exchange rejected a timestamp
+    void requestSync();
+
+    Stats getStats() const;
+
+private:
+    struct Sample {
+        int64_t rttUs;
+        int64_t offsetUs;             // to the system clock, for reporting
+        int64_t steadyToExchangeUs;   // what exchangeTimeMs() adds to the steady clock
+    };
+
+    ClockSync();
+    ~ClockSync();
+
+    void syncLoop();
+    bool takeSample(Sample& sample);
+    void applyBestSample();
+
+    static size_t writeCallback(void* contents, size_t size, size_t nmemb, void* userp);
+
+    std::string url;
+    int64_t recvWindow;
+    std::chrono::seconds interval;
+    int samplesPerRound;
+
+    std::atomic<bool> synced;
+    std::atomic<int64_t> steadyToExchangeUs;
+    std::atomic<int64_t> lastIssuedMs;
+
+    mutable std::mutex mutex;
+    std::condition_variable wake;          // sync thread
+    std::condition_variable firstSync;     // waitForSync()
+    bool stopping;
+    bool resyncRequested;
+    std::vector<Sample> recent;            // ring of the last RECENT_SAMPLES
+    size_t nextSlot;
+    Stats stats;
+    std::thread worker;
+
+    static constexpr size_t RECENT_SAMPLES = 8;
+    // Longest a timestamp is held to keep them from going backwards
+    static constexpr int64_t MAX_HOLD_MS = 1000;
+};
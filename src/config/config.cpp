@@ -1,6 +1,6 @@
 #include "config.h"
 #include <cstdlib>
-#include <iostream>
+#include "logger.h"
 #include <fstream>
 #include <nlohmann/json.hpp>
 
@@ -49,11 +49,11 @@ void Config::loadEnvironmentVariables() {
     }
     
     // Debug logging
-    std::cout << "Loading environment variables..." << std::endl;
-    std::cout << "API Key found: " << (!api_key.empty() ? "Yes" : "No") << std::endl;
-    std::cout << "API Secret found: " << (!api_secret.empty() ? "Yes" : "No") << std::endl;
+    LOG_INFO("Loading environment variables...");
+    LOG_INFO("API Key found: ", (!api_key.empty() ? "Yes" : "No"));
+    LOG_INFO("API Secret found: ", (!api_secret.empty() ? "Yes" : "No"));
     if (!api_secret.empty()) {
-        std::cout << "Secret length: " << api_secret.length() << std::endl;
+        LOG_INFO("Secret length: ", api_secret.length());
     }
     
     // Load base URL
@@ -63,7 +63,7 @@ void Config::loadEnvironmentVariables() {
     }
     if (!base_url.empty()) {
         settings["base_url"] = base_url;
-        std::cout << "Using base URL from env: " << base_url << std::endl;
+        LOG_INFO("Using base URL from env: ", base_url);
     }
 }
 
@@ -90,7 +90,7 @@ void Config::loadConfigFile() {
             }
         }
     } catch (const std::exception& e) {
-        std::cerr << "Warning: Error reading config file: " << e.what() << std::endl;
+        LOG_WARN("Error reading config file: ", e.what());
     }
 }
 
@@ -107,7 +107,7 @@ Config::Config() {
     }
     
     if (!isValid()) {
-        std::cerr << "Warning: API credentials not found in environment variables or config file" << std::endl;
+        LOG_WARN("API credentials not found in environment variables or config file");
     }
 }
 
@@ -0,0 +1,159 @@
+// connection_pool.cpp
+#include "connection_pool.h"
+#include "logger.h"
+#include "config/config.h"
+
+ConnectionPool::Handle& ConnectionPool::Handle::operator=(Handle&& other) noexcept {
+    if (this != &other) {
+        reset();
+        pool = other.pool;
+        curl = other.curl;
+        other.curl = nullptr;
+    }
+    return *this;
+}
+
+void ConnectionPool::Handle::reset() {
+    if (curl) {
+        pool->release(curl);
+        curl = nullptr;
+    }
+}
+
+ConnectionPool& ConnectionPool::getInstance() {
+    static ConnectionPool instance;
+    return instance;
+}
+
+ConnectionPool::ConnectionPool()
+    : share(nullptr)
+    , created(0) {
+    // Reference counted, so this is harmless if main() already did it
+    curl_global_init(CURL_GLOBAL_DEFAULT);
+
+    const Config& config = Config::getInstance();
+    httpVersion = config.getSetting("http_version", "1.1") == "2"
+        ? CURL_HTTP_VERSION_2TLS : CURL_HTTP_VERSION_1_1;
+    timeout = std::stol(config.getSetting("timeout", "30"));
+    connectTimeout = std::stol(config.getSetting("connect_timeout", "10"));
+    maxIdle = std::stoul(config.getSetting("max_idle_connections", "8"));
+    caBundle = config.getSetting("ca_bundle");
+    logCurl = config.getSetting("log_curl", "false") == "true";
+
+    share = curl_share_init();
+    if (share) {
+        curl_share_setopt(share, CURLSHOPT_LOCKFUNC, lockShared);
+        curl_share_setopt(share, CURLSHOPT_UNLOCKFUNC, unlockShared);
+        curl_share_setopt(share, CURLSHOPT_USERDATA, this);
+        curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+        curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+    } else {
+        LOG_WARN("Failed to create curl share handle; DNS and TLS sessions won't be shared");
+    }
+}
+
+ConnectionPool::~ConnectionPool() {
+    for (CURL* curl : idle) {
+        curl_easy_cleanup(curl);
+    }
+    if (share) curl_share_cleanup(share);
+}
+
+void ConnectionPool::lockShared(CURL*, curl_lock_data data, curl_lock_access, void* userptr) {
+    static_cast<ConnectionPool*>(userptr)->shareLocks[data].lock();
+}
+
+void ConnectionPool::unlockShared(CURL*, curl_lock_data data, void* userptr) {
+    static_cast<ConnectionPool*>(userptr)->shareLocks[data].unlock();
+}
+
+// CURLOPT_VERBOSE output, one debug record per line; bodies are left out
+int ConnectionPool::trace(CURL*, curl_infotype type, char* data, size_t size, void*) {
+    const char* prefix;
+    if (type == CURLINFO_TEXT) prefix = "* ";
+    else if (type == CURLINFO_HEADER_IN) prefix = "< ";
+    else if (type == CURLINFO_HEADER_OUT) prefix = "> ";
+    else return 0;
+
+    std::string_view text(data, size);
+    while (!text.empty()) {
+        size_t end = text.find('\n');
+        std::string_view line = text.substr(0, end);
+        if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+        if (line.rfind("X-MBX-APIKEY:", 0) == 0) line = "X-MBX-APIKEY: (hidden)";
+        if (!line.empty()) LOG_DEBUG("curl ", prefix, line);
+        if (end == std::string_view::npos) break;
+        text.remove_prefix(end + 1);
+    }
+    return 0;
+}
+
+ConnectionPool::Handle ConnectionPool::acquire() {
+    CURL* curl = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!idle.empty()) {
+            curl = idle.back();
+            idle.pop_back();
+        }
+    }
+
+    if (!curl) {
+        curl = curl_easy_init();
+        if (!curl) {
+            LOG_ERROR("Failed to initialize CURL.");
+            return Handle();
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        created++;
+    }
+
+    applyDefaults(curl);
+    return Handle(this, curl);
+}
+
+void ConnectionPool::release(CURL* curl) {
+    // Reset clears the per-request options but keeps the open connection
+    curl_easy_reset(curl);
+
+    std::unique_lock<std::mutex> lock(mutex);
+    if (idle.size() < maxIdle) {
+        idle.push_back(curl);
+        return;
+    }
+    lock.unlock();
+    curl_easy_cleanup(curl);
+}
+
+void ConnectionPool::applyDefaults(CURL* curl) const {
+    if (share) curl_easy_setopt(curl, CURLOPT_SHARE, share);
+    curl_easy_setopt(curl, CURLOPT_HTTP_VERSION, httpVersion);
+    curl_easy_setopt(curl, CURLOPT_TIMEOUT, timeout);
+    curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT, connectTimeout);
+    curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);  // signals and threads don't mix
+
+    // Keep idle connections open between polls
+    curl_easy_setopt(curl, CURLOPT_TCP_KEEPALIVE, 1L);
+    curl_easy_setopt(curl, CURLOPT_TCP_KEEPIDLE, 30L);
+    curl_easy_setopt(curl, CURLOPT_TCP_KEEPINTVL, 15L);
+    curl_easy_setopt(curl, CURLOPT_TCP_NODELAY, 1L);
+
+    curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, 1L);
+    curl_easy_setopt(curl, CURLOPT_SSL_VERIFYHOST, 2L);
+    if (!caBundle.empty()) curl_easy_setopt(curl, CURLOPT_CAINFO, caBundle.c_str());
+
+    if (logCurl) {
+        curl_easy_setopt(curl, CURLOPT_DEBUGFUNCTION, trace);
+        curl_easy_setopt(curl, CURLOPT_VERBOSE, 1L);
+    }
+}
+
+size_t ConnectionPool::idleHandles() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return idle.size();
+}
+
+size_t ConnectionPool::createdHandles() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return created;
+}
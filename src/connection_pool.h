@@ -0,0 +1,85 @@
+// connection_pool.h
+#pragma once
+#include <curl/curl.h>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Process-wide pool of long-lived curl easy handles.
+//
+// A handle returned to the pool is reset but not closed, so the keep-alive
+// connection it holds is reused by the next request to the same host instead
+// of paying for DNS, TCP and TLS setup again. All handles also share one DNS
+// cache and TLS session cache, so even a handle opening a new connection can
+// resume an existing TLS session. Connection caches stay per handle: libcurl
+// does not support sharing live connections between concurrent threads.
+//
+// Settings (config.json, all optional):
+//   http_version          "1.1" (default) or "2" (HTTP/2 over TLS, falls back to 1.1)
+//   timeout               total request timeout in seconds (default 30)
+//   connect_timeout       connect timeout in seconds (default 10)
+//   max_idle_connections  handles kept for reuse (default 8)
+//   ca_bundle             CA file to verify the server with instead of the system one
+//   log_curl              "true" logs curl's connection and header trace at
+//                         debug level (needs log_level "debug")
+class ConnectionPool {
+public:
+    // Exclusive lease of one easy handle; goes back to the pool when destroyed
+    class Handle {
+    public:
+        Handle() : pool(nullptr), curl(nullptr) {}
+        Handle(ConnectionPool* pool, CURL* curl) : pool(pool), curl(curl) {}
+        ~Handle() { reset(); }
+
+        Handle(Handle&& other) noexcept : pool(other.pool), curl(other.curl) { other.curl = nullptr; }
+        Handle& operator=(Handle&& other) noexcept;
+        Handle(const Handle&) = delete;
+        Handle& operator=(const Handle&) = delete;
+
+        CURL* get() const { return curl; }
+        explicit operator bool() const { return curl != nullptr; }
+        void reset();
+
+    private:
+        ConnectionPool* pool;
+        CURL* curl;
+    };
+
+    static ConnectionPool& getInstance();
+
+    ConnectionPool(const ConnectionPool&) = delete;
+    ConnectionPool& operator=(const ConnectionPool&) = delete;
+
+    // Borrow a handle with the pool defaults applied (HTTP version, keep-alive,
+    // timeouts, TLS verification, shared caches). Thread-safe; creates a new
+    // handle when every pooled one is in use. Empty on failure.
+    Handle acquire();
+
+    size_t idleHandles() const;
+    size_t createdHandles() const;
+
+private:
+    ConnectionPool();
+    ~ConnectionPool();
+
+    void release(CURL* curl);
+    void applyDefaults(CURL* curl) const;
+
+    static void lockShared(CURL* curl, curl_lock_data data, curl_lock_access access, void* userptr);
+    static void unlockShared(CURL* curl, curl_lock_data data, void* userptr);
+    static int trace(CURL* curl, curl_infotype type, char* data, size_t size, void* userptr);
+
+    CURLSH* share;
+    std::mutex shareLocks[CURL_LOCK_DATA_LAST];
+
+    mutable std::mutex mutex;
+    std::vector<CURL*> idle;
+    size_t created;
+
+    long httpVersion;
+    long timeout;
+    long connectTimeout;
+    size_t maxIdle;
+    std::string caBundle;
+    bool logCurl;
+};
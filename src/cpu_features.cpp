@@ -0,0 +1,36 @@
+// cpu_features.cpp
+#include "cpu_features.h"
+#include <algorithm>
+#include <atomic>
+
+static std::atomic<SimdLevel> simdLevelCap{SimdLevel::AVX512};
+
+SimdLevel detectedSimdLevel() {
+#if defined(__x86_64__) || defined(__i386__)
+    static const SimdLevel level =
+        __builtin_cpu_supports("avx512f") ? SimdLevel::AVX512 :
+        __builtin_cpu_supports("avx2") ? SimdLevel::AVX2 :
+        __builtin_cpu_supports("sse2") ? SimdLevel::SSE2 :
+        SimdLevel::Scalar;
+    return level;
+#else
+    return SimdLevel::Scalar;
+#endif
+}
+
+SimdLevel simdLevel() {
+    return std::min(detectedSimdLevel(), simdLevelCap.load(std::memory_order_relaxed));
+}
+
+void limitSimdLevel(SimdLevel level) {
+    simdLevelCap.store(level, std::memory_order_relaxed);
+}
+
+const char* simdLevelName(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::SSE2: return "sse2";
+        case SimdLevel::AVX2: return "avx2";
+        case SimdLevel::AVX512: return "avx512";
+        default: return "scalar";
+    }
+}
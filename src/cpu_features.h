@@ -0,0 +1,16 @@
+// cpu_features.h
+#pragma once
+
+// Instruction sets the SIMD kernels can dispatch to, in increasing order
+enum class SimdLevel { Scalar, SSE2, AVX2, AVX512 };
+
+// Best level this CPU supports (always Scalar off x86)
+SimdLevel detectedSimdLevel();
+
+// Level the kernels use: the detected level, lowered by limitSimdLevel()
+SimdLevel simdLevel();
+
+// Cap the kernels at `level`, e.g. to benchmark the narrower paths
+void limitSimdLevel(SimdLevel level);
+
+const char* simdLevelName(SimdLevel level);
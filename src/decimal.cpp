@@ -0,0 +1,100 @@
+// decimal.cpp
+#include "decimal.h"
+#include <charconv>
+#include <limits>
+
+static constexpr uint64_t POW10[Decimal::DECIMALS + 1] = {
+    1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000
+};
+
+static bool isDigit(char c) {
+    return static_cast<unsigned char>(c - '0') < 10;
+}
+
+bool Decimal::parse(std::string_view text, Decimal& out) {
+    const char* pos = text.data();
+    const char* end = pos + text.size();
+    bool negative = pos != end && *pos == '-';
+    if (negative) pos++;
+
+    // At most 11 integer digits fit; more are either leading zeros or too many
+    uint64_t integer = 0;
+    const char* digits = pos;
+    while (pos != end && isDigit(*pos)) {
+        integer = integer * 10 + (*pos - '0');
+        if (integer > static_cast<uint64_t>(std::numeric_limits<int64_t>::max() / SCALE)) return false;
+        pos++;
+    }
+    bool haveDigits = pos != digits;
+
+    uint64_t fraction = 0;
+    int places = 0;
+    if (pos != end && *pos == '.') {
+        pos++;
+        const char* start = pos;
+        while (pos != end && isDigit(*pos)) {
+            if (places < DECIMALS) {
+                fraction = fraction * 10 + (*pos - '0');
+                places++;
+            } else if (*pos != '0') {
+                return false;
+            }
+            pos++;
+        }
+        if (pos == start) return false;
+        haveDigits = true;
+    }
+    if (pos != end || !haveDigits) return false;
+
+    uint64_t units = integer * SCALE + fraction * POW10[DECIMALS - places];
+    if (units > static_cast<uint64_t>(std::numeric_limits<int64_t>::max())) return false;
+    out.value = negative ? -static_cast<int64_t>(units) : static_cast<int64_t>(units);
+    return true;
+}
+
+char* Decimal::format(char* first, char* last, int decimals) const {
+    if (decimals < 0) decimals = 0;
+    if (decimals > DECIMALS) decimals = DECIMALS;
+    uint64_t magnitude = value < 0 ? 0 - static_cast<uint64_t>(value) : static_cast<uint64_t>(value);
+    uint64_t integer = magnitude / SCALE;
+    uint64_t fraction = magnitude % SCALE / POW10[DECIMALS - decimals];
+
+    // No "-0.00" for a value cut to zero
+    if (value < 0 && (integer != 0 || fraction != 0)) {
+        if (first == last) return nullptr;
+        *first++ = '-';
+    }
+    std::to_chars_result result = std::to_chars(first, last, integer);
+    if (result.ec != std::errc()) return nullptr;
+    first = result.ptr;
+    if (decimals == 0) return first;
+
+    if (last - first < decimals + 1) return nullptr;
+    *first++ = '.';
+    for (int i = decimals - 1; i >= 0; i--) {
+        first[i] = static_cast<char>('0' + fraction % 10);
+        fraction /= 10;
+    }
+    return first + decimals;
+}
+
+Decimal::Text Decimal::text() const {
+    Text out;
+    char* end = format(out.data, out.data + MAX_CHARS);
+    // Drop trailing zeros, and the point if nothing is left after it
+    while (end[-1] == '0') end--;
+    if (end[-1] == '.') end--;
+    out.size = end - out.data;
+    return out;
+}
+
+int Decimal::decimalsOf(Decimal step) {
+    int64_t units = step.value < 0 ? -step.value : step.value;
+    if (units == 0) return DECIMALS;
+    int decimals = DECIMALS;
+    while (decimals > 0 && units % 10 == 0) {
+        units /= 10;
+        decimals--;
+    }
+    return decimals;
+}
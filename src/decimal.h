@@ -0,0 +1,96 @@
+// decimal.h
+#pragma once
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// Exact decimal for prices, quantities and amounts: a signed 64-bit count of
+// 1e-8, the finest unit the exchange uses, so everything it sends or accepts
+// is held exactly (up to about 92 billion). A symbol's own scale, the
+// decimals of its tick and step size, comes in when rounding to them and
+// formatting. Sums and differences are exact; a product is rounded to the
+// nearest unit.
+//
+// parse() and format() work on the digits directly, without locale or
+// stream state, and never allocate.
+class Decimal {
+public:
+    static constexpr int DECIMALS = 8;
+    static constexpr int64_t SCALE = 100000000;
+    static constexpr size_t MAX_CHARS = 24;   // "-92233720368.54775807"
+
+    // Shortest text of a value, e.g. for log lines; converts to string_view
+    struct Text {
+        char data[MAX_CHARS];
+        size_t size;
+        operator std::string_view() const { return std::string_view(data, size); }
+    };
+
+    constexpr Decimal() = default;
+    static constexpr Decimal fromUnits(int64_t units) {
+        Decimal result;
+        result.value = units;
+        return result;
+    }
+    static constexpr Decimal fromInteger(int64_t integer) { return fromUnits(integer * SCALE); }
+    // Nearest to `value`, which must be finite and in range
+    static Decimal fromDouble(double value) { return fromUnits(std::llround(value * SCALE)); }
+
+    constexpr int64_t units() const { return value; }
+    double toDouble() const { return static_cast<double>(value) / SCALE; }
+    constexpr bool isZero() const { return value == 0; }
+
+    // "46402.40", "-0.001", "42"; false for anything else, for digits past
+    // the eighth decimal that are not zero and for values out of range
+    static bool parse(std::string_view text, Decimal& out);
+
+    // Fixed-point text with `decimals` (0 to 8) places into [first, last),
+    // digits past them cut off; the end of the text, or nullptr if it does
+    // not fit
+    char* format(char* first, char* last, int decimals = DECIMALS) const;
+
+    Text text() const;
+    std::string toString() const { return std::string(std::string_view(text())); }
+
+    // To a multiple of `step`: down and up are toward negative and positive
+    // infinity. A step of zero or less (a filter that is not set) leaves the
+    // value as it is.
+    Decimal roundDown(Decimal step) const {
+        if (step.value <= 0) return *this;
+        int64_t remainder = value % step.value;
+        return fromUnits(value - remainder - (remainder < 0 ? step.value : 0));
+    }
+    Decimal roundUp(Decimal step) const {
+        if (step.value <= 0) return *this;
+        int64_t remainder = value % step.value;
+        return fromUnits(value - remainder + (remainder > 0 ? step.value : 0));
+    }
+
+    // Decimals a step needs: 0.01 -> 2, 5 -> 0; 8 for zero
+    static int decimalsOf(Decimal step);
+
+    constexpr Decimal operator-() const { return fromUnits(-value); }
+    constexpr Decimal operator+(Decimal other) const { return fromUnits(value + other.value); }
+    constexpr Decimal operator-(Decimal other) const { return fromUnits(value - other.value); }
+    Decimal& operator+=(Decimal other) { value += other.value; return *this; }
+    Decimal& operator-=(Decimal other) { value -= other.value; return *this; }
+    Decimal operator*(Decimal other) const {
+        // Half away from zero
+        __int128 product = static_cast<__int128>(value) * other.value;
+        product += product < 0 ? -SCALE / 2 : SCALE / 2;
+        return fromUnits(static_cast<int64_t>(product / SCALE));
+    }
+    constexpr Decimal operator*(int64_t factor) const { return fromUnits(value * factor); }
+
+    constexpr bool operator==(Decimal other) const { return value == other.value; }
+    constexpr bool operator!=(Decimal other) const { return value != other.value; }
+    constexpr bool operator<(Decimal other) const { return value < other.value; }
+    constexpr bool operator<=(Decimal other) const { return value <= other.value; }
+    constexpr bool operator>(Decimal other) const { return value > other.value; }
+    constexpr bool operator>=(Decimal other) const { return value >= other.value; }
+
+private:
+    int64_t value = 0;
+};
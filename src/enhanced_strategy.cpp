@@ -1,6 +1,7 @@
 // enhanced_strategy.cpp
 #include "enhanced_strategy.h"
-#include <iostream>
+#include "window_kernels.h"
+#include "logger.h"
 #include <numeric>
 #include <algorithm>
 #include <cmath>
@@ -13,18 +14,49 @@ EnhancedTradingStrategy::EnhancedTradingStrategy(BinanceAPI& api, OrderManager&
     , orderManager(orderManager)
     , symbol(symbol)
     , running(false)
+    , marketData(nullptr)
+    , priceHistory(MAX_HISTORY)
+    , volumeHistory(MAX_HISTORY)
     , fastEMA(fastEMA)
     , slowEMA(slowEMA)
     , signalEMA(signalEMA)
     , rsiPeriod(rsiPeriod)
     , rsiOverbought(rsiOverbought)
-    , rsiOversold(rsiOversold) {}
+    , rsiOversold(rsiOversold)
+    , ema8(8)
+    , ema20(20)
+    , ema21(21)
+    , ema50(50)
+    , macd(fastEMA, slowEMA, signalEMA)
+    , rsi14(14)
+    , rsi(rsiPeriod)
+    , atr14(14)
+    , volume3(3)
+    , volume10(10)
+    , cacheAttached(false)
+    , cached()
+    , snapshot()
+    , snapshotValid(false) {}
 
 void EnhancedTradingStrategy::run() {
     running = true;
     while (running) {
-        // Real-time implementation details would go here
-        std::this_thread::sleep_for(std::chrono::seconds(1));
+        if (!marketData) {
+            std::this_thread::sleep_for(std::chrono::seconds(1));
+            continue;
+        }
+
+        MarketEvent event;
+        if (!marketData->pop(event, std::chrono::milliseconds(1000))) continue;
+        if (!event.isUpdate() || event.symbol != symbol) continue;
+
+        updateMarketData(event.price, event.volume);
+        bool enter = shouldEnterLong();
+        bool exit = shouldExitLong();
+        marketData->recordSignal(event);
+        if (enter || exit) {
+            LOG_INFO(symbol, " ", (enter ? "enter" : "exit"), " signal at ", event.price);
+        }
     }
 }
 
@@ -33,159 +65,179 @@ void EnhancedTradingStrategy::stop() {
 }
 
 void EnhancedTradingStrategy::updateMarketData(double price, double volume) {
+    // Ring buffers drop the oldest value once MAX_HISTORY is reached
     priceHistory.push_back(price);
     volumeHistory.push_back(volume);
-    // Keep a reasonable buffer size to avoid excessive memory usage
-    const size_t MAX_HISTORY = 500;
-    if (priceHistory.size() > MAX_HISTORY) {
-        priceHistory.erase(priceHistory.begin());
-        volumeHistory.erase(volumeHistory.begin());
+
+    if (cacheAttached) {
+        size_t bar = stats.bars;
+        if (bar >= cached.close.size() || cached.close[bar] != price || cached.volume[bar] != volume) {
+            LOG_WARN("Indicator cache out of sync at bar ", bar, ", falling back to streaming indicators");
+            detachIndicatorCache();
+            updateIndicators(price, volume);
+        }
+    } else {
+        updateIndicators(price, volume);
     }
+
+    snapshotValid = false;
+    stats.bars++;
 }
 
-double EnhancedTradingStrategy::calculateSMA(int period) const {
-    if (priceHistory.size() < period) return 0.0;
-    
-    return std::accumulate(
-        priceHistory.end() - period,
-        priceHistory.end(),
-        0.0
-    ) / period;
+void EnhancedTradingStrategy::updateIndicators(double price, double volume) {
+    ema8.update(price);
+    ema20.update(price);
+    ema21.update(price);
+    ema50.update(price);
+    macd.update(price);
+    rsi14.update(price);
+    rsi.update(price);
+    // Simulate high/low from close prices for this example
+    atr14.update(price * (1 + SIMULATED_RANGE), price * (1 - SIMULATED_RANGE), price);
+    volume3.update(volume);
+    volume10.update(volume);
 }
 
-std::vector<double> EnhancedTradingStrategy::calculateEMA(const std::vector<double>& data, int period) const {
-    std::vector<double> ema(data.size());
-    if (data.size() < period) return ema;
-    
-    // Calculate SMA for the first EMA value
-    double sum = 0;
-    for (int i = 0; i < period; i++) {
-        sum += data[i];
-    }
-    ema[period-1] = sum / period;
-    
-    // Calculate multiplier
-    double multiplier = 2.0 / (period + 1);
-    
-    // Calculate EMA for remaining values
-    for (size_t i = period; i < data.size(); i++) {
-        ema[i] = (data[i] - ema[i-1]) * multiplier + ema[i-1];
+bool EnhancedTradingStrategy::useIndicatorCache(IndicatorCache& cache) {
+    if (stats.bars > 0) return false;
+
+    const SourceColumn close = SourceColumn::Close;
+    const SourceColumn volume = SourceColumn::Volume;
+    cached.close = cache.columns().close;
+    cached.volume = cache.columns().volume;
+    cached.ema8 = cache.series({IndicatorKind::EMA, close, 8});
+    cached.ema20 = cache.series({IndicatorKind::EMA, close, 20});
+    cached.ema21 = cache.series({IndicatorKind::EMA, close, 21});
+    cached.ema50 = cache.series({IndicatorKind::EMA, close, 50});
+    cached.macd = cache.series({IndicatorKind::MACD, close, fastEMA, slowEMA, signalEMA});
+    cached.signal = cache.series({IndicatorKind::MACDSignal, close, fastEMA, slowEMA, signalEMA});
+    cached.rsi14 = cache.series({IndicatorKind::RSI, close, 14});
+    cached.rsi = cache.series({IndicatorKind::RSI, close, rsiPeriod});
+    cached.atr14 = cache.series({IndicatorKind::CloseATR, close, 14});
+    cached.volume3 = cache.series({IndicatorKind::RollingSum, volume, 3});
+    cached.volume10 = cache.series({IndicatorKind::RollingSum, volume, 10});
+    cacheAttached = true;
+    return true;
+}
+
+void EnhancedTradingStrategy::detachIndicatorCache() {
+    // Catch the streaming indicators up on the bars that matched the cache
+    for (size_t i = 0; i < stats.bars; i++) {
+        updateIndicators(cached.close[i], cached.volume[i]);
     }
-    
-    return ema;
+    cacheAttached = false;
+    cached = CachedSeries();
 }
 
-double EnhancedTradingStrategy::calculateRSI(int period) const {
-    if (priceHistory.size() <= period) return 50.0; // Neutral if not enough data
-    
-    std::vector<double> gains;
-    std::vector<double> losses;
-    
-    // Calculate price changes
-    for (size_t i = priceHistory.size() - period; i < priceHistory.size(); i++) {
-        if (i == 0) continue;
-        double change = priceHistory[i] - priceHistory[i-1];
-        if (change > 0) {
-            gains.push_back(change);
-            losses.push_back(0);
-        } else {
-            gains.push_back(0);
-            losses.push_back(std::abs(change));
-        }
+const char* EnhancedTradingStrategy::indicatorName(int index) {
+    static const char* const names[INDICATORS] = {
+        "EMA(8)", "EMA(20)", "EMA(21)", "EMA(50)", "MACD", "RSI(14)", "RSI", "ATR(14)", "volume sum(3)",
+        "volume sum(10)"
+    };
+    return index >= 0 && index < INDICATORS ? names[index] : "?";
+}
+
+EnhancedTradingStrategy::IndicatorStats EnhancedTradingStrategy::getIndicatorStats() const {
+    IndicatorStats result = stats;
+    result.fromCache = cacheAttached;
+    const size_t updates[INDICATORS] = {
+        ema8.updates(), ema20.updates(), ema21.updates(), ema50.updates(), macd.updates(),
+        rsi14.updates(), rsi.updates(), atr14.updates(), volume3.updates(), volume10.updates()
+    };
+    for (int i = 0; i < INDICATORS; i++) result.updates[i] = updates[i];
+    return result;
+}
+
+const EnhancedTradingStrategy::IndicatorSnapshot& EnhancedTradingStrategy::getIndicators() const {
+    if (!snapshotValid) {
+        buildSnapshot();
+        snapshotValid = true;
     }
-    
-    // Calculate average gain and loss
-    double avgGain = std::accumulate(gains.begin(), gains.end(), 0.0) / period;
-    double avgLoss = std::accumulate(losses.begin(), losses.end(), 0.0) / period;
-    
-    // Calculate RSI
-    if (avgLoss == 0) return 100.0;
-    double rs = avgGain / avgLoss;
-    return 100.0 - (100.0 / (1.0 + rs));
+    stats.snapshotReads++;
+    return snapshot;
 }
 
-std::pair<std::vector<double>, std::vector<double>> EnhancedTradingStrategy::calculateMACD() const {
-    if (priceHistory.size() < slowEMA) {
-        return std::make_pair(std::vector<double>(), std::vector<double>());
+void EnhancedTradingStrategy::buildSnapshot() const {
+    size_t bars = stats.bars;
+    snapshot.price = getLastPrice();
+
+    if (cacheAttached && bars > 0) {
+        size_t i = bars - 1;
+        snapshot.ema8 = cached.ema8[i];
+        snapshot.ema20 = cached.ema20[i];
+        snapshot.ema21 = cached.ema21[i];
+        snapshot.ema50 = cached.ema50[i];
+        snapshot.macd = cached.macd[i];
+        snapshot.prevMacd = i > 0 ? cached.macd[i - 1] : 0.0;
+        snapshot.signal = cached.signal[i];
+        snapshot.prevSignal = i > 0 ? cached.signal[i - 1] : 0.0;
+        snapshot.rsi14 = cached.rsi14[i];
+        snapshot.rsi = cached.rsi[i];
+        snapshot.atr = cached.atr14[i];
+        snapshot.volumeSum3 = cached.volume3[i];
+        snapshot.volumeSum10 = cached.volume10[i];
+    } else {
+        snapshot.ema8 = ema8.value();
+        snapshot.ema20 = ema20.value();
+        snapshot.ema21 = ema21.value();
+        snapshot.ema50 = ema50.value();
+        snapshot.macd = macd.macd();
+        snapshot.prevMacd = macd.prevMacd();
+        snapshot.signal = macd.signal();
+        snapshot.prevSignal = macd.prevSignal();
+        snapshot.rsi14 = rsi14.value();
+        snapshot.rsi = rsi.value();
+        snapshot.atr = atr14.value();
+        snapshot.volumeSum3 = volume3.sum();
+        snapshot.volumeSum10 = volume10.sum();
     }
-    
-    // Calculate fast and slow EMAs
-    std::vector<double> fastEMAValues = calculateEMA(priceHistory, fastEMA);
-    std::vector<double> slowEMAValues = calculateEMA(priceHistory, slowEMA);
-    
-    // Calculate MACD line (fast EMA - slow EMA)
-    std::vector<double> macdLine(priceHistory.size());
-    for (size_t i = 0; i < priceHistory.size(); i++) {
-        if (i < slowEMA - 1) {
-            macdLine[i] = 0;
-        } else {
-            macdLine[i] = fastEMAValues[i] - slowEMAValues[i];
-        }
+    snapshot.macdReady = bars >= static_cast<size_t>(slowEMA) && bars > 2;
+
+    snapshot.volumeAboveAverage = volumeHistory.size() > 10 &&
+                                  volumeHistory.back() > snapshot.volumeSum10 / 10;
+    snapshot.volumeIncreasing = isVolumeIncreasing();
+
+    // Price action: Check for higher lows
+    snapshot.higherLows = false;
+    if (priceHistory.size() > 4) {
+        double min1 = *std::min_element(priceHistory.end() - 2, priceHistory.end());
+        double min2 = *std::min_element(priceHistory.end() - 4, priceHistory.end() - 2);
+        snapshot.higherLows = min1 > min2;
     }
-    
-    // Calculate signal line (EMA of MACD line)
-    std::vector<double> signalLine = calculateEMA(macdLine, signalEMA);
-    
-    return std::make_pair(macdLine, signalLine);
+
+    snapshot.volatilityHigh = isVolatilityHigh();
+    snapshot.trend = detectTrend();
+
+    stats.snapshotBuilds++;
 }
 
-double EnhancedTradingStrategy::calculateATR(int period) const {
+double EnhancedTradingStrategy::calculateSMA(int period) const {
     if (priceHistory.size() < period) return 0.0;
     
-    // Simulate high/low from close prices for this example
-    std::vector<double> trueRanges;
-    double prevClose = priceHistory[priceHistory.size() - period - 1];
-    
-    for (size_t i = priceHistory.size() - period; i < priceHistory.size(); i++) {
-        double high = priceHistory[i] * 1.002; // Simulated high
-        double low = priceHistory[i] * 0.998;  // Simulated low
-        double close = priceHistory[i];
-        
-        // True Range calculation
-        double tr1 = high - low;
-        double tr2 = std::abs(high - prevClose);
-        double tr3 = std::abs(low - prevClose);
-        double tr = std::max({tr1, tr2, tr3});
-        
-        trueRanges.push_back(tr);
-        prevClose = close;
-    }
-    
-    // Calculate ATR as average of true ranges
-    return std::accumulate(trueRanges.begin(), trueRanges.end(), 0.0) / period;
+    return windowMean(priceHistory.last(period).data(), period);
 }
 
 bool EnhancedTradingStrategy::isVolumeIncreasing() const {
     if (volumeHistory.size() < 10) return false;
     
-    double recentVolume = std::accumulate(
-        volumeHistory.end() - 3,
-        volumeHistory.end(),
-        0.0
-    ) / 3;
-    
-    double prevVolume = std::accumulate(
-        volumeHistory.end() - 10,
-        volumeHistory.end() - 3,
-        0.0
-    ) / 7;
+    double recentVolume = snapshot.volumeSum3 / 3;
+    double prevVolume = (snapshot.volumeSum10 - snapshot.volumeSum3) / 7;
     
     return recentVolume > prevVolume * 1.2; // 20% volume increase
 }
 
-bool EnhancedTradingStrategy::isPriceAboveEMA(int period) const {
-    if (priceHistory.size() < period) return false;
+bool EnhancedTradingStrategy::isPriceAboveEMA(double ema, int period) const {
+    if (stats.bars < static_cast<uint64_t>(period)) return false;
     
-    std::vector<double> ema = calculateEMA(priceHistory, period);
-    return priceHistory.back() > ema.back();
+    return priceHistory.back() > ema;
 }
 
 EnhancedTradingStrategy::TrendDirection EnhancedTradingStrategy::detectTrend() const {
     if (priceHistory.size() < 50) return SIDEWAYS;
     
     // Check if price is above key moving averages
-    bool aboveEMA20 = isPriceAboveEMA(20);
-    bool aboveEMA50 = isPriceAboveEMA(50);
+    bool aboveEMA20 = isPriceAboveEMA(snapshot.ema20, 20);
+    bool aboveEMA50 = isPriceAboveEMA(snapshot.ema50, 50);
     
     // Check recent price movement
     double priceChange = (priceHistory.back() - priceHistory[priceHistory.size() - 20]) / 
@@ -201,7 +253,9 @@ EnhancedTradingStrategy::TrendDirection EnhancedTradingStrategy::detectTrend() c
 }
 
 bool EnhancedTradingStrategy::isVolatilityHigh() const {
-    double atr = calculateATR();
+    if (priceHistory.empty()) return false;
+    
+    double atr = snapshot.atr;
     double currentPrice = priceHistory.back();
     
     // If ATR is more than 2% of current price, consider volatility high
@@ -212,17 +266,10 @@ bool EnhancedTradingStrategy::isVolatilityHigh() const {
 bool EnhancedTradingStrategy::isSupportLevel(double price) const {
     if (priceHistory.size() < 20) return false;
     
-    int touchCount = 0;
     double threshold = price * 0.005; // 0.5% threshold
     
-    for (size_t i = priceHistory.size() - 20; i < priceHistory.size(); i++) {
-        if (std::abs(priceHistory[i] - price) < threshold) {
-            touchCount++;
-            if (touchCount >= 3) return true;
-        }
-    }
-    
-    return false;
+    // Touches within the threshold over the last 20 bars
+    return countWithin(priceHistory.last(20).data(), 20, price, threshold) >= 3;
 }
 
 bool EnhancedTradingStrategy::isResistanceLevel(double price) const {
@@ -238,54 +285,26 @@ double EnhancedTradingStrategy::getLastPrice() const {
 bool EnhancedTradingStrategy::shouldEnterLong() const {
     if (priceHistory.size() < slowEMA + 20) return false;
     
-    double currentPrice = priceHistory.back();
-    
-    // Calculate EMAs
-    double ema8 = calculateEMA(priceHistory, 8).back();
-    double ema21 = calculateEMA(priceHistory, 21).back();
-    double ema50 = calculateEMA(priceHistory, 50).back();
+    const IndicatorSnapshot& ind = getIndicators();
+    double currentPrice = ind.price;
     
     // Trend alignment
-    bool strongTrend = ema8 > ema21 && ema21 > ema50;
-    bool priceAboveEMAs = currentPrice > ema8 && currentPrice > ema21;
+    bool strongTrend = ind.ema8 > ind.ema21 && ind.ema21 > ind.ema50;
+    bool priceAboveEMAs = currentPrice > ind.ema8 && currentPrice > ind.ema21;
     
     // RSI for momentum
-    double rsi = calculateRSI(14);
-    bool rsiGood = rsi > 40 && rsi < 65; // More conservative RSI range
+    bool rsiGood = ind.rsi14 > 40 && ind.rsi14 < 65; // More conservative RSI range
     
     // MACD for trend confirmation
-    auto macdData = calculateMACD();
-    std::vector<double>& macdLine = macdData.first;
-    std::vector<double>& signalLine = macdData.second;
-    
-    bool macdPositive = false;
-    if (macdLine.size() > 2) {
-        macdPositive = macdLine[macdLine.size()-1] > 0 && 
-                      macdLine[macdLine.size()-1] > signalLine[signalLine.size()-1];
-    }
-    
-    // Volume confirmation
-    bool volumeGood = false;
-    if (volumeHistory.size() > 10) {
-        double avgVolume = std::accumulate(volumeHistory.end() - 10, volumeHistory.end(), 0.0) / 10;
-        volumeGood = volumeHistory.back() > avgVolume;
-    }
-    
-    // Price action: Check for higher lows
-    bool higherLows = false;
-    if (priceHistory.size() > 4) {
-        double min1 = *std::min_element(priceHistory.end() - 2, priceHistory.end());
-        double min2 = *std::min_element(priceHistory.end() - 4, priceHistory.end() - 2);
-        higherLows = min1 > min2;
-    }
+    bool macdPositive = ind.macdReady && ind.macd > 0 && ind.macd > ind.signal;
     
     // Need at least 3 out of 5 conditions for entry
     int conditions = 0;
     conditions += (strongTrend && priceAboveEMAs) ? 1 : 0;
     conditions += rsiGood ? 1 : 0;
     conditions += macdPositive ? 1 : 0;
-    conditions += volumeGood ? 1 : 0;
-    conditions += higherLows ? 1 : 0;
+    conditions += ind.volumeAboveAverage ? 1 : 0;
+    conditions += ind.higherLows ? 1 : 0;
     
     return conditions >= 3;
 }
@@ -293,68 +312,100 @@ bool EnhancedTradingStrategy::shouldEnterLong() const {
 bool EnhancedTradingStrategy::shouldExitLong() const {
     if (priceHistory.size() < slowEMA + 20) return false;
     
-    double currentPrice = priceHistory.back();
+    const IndicatorSnapshot& ind = getIndicators();
+    double currentPrice = ind.price;
     double entryPrice = getLastPrice();
     
-    // Calculate ATR for dynamic exits
-    double atr = calculateATR(14);
-    double atrMultiplier = 2.0;
-    
     // Dynamic stop loss and take profit based on ATR
-    double stopLossDistance = atr * atrMultiplier;
-    double takeProfitDistance = atr * atrMultiplier * 1.5; // 1.5x the stop loss
+    double atrMultiplier = 2.0;
+    double stopLossDistance = ind.atr * atrMultiplier;
+    double takeProfitDistance = ind.atr * atrMultiplier * 1.5; // 1.5x the stop loss
     
     bool stopLoss = (currentPrice - entryPrice) < -stopLossDistance;
     bool takeProfit = (currentPrice - entryPrice) > takeProfitDistance;
     
     // Trend reversal signals
-    double ema8 = calculateEMA(priceHistory, 8).back();
-    double ema21 = calculateEMA(priceHistory, 21).back();
-    bool trendReversal = currentPrice < ema8 && ema8 < ema21;
+    bool trendReversal = currentPrice < ind.ema8 && ind.ema8 < ind.ema21;
     
     // RSI exit condition
-    double rsi = calculateRSI(14);
-    bool rsiExit = rsi > 70 || rsi < 40;
+    bool rsiExit = ind.rsi14 > 70 || ind.rsi14 < 40;
     
     // MACD reversal
-    auto macdData = calculateMACD();
-    std::vector<double>& macdLine = macdData.first;
-    bool macdReversal = macdLine.size() > 2 && 
-                       macdLine[macdLine.size()-1] < 0 &&
-                       macdLine[macdLine.size()-1] < macdLine[macdLine.size()-2];
+    bool macdReversal = ind.macdReady && ind.macd < 0 && ind.macd < ind.prevMacd;
     
     // Exit if stop loss or take profit hit, or if multiple reversal signals
     return stopLoss || takeProfit || (trendReversal && (rsiExit || macdReversal));
 }
 
+EnhancedTradingStrategy::LongSignals EnhancedTradingStrategy::evaluateLongSignals(IndicatorCache& cache) const {
+    const SourceColumn closeColumn = SourceColumn::Close;
+    const size_t n = cache.size();
+    const double* price = cache.columns().close.data();
+    const double* volume = cache.columns().volume.data();
+    const double* ema8 = cache.series({IndicatorKind::EMA, closeColumn, 8}).data();
+    const double* ema21 = cache.series({IndicatorKind::EMA, closeColumn, 21}).data();
+    const double* ema50 = cache.series({IndicatorKind::EMA, closeColumn, 50}).data();
+    const double* macdLine = cache.series({IndicatorKind::MACD, closeColumn, fastEMA, slowEMA, signalEMA}).data();
+    const double* signalLine = cache.series({IndicatorKind::MACDSignal, closeColumn, fastEMA, slowEMA, signalEMA}).data();
+    const double* rsi14Series = cache.series({IndicatorKind::RSI, closeColumn, 14}).data();
+    const double* atr = cache.series({IndicatorKind::CloseATR, closeColumn, 14}).data();
+    const double* volumeSum10 = cache.series({IndicatorKind::RollingSum, SourceColumn::Volume, 10}).data();
+
+    // Warm-up guards, as bar indices: bar i has i + 1 bars of history
+    // (capped at MAX_HISTORY, so a guard longer than that never passes)
+    size_t warmup = slowEMA + 20;
+    size_t firstSignalBar = warmup > MAX_HISTORY ? n : warmup - 1;
+    size_t firstMacdBar = std::max(slowEMA, 3) - 1;
+
+    // Entry: at least 3 of 5 conditions (see shouldEnterLong)
+    BitColumn trendAligned = greaterThan(ema8, ema21, n) & greaterThan(ema21, ema50, n) &
+                             greaterThan(price, ema8, n) & greaterThan(price, ema21, n);
+    BitColumn rsiGood = greaterThan(rsi14Series, 40.0, n) & lessThan(rsi14Series, 65.0, n);
+    BitColumn macdPositive = greaterThan(macdLine, 0.0, n) & greaterThan(macdLine, signalLine, n);
+    macdPositive.clearBelow(firstMacdBar);
+    BitColumn volumeAboveAverage = greaterThanQuotient(volume, volumeSum10, 10, n);
+    volumeAboveAverage.clearBelow(10);
+    BitColumn risingLows = higherLows(price, n);
+    risingLows.clearBelow(4);
+
+    LongSignals signals;
+    signals.enter = atLeastThreeOfFive(trendAligned, rsiGood, macdPositive, volumeAboveAverage, risingLows);
+    signals.enter.clearBelow(firstSignalBar);
+
+    // Exit (see shouldExitLong). The per-bar rule measures the ATR stop and
+    // target from the current price, so they only fire on a negative ATR.
+    BitColumn stopOrTarget = lessThan(atr, 0.0, n);
+    BitColumn trendReversal = greaterThan(ema8, price, n) & greaterThan(ema21, ema8, n);
+    BitColumn rsiExit = greaterThan(rsi14Series, 70.0, n) | lessThan(rsi14Series, 40.0, n);
+    BitColumn macdReversal = lessThan(macdLine, 0.0, n) & lessThanPrevious(macdLine, n);
+    macdReversal.clearBelow(firstMacdBar);
+
+    signals.exit = stopOrTarget | (trendReversal & (rsiExit | macdReversal));
+    signals.exit.clearBelow(firstSignalBar);
+    return signals;
+}
+
 bool EnhancedTradingStrategy::shouldEnterShort() const {
     if (priceHistory.size() < slowEMA + 10) return false;
     
+    const IndicatorSnapshot& ind = getIndicators();
+    
     // RSI conditions
-    double rsi = calculateRSI(rsiPeriod);
-    bool rsiCondition = rsi < 70 && rsi > 40; // Coming out of overbought but not oversold
-    
-    // MACD conditions
-    auto macdData = calculateMACD();
-    std::vector<double>& macdLine = macdData.first;
-    std::vector<double>& signalLine = macdData.second;
-    
-    bool macdCrossunder = false;
-    if (macdLine.size() > 2 && signalLine.size() > 2) {
-        // Check for MACD crossunder (MACD line crosses below signal line)
-        macdCrossunder = macdLine[macdLine.size()-2] >= signalLine[signalLine.size()-2] &&
-                          macdLine[macdLine.size()-1] < signalLine[signalLine.size()-1];
-    }
+    bool rsiCondition = ind.rsi < 70 && ind.rsi > 40; // Coming out of overbought but not oversold
+    
+    // MACD crossunder (MACD line crosses below signal line)
+    bool macdCrossunder = ind.macdReady &&
+                          ind.prevMacd >= ind.prevSignal &&
+                          ind.macd < ind.signal;
     
     // Trend conditions
-    TrendDirection trend = detectTrend();
-    bool trendCondition = trend == DOWNTREND;
+    bool trendCondition = ind.trend == DOWNTREND;
     
     // Volume confirmation
-    bool volumeCondition = isVolumeIncreasing();
+    bool volumeCondition = ind.volumeIncreasing;
     
     // Volatility filter
-    bool volatilityCondition = !isVolatilityHigh();
+    bool volatilityCondition = !ind.volatilityHigh;
     
     // Combined signal (prioritize trend with confirmation from other indicators)
     bool strongSignal = trendCondition && (macdCrossunder || rsiCondition) && volumeCondition;
@@ -366,29 +417,22 @@ bool EnhancedTradingStrategy::shouldEnterShort() const {
 bool EnhancedTradingStrategy::shouldExitShort() const {
     if (priceHistory.size() < slowEMA + 10) return false;
     
+    const IndicatorSnapshot& ind = getIndicators();
+    
     // RSI conditions
-    double rsi = calculateRSI(rsiPeriod);
-    bool rsiOversold = rsi < rsiOversold;
-    
-    // MACD conditions
-    auto macdData = calculateMACD();
-    std::vector<double>& macdLine = macdData.first;
-    std::vector<double>& signalLine = macdData.second;
-    
-    bool macdCrossover = false;
-    if (macdLine.size() > 2 && signalLine.size() > 2) {
-        // Check for MACD crossover (MACD line crosses above signal line)
-        macdCrossover = macdLine[macdLine.size()-2] <= signalLine[signalLine.size()-2] &&
-                         macdLine[macdLine.size()-1] > signalLine[signalLine.size()-1];
-    }
+    bool rsiIsOversold = ind.rsi < rsiOversold;
+    
+    // MACD crossover (MACD line crosses above signal line)
+    bool macdCrossover = ind.macdReady &&
+                         ind.prevMacd <= ind.prevSignal &&
+                         ind.macd > ind.signal;
     
     // Trend conditions
-    TrendDirection trend = detectTrend();
-    bool trendReversal = trend == UPTREND;
+    bool trendReversal = ind.trend == UPTREND;
     
     // Take profit logic
     double entryPrice = 0.0; // Would track this in real implementation
-    double currentPrice = getLastPrice();
+    double currentPrice = ind.price;
     double profitTarget = 0.03; // 3% profit target
     bool profitTargetReached = (entryPrice > 0) && 
                               ((entryPrice - currentPrice) / entryPrice > profitTarget);
@@ -399,6 +443,6 @@ bool EnhancedTradingStrategy::shouldExitShort() const {
                             ((entryPrice - currentPrice) / entryPrice < stopLossPercent);
     
     // Combined exit signals
-    return rsiOversold || macdCrossover || trendReversal || 
+    return rsiIsOversold || macdCrossover || trendReversal || 
            profitTargetReached || stopLossTriggered;
-}
\ No newline at end of file
+}
@@ -3,11 +3,56 @@
 #include <vector>
 #include <string>
 #include <deque>
+#include <cstdint>
 #include "api.h"
 #include "order_manager.h"
+#include "indicators.h"
+#include "indicator_cache.h"
+#include "series_buffer.h"
+#include "signal_kernels.h"
+#include "market_stream.h"
 
 class EnhancedTradingStrategy {
 public:
+    enum TrendDirection { UPTREND, DOWNTREND, SIDEWAYS };
+
+    // Indicator values for the current bar, shared by all signal generators
+    struct IndicatorSnapshot {
+        double price;
+        double ema8;
+        double ema20;
+        double ema21;
+        double ema50;
+        bool macdReady;
+        double macd;
+        double prevMacd;
+        double signal;
+        double prevSignal;
+        double rsi14;
+        double rsi;     // rsiPeriod
+        double atr;
+        double volumeSum3;
+        double volumeSum10;
+        bool volumeAboveAverage;
+        bool volumeIncreasing;
+        bool higherLows;
+        bool volatilityHigh;
+        TrendDirection trend;
+    };
+
+    // Streaming indicators, in the order of IndicatorStats::updates
+    static constexpr int INDICATORS = 10;
+    static const char* indicatorName(int index);
+
+    // Counters showing how often indicators were evaluated
+    struct IndicatorStats {
+        uint64_t bars = 0;            // updateMarketData() calls
+        uint64_t snapshotBuilds = 0;  // at most one per bar
+        uint64_t snapshotReads = 0;   // one per signal check that got past its warm-up guard
+        bool fromCache = false;       // values read from an IndicatorCache, nothing updated
+        uint64_t updates[INDICATORS] = {};  // update() calls of each indicator, bars when streaming
+    };
+
     EnhancedTradingStrategy(BinanceAPI& api, OrderManager& orderManager,
                           const std::string& symbol, 
                           int fastEMA = 12, 
@@ -17,6 +62,9 @@ public:
                           double rsiOverbought = 70, 
                           double rsiOversold = 30);
 
+    // Feed run() from `stream` instead of idling; events for other symbols are ignored
+    void attachMarketData(MarketDataStream& stream) { marketData = &stream; }
+
     void run();
     void stop();
     void updateMarketData(double price, double volume = 0);
@@ -27,19 +75,41 @@ public:
     bool shouldEnterShort() const;
     bool shouldExitShort() const;
 
+    // Builds the snapshot on first use after each updateMarketData()
+    const IndicatorSnapshot& getIndicators() const;
+    IndicatorStats getIndicatorStats() const;
+
+    // Backtest mode: read indicator values by bar index from series shared
+    // through `cache` instead of updating private streaming indicators. The
+    // strategy must then be fed the cache's bars in order from bar 0; it falls
+    // back to streaming if the data ever diverges. Returns false once data
+    // has already been fed.
+    bool useIndicatorCache(IndicatorCache& cache);
+
+    // Backtest mode: shouldEnterLong()/shouldExitLong() for every bar of the
+    // cache's dataset at once. Bit i is what the per-bar call returns after
+    // bars 0..i have been fed; the strategy's own state is not touched.
+    struct LongSignals {
+        BitColumn enter;
+        BitColumn exit;
+    };
+    LongSignals evaluateLongSignals(IndicatorCache& cache) const;
+
     // For backtesting
-    std::vector<double> getPriceHistory() const { return priceHistory; }
-    std::vector<double> getVolumeHistory() const { return volumeHistory; }
+    SeriesView<double> getPriceHistory() const { return priceHistory.view(); }
+    SeriesView<double> getVolumeHistory() const { return volumeHistory.view(); }
 
 private:
     BinanceAPI& api;
     OrderManager& orderManager;
     std::string symbol;
     bool running;
+    MarketDataStream* marketData;
     
-    // Price data
-    std::vector<double> priceHistory;
-    std::vector<double> volumeHistory;
+    // Price data (keep a reasonable buffer size to avoid excessive memory usage)
+    static constexpr size_t MAX_HISTORY = 500;
+    SeriesBuffer<double> priceHistory;
+    SeriesBuffer<double> volumeHistory;
     
     // Strategy parameters
     int fastEMA;
@@ -49,15 +119,48 @@ private:
     double rsiOverbought;
     double rsiOversold;
     
-    // Technical indicators
-    std::vector<double> calculateEMA(const std::vector<double>& data, int period) const;
-    double calculateRSI(int period) const;
-    std::pair<std::vector<double>, std::vector<double>> calculateMACD() const;
-    double calculateATR(int period = 14) const;
-    bool isPriceAboveEMA(int period) const;
+    // Technical indicators, updated once per bar in updateMarketData()
+    EMAIndicator ema8;
+    EMAIndicator ema20;
+    EMAIndicator ema21;
+    EMAIndicator ema50;
+    MACDIndicator macd;
+    RSIIndicator rsi14;
+    RSIIndicator rsi;
+    ATRIndicator atr14;
+    RollingSum volume3;
+    RollingSum volume10;
+
+    // Precomputed series used instead of the indicators above when attached
+    struct CachedSeries {
+        SeriesView<double> close;
+        SeriesView<double> volume;
+        SeriesView<double> ema8;
+        SeriesView<double> ema20;
+        SeriesView<double> ema21;
+        SeriesView<double> ema50;
+        SeriesView<double> macd;
+        SeriesView<double> signal;
+        SeriesView<double> rsi14;
+        SeriesView<double> rsi;
+        SeriesView<double> atr14;
+        SeriesView<double> volume3;
+        SeriesView<double> volume10;
+    };
+    bool cacheAttached;
+    CachedSeries cached;
+    void updateIndicators(double price, double volume);
+    void detachIndicatorCache();
+
+    mutable IndicatorSnapshot snapshot;
+    mutable bool snapshotValid;
+    mutable IndicatorStats stats;
+    void buildSnapshot() const;
+    
+    // Conditions derived from the raw values already stored in `snapshot`
+    bool isPriceAboveEMA(double ema, int period) const;
     
     // Trend detection
-    enum TrendDirection { UPTREND, DOWNTREND, SIDEWAYS };
     TrendDirection detectTrend() const;
     
     // Volume analysis
@@ -0,0 +1,105 @@
+// hmac_signer.cpp
+#include "hmac_signer.h"
+#include <cstring>
+#include "logger.h"
+#include <memory>
+
+static constexpr size_t BLOCK_SIZE = 64;  // SHA-256 block
+
+// "00".."ff", two characters per byte value
+struct HexTable {
+    char pairs[256][2];
+    HexTable() {
+        const char* digits = "0123456789abcdef";
+        for (int i = 0; i < 256; i++) {
+            pairs[i][0] = digits[i >> 4];
+            pairs[i][1] = digits[i & 0xF];
+        }
+    }
+};
+static const HexTable hexTable;
+
+struct MdContextDeleter {
+    void operator()(EVP_MD_CTX* ctx) const { EVP_MD_CTX_free(ctx); }
+};
+
+// Scratch context reused by every signature made on this thread
+static EVP_MD_CTX* workingContext() {
+    thread_local std::unique_ptr<EVP_MD_CTX, MdContextDeleter> ctx(EVP_MD_CTX_new());
+    return ctx.get();
+}
+
+void hexEncode(const unsigned char* bytes, size_t length, char* out) {
+    for (size_t i = 0; i < length; i++) {
+        std::memcpy(out + 2 * i, hexTable.pairs[bytes[i]], 2);
+    }
+}
+
+HmacSigner::HmacSigner(const std::string& key)
+    : inner(EVP_MD_CTX_new())
+    , outer(EVP_MD_CTX_new())
+    , valid(false) {
+    if (!inner || !outer) {
+        LOG_ERROR("HMAC signer initialization failed!");
+        return;
+    }
+
+    // Keys longer than a block are hashed first (RFC 2104)
+    unsigned char block[BLOCK_SIZE] = {};
+    if (key.size() > BLOCK_SIZE) {
+        unsigned int length = 0;
+        if (!EVP_Digest(key.data(), key.size(), block, &length, EVP_sha256(), nullptr)) {
+            LOG_ERROR("HMAC signer initialization failed!");
+            return;
+        }
+    } else {
+        std::memcpy(block, key.data(), key.size());
+    }
+
+    unsigned char ipad[BLOCK_SIZE];
+    unsigned char opad[BLOCK_SIZE];
+    for (size_t i = 0; i < BLOCK_SIZE; i++) {
+        ipad[i] = block[i] ^ 0x36;
+        opad[i] = block[i] ^ 0x5c;
+    }
+
+    valid = EVP_DigestInit_ex(inner, EVP_sha256(), nullptr) &&
+            EVP_DigestUpdate(inner, ipad, BLOCK_SIZE) &&
+            EVP_DigestInit_ex(outer, EVP_sha256(), nullptr) &&
+            EVP_DigestUpdate(outer, opad, BLOCK_SIZE);
+    if (!valid) {
+        LOG_ERROR("HMAC signer initialization failed!");
+    }
+}
+
+HmacSigner::~HmacSigner() {
+    EVP_MD_CTX_free(inner);
+    EVP_MD_CTX_free(outer);
+}
+
+bool HmacSigner::sign(const char* data, size_t length, char* out) const {
+    EVP_MD_CTX* ctx = workingContext();
+    if (!valid || !ctx) return false;
+
+    unsigned char innerDigest[DIGEST_SIZE];
+    unsigned char digest[DIGEST_SIZE];
+    unsigned int digestLength = 0;
+    if (!EVP_MD_CTX_copy_ex(ctx, inner) ||
+        !EVP_DigestUpdate(ctx, data, length) ||
+        !EVP_DigestFinal_ex(ctx, innerDigest, &digestLength) ||
+        !EVP_MD_CTX_copy_ex(ctx, outer) ||
+        !EVP_DigestUpdate(ctx, innerDigest, DIGEST_SIZE) ||
+        !EVP_DigestFinal_ex(ctx, digest, &digestLength)) {
+        LOG_ERROR("HMAC calculation failed!");
+        return false;
+    }
+
+    hexEncode(digest, DIGEST_SIZE, out);
+    return true;
+}
+
+std::string HmacSigner::sign(const std::string& data) const {
+    char hex[HEX_SIZE];
+    if (!sign(data.data(), data.size(), hex)) return "";
+    return std::string(hex, HEX_SIZE);
+}
@@ -0,0 +1,38 @@
+// hmac_signer.h
+#pragma once
+#include <cstddef>
+#include <string>
+#include <openssl/evp.h>
+
+// HMAC-SHA256 request signer keyed once per secret.
+//
+// The key pads are absorbed into an inner and an outer SHA-256 state at
+// construction; each signature copies those states into a per-thread working
+// context instead of deriving the pads again, and the digest is hex encoded
+// through a lookup table straight into the caller's buffer. sign() is const
+// and safe to call from several threads at once.
+class HmacSigner {
+public:
+    static constexpr size_t DIGEST_SIZE = 32;
+    static constexpr size_t HEX_SIZE = 2 * DIGEST_SIZE;
+
+    explicit HmacSigner(const std::string& key);
+    ~HmacSigner();
+
+    HmacSigner(const HmacSigner&) = delete;
+    HmacSigner& operator=(const HmacSigner&) = delete;
+
+    // Writes HEX_SIZE lowercase hex characters (no terminator) to `out`
+    bool sign(const char* data, size_t length, char* out) const;
+
+    // Convenience form; "" on failure
+    std::string sign(const std::string& data) const;
+
+private:
+    EVP_MD_CTX* inner;  // SHA-256 state after absorbing key ^ ipad
+    EVP_MD_CTX* outer;  // SHA-256 state after absorbing key ^ opad
+    bool valid;
+};
+
+// Lowercase hex of `length` bytes into out[0 .. 2 * length)
+void hexEncode(const unsigned char* bytes, size_t length, char* out);
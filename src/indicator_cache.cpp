@@ -0,0 +1,98 @@
+// indicator_cache.cpp
+#include "indicator_cache.h"
+#include "indicators.h"
+#include "window_kernels.h"
+
+SeriesView<double> IndicatorCache::series(const IndicatorKey& key) {
+    Entry* entry;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto& slot = entries[key];
+        if (!slot) slot = std::make_unique<Entry>();
+        entry = slot.get();
+    }
+
+    // Compute outside the map lock so different series can build in parallel
+    std::call_once(entry->once, [&] {
+        compute(key, entry->values);
+        computed++;
+    });
+    return SeriesView<double>(entry->values.data(), entry->values.size());
+}
+
+SeriesView<double> IndicatorCache::column(SourceColumn source) const {
+    switch (source) {
+        case SourceColumn::Open: return bars.open;
+        case SourceColumn::High: return bars.high;
+        case SourceColumn::Low: return bars.low;
+        case SourceColumn::Close: return bars.close;
+        case SourceColumn::Volume: return bars.volume;
+    }
+    return bars.close;
+}
+
+void IndicatorCache::compute(const IndicatorKey& key, std::vector<double>& values) const {
+    SeriesView<double> source = column(key.source);
+    size_t count = bars.count;
+    values.resize(count);
+
+    // Run the same streaming indicators the strategies use, so cached values
+    // are bit-for-bit what a strategy would have computed itself
+    switch (key.kind) {
+        case IndicatorKind::EMA: {
+            EMAIndicator ema(key.period);
+            for (size_t i = 0; i < count; i++) {
+                ema.update(source[i]);
+                values[i] = ema.value();
+            }
+            break;
+        }
+        case IndicatorKind::RSI: {
+            RSIIndicator rsi(key.period);
+            for (size_t i = 0; i < count; i++) {
+                rsi.update(source[i]);
+                values[i] = rsi.value();
+            }
+            break;
+        }
+        case IndicatorKind::ATR:
+        case IndicatorKind::CloseATR: {
+            // Vectorized true ranges for bars 1.. (written into `values` as
+            // scratch), then the streaming average over them
+            if (count > 1) {
+                if (key.kind == IndicatorKind::ATR) {
+                    trueRange(bars.high.data() + 1, bars.low.data() + 1, bars.close.data(),
+                              count - 1, values.data() + 1);
+                } else {
+                    simulatedTrueRange(source.data() + 1, source.data(), SIMULATED_RANGE,
+                                       count - 1, values.data() + 1);
+                }
+            }
+            const SeriesView<double>& closes = key.kind == IndicatorKind::ATR ? bars.close : source;
+            ATRIndicator atr(key.period);
+            for (size_t i = 0; i < count; i++) {
+                atr.updateTrueRange(values[i], closes[i]);
+                values[i] = atr.value();
+            }
+            break;
+        }
+        case IndicatorKind::RollingSum: {
+            RollingSum sum(key.period);
+            for (size_t i = 0; i < count; i++) {
+                sum.update(source[i]);
+                values[i] = sum.sum();
+            }
+            break;
+        }
+        case IndicatorKind::MACD:
+        case IndicatorKind::MACDSignal: {
+            MACDIndicator macd(key.period, key.period2, key.period3 > 0 ? key.period3 : 9);
+            bool signal = key.kind == IndicatorKind::MACDSignal;
+            for (size_t i = 0; i < count; i++) {
+                macd.update(source[i]);
+                values[i] = signal ? macd.signal() : macd.macd();
+            }
+            break;
+        }
+    }
+}
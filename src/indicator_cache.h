@@ -0,0 +1,68 @@
+// indicator_cache.h
+#pragma once
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <vector>
+#include "bar_columns.h"
+
+enum class IndicatorKind {
+    EMA,
+    RSI,
+    ATR,         // true range from the high/low/close columns (source ignored)
+    CloseATR,    // true range over a simulated range around the source column
+    RollingSum,
+    MACD,        // period = fast, period2 = slow
+    MACDSignal   // period = fast, period2 = slow, period3 = signal
+};
+
+enum class SourceColumn { Open, High, Low, Close, Volume };
+
+struct IndicatorKey {
+    IndicatorKind kind;
+    SourceColumn source;
+    int period;
+    int period2 = 0;
+    int period3 = 0;
+
+    bool operator<(const IndicatorKey& other) const {
+        return std::tie(kind, source, period, period2, period3) <
+               std::tie(other.kind, other.source, other.period, other.period2, other.period3);
+    }
+};
+
+// Dataset-scoped memo of fully precomputed indicator series.
+// Every strategy instance backtesting the same bars asks for its series by
+// key; each distinct series is computed once (by whichever thread asks first,
+// with concurrent callers waiting for it) and then shared read-only. Value i
+// is exactly what the streaming indicator reports after being fed bars 0..i.
+class IndicatorCache {
+public:
+    explicit IndicatorCache(const BarColumns& bars) : bars(bars), computed(0) {}
+
+    IndicatorCache(const IndicatorCache&) = delete;
+    IndicatorCache& operator=(const IndicatorCache&) = delete;
+
+    // Views stay valid for the lifetime of the cache
+    SeriesView<double> series(const IndicatorKey& key);
+
+    const BarColumns& columns() const { return bars; }
+    size_t size() const { return bars.count; }
+    size_t computedSeries() const { return computed; }
+
+private:
+    struct Entry {
+        std::once_flag once;
+        std::vector<double> values;
+    };
+
+    void compute(const IndicatorKey& key, std::vector<double>& values) const;
+    SeriesView<double> column(SourceColumn source) const;
+
+    BarColumns bars;
+    std::mutex mutex;
+    std::map<IndicatorKey, std::unique_ptr<Entry>> entries;
+    std::atomic<size_t> computed;
+};
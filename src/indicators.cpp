@@ -0,0 +1,128 @@
+// indicators.cpp
+#include "indicators.h"
+#include <numeric>
+#include <algorithm>
+#include <cmath>
+
+RollingSum::RollingSum(int period)
+    : window(std::max(period, 1))
+    , count(0)
+    , nonZero(0)
+    , total(0.0) {}
+
+void RollingSum::update(double value) {
+    if (window.full()) {
+        double oldest = window.ago(window.capacity() - 1);
+        total -= oldest;
+        if (oldest != 0) nonZero--;
+    }
+    window.push_back(value);
+    total += value;
+    if (value != 0) nonZero++;
+    count++;
+
+    if (count % window.capacity() == 0) {
+        // Re-sum once per wrap (oldest to newest) so rounding error can't accumulate
+        total = std::accumulate(window.begin(), window.end(), 0.0);
+    }
+}
+
+EMAIndicator::EMAIndicator(int period)
+    : period(std::max(period, 1))
+    , multiplier(2.0 / (std::max(period, 1) + 1))
+    , count(0)
+    , seedSum(0.0)
+    , current(0.0) {}
+
+void EMAIndicator::update(double value) {
+    count++;
+    if (count < period) {
+        seedSum += value;
+    } else if (count == period) {
+        seedSum += value;
+        current = seedSum / period;
+    } else {
+        current = (value - current) * multiplier + current;
+    }
+}
+
+MACDIndicator::MACDIndicator(int fastPeriod, int slowPeriod, int signalPeriod)
+    : slowPeriod(std::max(slowPeriod, 1))
+    , count(0)
+    , fast(fastPeriod)
+    , slow(slowPeriod)
+    , signalLine(signalPeriod)
+    , macdLine(0.0)
+    , prevMacdLine(0.0)
+    , prevSignalLine(0.0) {}
+
+void MACDIndicator::update(double price) {
+    fast.update(price);
+    slow.update(price);
+    count++;
+
+    prevMacdLine = macdLine;
+    prevSignalLine = signalLine.value();
+
+    // MACD line stays at 0 until the slow EMA is seeded; the signal EMA
+    // runs over that zero prefix as well
+    macdLine = count >= slowPeriod ? fast.value() - slow.value() : 0.0;
+    signalLine.update(macdLine);
+}
+
+RSIIndicator::RSIIndicator(int period)
+    : gains(period)
+    , losses(period)
+    , count(0)
+    , prevPrice(0.0) {}
+
+void RSIIndicator::update(double price) {
+    if (count > 0) {
+        double change = price - prevPrice;
+        if (change > 0) {
+            gains.update(change);
+            losses.update(0);
+        } else {
+            gains.update(0);
+            losses.update(std::abs(change));
+        }
+    }
+    prevPrice = price;
+    count++;
+}
+
+double RSIIndicator::value() const {
+    if (!ready()) return 50.0; // Neutral if not enough data
+
+    double avgGain = gains.mean();
+    double avgLoss = losses.mean();
+
+    if (avgLoss == 0) return 100.0;
+    double rs = avgGain / avgLoss;
+    return 100.0 - (100.0 / (1.0 + rs));
+}
+
+ATRIndicator::ATRIndicator(int period)
+    : trueRanges(period)
+    , count(0)
+    , prevClose(0.0) {}
+
+void ATRIndicator::update(double high, double low, double close) {
+    if (count > 0) {
+        double tr1 = high - low;
+        double tr2 = std::abs(high - prevClose);
+        double tr3 = std::abs(low - prevClose);
+        trueRanges.update(std::max({tr1, tr2, tr3}));
+    }
+    prevClose = close;
+    count++;
+}
+
+void ATRIndicator::updateTrueRange(double trueRange, double close) {
+    // The first bar has no previous close, so no true range
+    if (count > 0) {
+        trueRanges.update(trueRange);
+    }
+    prevClose = close;
+    count++;
+}
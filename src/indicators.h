@@ -0,0 +1,110 @@
+// indicators.h
+#pragma once
+#include <cstddef>
+#include "series_buffer.h"
+
+// Streaming technical indicators. Each indicator is fed exactly one new value
+// per bar through update() and keeps just enough state to answer in O(1),
+// instead of rescanning the whole price history on every signal check.
+
+// Sum/mean over the last `period` values
+class RollingSum {
+public:
+    explicit RollingSum(int period);
+
+    void update(double value);
+    bool ready() const { return window.full(); }
+    double sum() const { return nonZero ? total : 0.0; }
+    double mean() const { return sum() / window.capacity(); }
+    int period() const { return static_cast<int>(window.capacity()); }
+    size_t updates() const { return count; }
+
+private:
+    SeriesBuffer<double> window;
+    size_t count;
+    size_t nonZero;  // lets an all-zero window report exactly 0
+    double total;
+};
+
+// EMA seeded with the SMA of the first `period` values
+class EMAIndicator {
+public:
+    explicit EMAIndicator(int period);
+
+    void update(double value);
+    bool ready() const { return count >= period; }
+    double value() const { return current; }  // 0 until seeded
+    size_t updates() const { return count; }
+
+private:
+    size_t period;
+    double multiplier;
+    size_t count;
+    double seedSum;
+    double current;
+};
+
+// MACD line (fast EMA - slow EMA) and its signal EMA, with the previous
+// bar's values kept around for crossover checks
+class MACDIndicator {
+public:
+    MACDIndicator(int fastPeriod, int slowPeriod, int signalPeriod);
+
+    void update(double price);
+    bool ready() const { return count >= slowPeriod; }
+    size_t size() const { return count; }
+    size_t updates() const { return count; }
+    double macd() const { return macdLine; }
+    double prevMacd() const { return prevMacdLine; }
+    double signal() const { return signalLine.value(); }
+    double prevSignal() const { return prevSignalLine; }
+
+private:
+    size_t slowPeriod;
+    size_t count;
+    EMAIndicator fast;
+    EMAIndicator slow;
+    EMAIndicator signalLine;
+    double macdLine;
+    double prevMacdLine;
+    double prevSignalLine;
+};
+
+// RSI from the average gain/loss of the last `period` price changes
+class RSIIndicator {
+public:
+    explicit RSIIndicator(int period);
+
+    void update(double price);
+    bool ready() const { return count > static_cast<size_t>(gains.period()); }
+    double value() const;  // 50 (neutral) until enough data
+    size_t updates() const { return count; }
+
+private:
+    RollingSum gains;
+    RollingSum losses;
+    size_t count;
+    double prevPrice;
+};
+
+// Close-only feeds have no high/low; ATR is then taken over a simulated
+// range of +/- SIMULATED_RANGE around the close
+constexpr double SIMULATED_RANGE = 0.002;
+
+// Average true range over the last `period` bars
+class ATRIndicator {
+public:
+    explicit ATRIndicator(int period);
+
+    void update(double high, double low, double close);
+    // update() with this bar's true range already computed, e.g. by trueRange()
+    void updateTrueRange(double trueRange, double close);
+    bool ready() const { return trueRanges.ready(); }
+    double value() const { return ready() ? trueRanges.mean() : 0.0; }
+    size_t updates() const { return count; }
+
+private:
+    RollingSum trueRanges;
+    size_t count;
+    double prevClose;
+};
@@ -0,0 +1,218 @@
+// logger.cpp
+#include "logger.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+
+// How long the background thread sleeps when every ring is empty
+static constexpr std::chrono::milliseconds IDLE_POLL{1};
+
+std::atomic<LogLevel> Logger::minLevel{LogLevel::Info};
+
+struct Logger::ThreadRing {
+    std::shared_ptr<Ring> ring;
+
+    ~ThreadRing() {
+        if (ring) ring->retired.store(true, std::memory_order_release);
+    }
+};
+
+bool Logger::parseLevel(std::string_view name, LogLevel& level) {
+    if (name == "debug") level = LogLevel::Debug;
+    else if (name == "info") level = LogLevel::Info;
+    else if (name == "warn") level = LogLevel::Warn;
+    else if (name == "error") level = LogLevel::Error;
+    else if (name == "off") level = LogLevel::Off;
+    else return false;
+    return true;
+}
+
+Logger::Logger()
+    : stopping(false)
+    , direct(false)
+    , droppedTotal(0) {
+    worker = std::thread(&Logger::run, this);
+    std::atexit([] { Logger::getInstance().shutdown(); });
+}
+
+Logger::Ring* Logger::threadRing() {
+    thread_local ThreadRing registration;
+    if (!registration.ring) {
+        registration.ring = std::make_shared<Ring>();
+        std::lock_guard<std::mutex> lock(ringsMutex);
+        rings.push_back(registration.ring);
+    }
+    return registration.ring.get();
+}
+
+Logger::Record* Logger::claim() {
+    int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    if (direct.load(std::memory_order_relaxed)) {
+        thread_local Record scratch;
+        scratch.timeNs = now;
+        return &scratch;
+    }
+
+    Ring* ring = threadRing();
+    uint64_t head = ring->head.load(std::memory_order_relaxed);
+    if (head - ring->tail.load(std::memory_order_acquire) >= RING_RECORDS) {
+        ring->dropped.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+    Record* record = &ring->records[head % RING_RECORDS];
+    record->timeNs = now;
+    return record;
+}
+
+void Logger::commit(Record* record) {
+    Ring* ring = threadRing();
+    if (record >= ring->records && record < ring->records + RING_RECORDS) {
+        ring->head.store(ring->head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        return;
+    }
+
+    // Direct mode: the record is the thread's scratch one
+    std::string line;
+    format(*record, line);
+    std::fwrite(line.data(), 1, line.size(), record->level >= LogLevel::Warn ? stderr : stdout);
+    std::fflush(record->level >= LogLevel::Warn ? stderr : stdout);
+}
+
+void Logger::run() {
+    while (!stopping.load()) {
+        if (drain() == 0) std::this_thread::sleep_for(IDLE_POLL);
+    }
+}
+
+void Logger::flush() {
+    drain();
+}
+
+void Logger::shutdown() {
+    if (stopping.exchange(true)) return;
+    if (worker.joinable()) worker.join();
+    direct.store(true);
+    drain();
+}
+
+// Write out what every ring holds, in time order; returns the record count
+size_t Logger::drain() {
+    std::lock_guard<std::mutex> drainLock(drainMutex);
+    std::vector<std::shared_ptr<Ring>> current;
+    {
+        std::lock_guard<std::mutex> lock(ringsMutex);
+        current = rings;
+    }
+
+    struct Pending {
+        const Record* record;
+        int64_t timeNs;
+    };
+    std::vector<Pending> pending;
+    std::vector<uint64_t> heads(current.size());
+    for (size_t i = 0; i < current.size(); i++) {
+        Ring& ring = *current[i];
+        heads[i] = ring.head.load(std::memory_order_acquire);
+        for (uint64_t index = ring.tail.load(std::memory_order_relaxed); index < heads[i]; index++) {
+            const Record& record = ring.records[index % RING_RECORDS];
+            pending.push_back(Pending{&record, record.timeNs});
+        }
+    }
+    std::stable_sort(pending.begin(), pending.end(),
+        [](const Pending& a, const Pending& b) { return a.timeNs < b.timeNs; });
+
+    std::string out;
+    std::string err;
+    for (const Pending& entry : pending) {
+        format(*entry.record, entry.record->level >= LogLevel::Warn ? err : out);
+    }
+    for (size_t i = 0; i < current.size(); i++) {
+        current[i]->tail.store(heads[i], std::memory_order_release);
+        uint64_t dropped = current[i]->dropped.exchange(0, std::memory_order_relaxed);
+        if (dropped > 0) {
+            droppedTotal.fetch_add(dropped);
+            err += "Logger: " + std::to_string(dropped) + " records dropped, log ring full\n";
+        }
+    }
+
+    if (!out.empty()) {
+        std::fwrite(out.data(), 1, out.size(), stdout);
+        std::fflush(stdout);
+    }
+    if (!err.empty()) {
+        std::fwrite(err.data(), 1, err.size(), stderr);
+        std::fflush(stderr);
+    }
+
+    // Forget the rings of threads that have exited once they are empty
+    std::lock_guard<std::mutex> lock(ringsMutex);
+    for (auto it = rings.begin(); it != rings.end();) {
+        Ring& ring = **it;
+        if (ring.retired.load(std::memory_order_acquire) &&
+            ring.tail.load(std::memory_order_relaxed) == ring.head.load(std::memory_order_acquire)) {
+            it = rings.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    return pending.size();
+}
+
+// "12:34:56.789012 I " and the arguments as operator<< prints them
+void Logger::format(const Record& record, std::string& out) {
+    static const char LEVELS[] = "DIWE";
+    time_t seconds = static_cast<time_t>(record.timeNs / 1000000000);
+    tm local;
+    localtime_r(&seconds, &local);
+    char buffer[64];
+    int length = std::snprintf(buffer, sizeof(buffer), "%02d:%02d:%02d.%06d %c ",
+        local.tm_hour, local.tm_min, local.tm_sec, static_cast<int>(record.timeNs % 1000000000 / 1000),
+        LEVELS[std::min<int>(static_cast<int>(record.level), 3)]);
+    out.append(buffer, length);
+
+    const char* pos = record.data;
+    const char* end = record.data + record.size;
+    while (pos < end) {
+        Tag tag = static_cast<Tag>(*pos++);
+        switch (tag) {
+            case Int: {
+                int64_t value;
+                std::memcpy(&value, pos, sizeof(value));
+                pos += sizeof(value);
+                out += std::to_string(value);
+                break;
+            }
+            case Unsigned: {
+                uint64_t value;
+                std::memcpy(&value, pos, sizeof(value));
+                pos += sizeof(value);
+                out += std::to_string(value);
+                break;
+            }
+            case Double: {
+                double value;
+                std::memcpy(&value, pos, sizeof(value));
+                pos += sizeof(value);
+                length = std::snprintf(buffer, sizeof(buffer), "%g", value);  // operator<<'s default
+                out.append(buffer, length);
+                break;
+            }
+            case Bool:
+                out += *pos++ ? "true" : "false";
+                break;
+            case Char:
+                out += *pos++;
+                break;
+            case String: {
+                uint16_t size;
+                std::memcpy(&size, pos, sizeof(size));
+                out.append(pos + sizeof(size), size);
+                pos += sizeof(size) + size;
+                break;
+            }
+        }
+    }
+    out += '\n';
+}
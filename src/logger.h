@@ -0,0 +1,172 @@
+// logger.h
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+enum class LogLevel : uint8_t { Debug = 0, Info = 1, Warn = 2, Error = 3, Off = 4 };
+
+// Levels below this are compiled out, e.g. -DLOG_MIN_LEVEL=1 drops LOG_DEBUG
+#ifndef LOG_MIN_LEVEL
+#define LOG_MIN_LEVEL 0
+#endif
+
+// LOG_INFO("Order ", id, " filled at ", price) logs its arguments the way
+// operator<< would print them one after the other. The arguments are only
+// evaluated when the level is enabled.
+#define LOG_AT(level, ...) \
+    do { \
+        if (Logger::enabled(level)) Logger::getInstance().write(level, __VA_ARGS__); \
+    } while (0)
+
+#if LOG_MIN_LEVEL <= 0
+#define LOG_DEBUG(...) LOG_AT(LogLevel::Debug, __VA_ARGS__)
+#else
+#define LOG_DEBUG(...) do {} while (0)
+#endif
+#if LOG_MIN_LEVEL <= 1
+#define LOG_INFO(...) LOG_AT(LogLevel::Info, __VA_ARGS__)
+#else
+#define LOG_INFO(...) do {} while (0)
+#endif
+#if LOG_MIN_LEVEL <= 2
+#define LOG_WARN(...) LOG_AT(LogLevel::Warn, __VA_ARGS__)
+#else
+#define LOG_WARN(...) do {} while (0)
+#endif
+#define LOG_ERROR(...) LOG_AT(LogLevel::Error, __VA_ARGS__)
+
+// Asynchronous logger. A log call copies a timestamp and its raw arguments
+// (numbers as binary, strings as bytes) into a fixed-size record in its own
+// thread's ring buffer and returns; it never formats, locks or does I/O. A
+// background thread collects the records of all threads in time order,
+// formats them and writes Debug/Info to stdout and Warn/Error to stderr.
+// A full ring drops the record (counted and reported) instead of blocking.
+// At exit the rings are drained and later calls are written directly.
+class Logger {
+public:
+    // Record layout; strings longer than what is left are cut off
+    static constexpr size_t RECORD_SIZE = 256;
+    static constexpr size_t RING_RECORDS = 512;    // per thread
+
+    static Logger& getInstance() {
+        static Logger* instance = new Logger();  // never destroyed: used from other destructors
+        return *instance;
+    }
+
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
+
+    static bool enabled(LogLevel level) {
+        return level >= minLevel.load(std::memory_order_relaxed);
+    }
+    static void setLevel(LogLevel level) { minLevel.store(level, std::memory_order_relaxed); }
+
+    // "debug", "info", "warn", "error" or "off"; false leaves `level` alone
+    static bool parseLevel(std::string_view name, LogLevel& level);
+
+    template <typename... Args>
+    void write(LogLevel level, const Args&... args) {
+        Record* record = claim();
+        if (!record) return;
+        record->level = level;
+        Encoder encoder{record->data, record->data + sizeof(record->data)};
+        (encoder.put(args), ...);
+        record->size = static_cast<uint16_t>(encoder.pos - record->data);
+        commit(record);
+    }
+
+    // Write out everything logged so far
+    void flush();
+
+    // Drain and stop the background thread; later calls write directly
+    void shutdown();
+
+    // Records lost to full rings since start
+    uint64_t dropped() const { return droppedTotal.load(); }
+
+private:
+    enum Tag : uint8_t { Int, Unsigned, Double, Bool, Char, String };
+
+    struct Record {
+        int64_t timeNs;
+        LogLevel level;
+        uint16_t size;
+        char data[RECORD_SIZE - 16];
+    };
+    static_assert(sizeof(Record) == RECORD_SIZE, "log record layout");
+
+    struct Encoder {
+        char* pos;
+        char* end;
+
+        template <typename T>
+        void raw(Tag tag, const T& value) {
+            if (static_cast<size_t>(end - pos) < 1 + sizeof(T)) {
+                pos = end;
+                return;
+            }
+            *pos++ = static_cast<char>(tag);
+            std::memcpy(pos, &value, sizeof(T));
+            pos += sizeof(T);
+        }
+
+        void put(std::string_view text) {
+            if (static_cast<size_t>(end - pos) < 3) return;
+            uint16_t length = static_cast<uint16_t>(std::min<size_t>(text.size(), end - pos - 3));
+            *pos++ = static_cast<char>(String);
+            std::memcpy(pos, &length, sizeof(length));
+            std::memcpy(pos + sizeof(length), text.data(), length);
+            pos += sizeof(length) + length;
+        }
+        void put(const char* text) { put(std::string_view(text ? text : "(null)")); }
+        void put(const std::string& text) { put(std::string_view(text)); }
+        void put(char value) { raw(Char, value); }
+        void put(bool value) { raw(Bool, value); }
+
+        template <typename T>
+        std::enable_if_t<std::is_arithmetic_v<T>> put(T value) {
+            if constexpr (std::is_floating_point_v<T>) raw(Double, static_cast<double>(value));
+            else if constexpr (std::is_signed_v<T>) raw(Int, static_cast<int64_t>(value));
+            else raw(Unsigned, static_cast<uint64_t>(value));
+        }
+    };
+
+    // Single-producer ring of one thread, read by the background thread
+    struct Ring {
+        Record records[RING_RECORDS];
+        alignas(64) std::atomic<uint64_t> head{0};     // next record to write
+        alignas(64) std::atomic<uint64_t> tail{0};     // next record to read
+        std::atomic<uint64_t> dropped{0};
+        std::atomic<bool> retired{false};              // thread has exited
+    };
+
+    struct ThreadRing;   // a thread's registration, retires its ring at thread exit
+
+    Logger();
+
+    Record* claim();
+    void commit(Record* record);
+    Ring* threadRing();
+    void run();
+    size_t drain();
+    static void format(const Record& record, std::string& out);
+
+    static std::atomic<LogLevel> minLevel;
+
+    std::mutex ringsMutex;
+    std::vector<std::shared_ptr<Ring>> rings;
+    std::mutex drainMutex;                 // one drain at a time
+    std::atomic<bool> stopping;
+    std::atomic<bool> direct;              // after shutdown(): format on the caller
+    std::atomic<uint64_t> droppedTotal;
+    std::thread worker;
+};
@@ -1,22 +1,30 @@
-#include <iostream>
 #include <curl/curl.h>
 #include "api.h"
 #include "order_manager.h"
 #include "SMA_strategy.h"
+#include "market_stream.h"
+#include "order_book_feed.h"
+#include "market_data_cache.h"
+#include "clock_sync.h"
 #include "config/config.h"
-#include <nlohmann/json.hpp>
+#include "logger.h"
+#include <algorithm>
 #include <chrono>
 #include <thread>
 
 int main() {
-    std::cout << "Starting trading bot..." << std::endl;
+    LogLevel logLevel;
+    if (Logger::parseLevel(Config::getInstance().getSetting("log_level", "info"), logLevel)) {
+        Logger::setLevel(logLevel);
+    }
+    LOG_INFO("Starting trading bot...");
     
     // Initialize CURL
     if (curl_global_init(CURL_GLOBAL_DEFAULT) != CURLE_OK) {
-        std::cerr << "Failed to initialize CURL" << std::endl;
+        LOG_ERROR("Failed to initialize CURL");
         return 1;
     }
-    std::cout << "CURL initialized successfully." << std::endl;
+    LOG_INFO("CURL initialized successfully.");
 
     // Initialize API and OrderManager
     BinanceAPI api;
@@ -24,65 +32,122 @@ int main() {
 
     // Check if API is initialized correctly
     if (!api.is_initialized()) {
-        std::cerr << "API initialization failed. Check config settings." << std::endl;
+        LOG_ERROR("API initialization failed. Check config settings.");
         return 1;
     }
 
+    // Signed requests are stamped with the exchange clock; get a first estimate
+    if (!ClockSync::getInstance().waitForSync(std::chrono::seconds(5))) {
+        LOG_WARN("No exchange time yet, signing with the local clock.");
+    }
+
     // Fetch current price for validation
     std::string symbol = Config::getInstance().getSetting("default_market", "BTCUSDT");
     double currentPrice = orderManager.getCurrentPrice(symbol);
     
     if (currentPrice > 0) {
-        std::cout << "Current " << symbol << " price: " << currentPrice << std::endl;
+        LOG_INFO("Current ", symbol, " price: ", currentPrice);
     } else {
-        std::cerr << "Failed to retrieve price data." << std::endl;
+        LOG_ERROR("Failed to retrieve price data.");
+    }
+
+    // Exchange filters for the pre-trade check; orders never load them
+    if (!orderManager.loadSymbolFilters({symbol})) {
+        LOG_WARN("No exchange filters for ", symbol, " yet, orders are rejected until they load.");
     }
 
     // Fetch account information
-    std::cout << "\nFetching account information..." << std::endl;
-    std::string accountInfo = orderManager.getAccountInfo();
-    
-    if (!accountInfo.empty()) {
-        try {
-            nlohmann::json j = nlohmann::json::parse(accountInfo);
-            std::cout << "Account Info Summary:\n";
-            std::cout << "- Can Trade: " << (j["canTrade"].get<bool>() ? "Yes" : "No") << std::endl;
-            std::cout << "- Account Type: " << j["accountType"].get<std::string>() << std::endl;
-            std::cout << "- Balances:\n";
-            
-            for (const auto& balance : j["balances"]) {
-                double free = std::stod(balance["free"].get<std::string>());
-                if (free > 0) {  // Only show non-zero balances
-                    std::cout << "  " << balance["asset"].get<std::string>() << ": " 
-                              << free << " (free) / "
-                              << balance["locked"].get<std::string>() << " (locked)" << std::endl;
-                }
+    LOG_INFO("Fetching account information...");
+    AccountBalances account;
+    if (orderManager.getAccountBalances(account)) {
+        LOG_INFO("Account Info Summary:");
+        LOG_INFO("- Can Trade: ", (account.canTrade ? "Yes" : "No"));
+        LOG_INFO("- Account Type: ", account.accountType);
+        LOG_INFO("- Balances:");
+        
+        for (const AccountBalances::Balance& balance : account.balances) {
+            if (balance.free > 0) {  // Only show non-zero balances
+                LOG_INFO("  ", balance.asset, ": ", balance.free, " (free) / ", balance.locked, " (locked)");
             }
-        } catch (const std::exception& e) {
-            std::cerr << "Error parsing account info: " << e.what() << std::endl;
-            std::cout << "Raw response: " << accountInfo << std::endl;
         }
     } else {
-        std::cerr << "Failed to get account information." << std::endl;
+        LOG_ERROR("Failed to get account information.");
     }
 
     // Initialize and run the trading strategy
-    std::cout << "\nInitializing trading strategy..." << std::endl;
+    LOG_INFO("Initializing trading strategy...");
     SMAStrategy strategy(api, orderManager, symbol, 10, 50);
 
-    std::cout << "Running strategy loop...\n" << std::endl;
+    // Push market data from the WebSocket streams unless disabled in config
+    std::vector<std::string> streams = MarketDataStream::configuredStreams(symbol);
+    bool haveDepth = std::any_of(streams.begin(), streams.end(),
+                                 [](const std::string& name) { return name.find("@depth") != std::string::npos; });
+    // Declared first so it outlives the stream that feeds it
+    OrderBookFeed orderBooks(api, {symbol});
+    MarketDataStream marketData(streams);
+    if (haveDepth) {
+        // Local book for the slippage check on market orders
+        marketData.setDepthHandler([&orderBooks](DepthUpdate& update) { orderBooks.onUpdate(update); });
+        orderManager.attachOrderBook(orderBooks);
+    }
+    if (!streams.empty()) {
+        strategy.attachMarketData(marketData);
+        marketData.start();
+    }
+
+    LOG_INFO("Running strategy loop...");
     std::thread strategyThread(&SMAStrategy::run, &strategy);
     
     // Run strategy in a separate thread and allow manual exit
     while (true) {
         std::this_thread::sleep_for(std::chrono::seconds(10));
-        std::cout << "Main thread is alive. Strategy running in background..." << std::endl;
+        LOG_INFO("Main thread is alive. Strategy running in background...");
+        if (!orderManager.hasSymbolFilters(symbol) && orderManager.loadSymbolFilters({symbol})) {
+            LOG_INFO("Exchange filters for ", symbol, " loaded");
+        }
+        if (!streams.empty()) {
+            MarketDataStream::Stats stats = marketData.getStats();
+            LOG_INFO("Market data: ", stats.received, " events, ", stats.dropped, " dropped, ", stats.connects, " connects, tick-to-signal p50 ", stats.latencyP50Us, "us p99 ", stats.latencyP99Us, "us");
+        }
+        MarketDataCache::Stats cacheStats = MarketDataCache::getInstance().getStats();
+        for (int kind = 0; kind < MarketDataCache::KINDS; kind++) {
+            const MarketDataCache::Stats::Counters& cache = cacheStats.kinds[kind];
+            if (cache.hits + cache.misses == 0) continue;
+            LOG_INFO("Cached ", MarketDataCache::kindName(static_cast<MarketDataCache::Kind>(kind)), ": ",
+                     cache.hits, " hits (mean age ", cache.meanHitAgeMs, "ms), ", cache.misses, " misses (",
+                     cache.expired, " expired, ", cache.coalesced, " coalesced, ", cache.failures, " failed)");
+        }
+        OrderTracker::Stats orderStats = orderManager.getOrderStats();
+        if (orderStats.tracked > 0) {
+            LOG_INFO("Orders: ", orderStats.tracked, " tracked, ", orderStats.open, " open, ", orderStats.applied,
+                     " updates, ", orderStats.stale, " stale");
+        }
+        PreTradeRisk::Stats riskStats = orderManager.getRiskStats();
+        if (riskStats.checked > riskStats.passed) {
+            std::string reasons;
+            for (size_t reason = 1; reason < static_cast<size_t>(RiskReject::Count); reason++) {
+                if (riskStats.rejected[reason] == 0) continue;
+                reasons += (reasons.empty() ? "" : ", ") + std::to_string(riskStats.rejected[reason]) + " " +
+                           riskRejectName(static_cast<RiskReject>(reason));
+            }
+            LOG_INFO("Pre-trade check: ", riskStats.passed, " of ", riskStats.checked, " passed; rejected ", reasons);
+        }
+        if (haveDepth) {
+            OrderBookFeed::Stats bookStats = orderBooks.getStats();
+            DepthLevel bid, ask;
+            if (orderBooks.top(symbol, bid, ask)) {
+                LOG_INFO("Order book ", symbol, ": ", bid.quantity, " @ ", bid.price, " / ", ask.quantity, " @ ", ask.price,
+                         ", ", bookStats.updates, " updates, ", bookStats.gaps, " gaps, ", bookStats.snapshots, " snapshots");
+            } else {
+                LOG_INFO("Order book ", symbol, " not synced, ", bookStats.snapshots, " snapshots requested");
+            }
+        }
     }
 
     // Cleanup before exiting
     curl_global_cleanup();
     Config::cleanup();
     
-    std::cout << "Program finished." << std::endl;
+    LOG_INFO("Program finished.");
     return 0;
 }
@@ -0,0 +1,258 @@
+// market_data_cache.cpp
+#include "market_data_cache.h"
+#include <functional>
+#include "api.h"
+#include "clock_sync.h"
+#include "config/config.h"
+#include "logger.h"
+#include "market_stream.h"
+#include "response_decoder.h"
+
+MarketDataCache& MarketDataCache::getInstance() {
+    static MarketDataCache instance;
+    return instance;
+}
+
+MarketDataCache::MarketDataCache()
+    : reportedFull(false) {
+    const Config& config = Config::getInstance();
+    ttl[PriceData] = std::chrono::milliseconds(std::stol(config.getSetting("market_cache_price_ttl", "1000")));
+    ttl[BookData] = std::chrono::milliseconds(std::stol(config.getSetting("market_cache_book_ttl", "1000")));
+    ttl[KlineData] = std::chrono::milliseconds(std::stol(config.getSetting("market_cache_kline_ttl", "2000")));
+    klineInterval = config.getSetting("market_cache_kline_interval", "1m");
+    for (std::atomic<Entry*>& slot : table) slot.store(nullptr, std::memory_order_relaxed);
+}
+
+const char* MarketDataCache::kindName(Kind kind) {
+    switch (kind) {
+        case PriceData: return "price";
+        case BookData: return "bookTicker";
+        case KlineData: return "kline";
+    }
+    return "";
+}
+
+// Linear probing; entries are never removed, so a lookup stops at the first
+// empty slot and readers need no lock
+MarketDataCache::Entry* MarketDataCache::find(const std::string& symbol, bool create) {
+    size_t start = std::hash<std::string>()(symbol) % MAX_SYMBOLS;
+    for (size_t i = 0; i < MAX_SYMBOLS; i++) {
+        Entry* entry = table[(start + i) % MAX_SYMBOLS].load(std::memory_order_acquire);
+        if (!entry) break;
+        if (entry->symbol == symbol) return entry;
+    }
+    if (!create) return nullptr;
+
+    std::lock_guard<std::mutex> lock(insertMutex);
+    for (size_t i = 0; i < MAX_SYMBOLS; i++) {
+        std::atomic<Entry*>& slot = table[(start + i) % MAX_SYMBOLS];
+        Entry* entry = slot.load(std::memory_order_relaxed);
+        if (!entry) {
+            entries.push_back(std::make_unique<Entry>(symbol));
+            slot.store(entries.back().get(), std::memory_order_release);
+            return entries.back().get();
+        }
+        if (entry->symbol == symbol) return entry;  // inserted meanwhile
+    }
+    if (!reportedFull) {
+        reportedFull = true;
+        LOG_WARN("Market data cache holds ", MAX_SYMBOLS, " symbols, fetching ", symbol, " uncached");
+    }
+    return nullptr;
+}
+
+template <typename Quote>
+bool MarketDataCache::get(BinanceAPI& api, const std::string& symbol, Kind kind, Slot<Quote> Entry::*member, Quote& out) {
+    Counters& count = counters[kind];
+    Entry* entry = find(symbol, true);
+    if (!entry) {
+        count.misses.fetch_add(1, std::memory_order_relaxed);
+        return fetch(api, symbol, out);
+    }
+    Slot<Quote>& slot = entry->*member;
+
+    if (slot.value.version() > 0) {
+        out = slot.value.load();
+        Clock::duration age = Clock::now() - out.updated;
+        if (age <= ttl[kind]) {
+            count.hits.fetch_add(1, std::memory_order_relaxed);
+            count.hitAgeUs.fetch_add(std::chrono::duration_cast<std::chrono::microseconds>(age).count(),
+                                     std::memory_order_relaxed);
+            return true;
+        }
+        count.expired.fetch_add(1, std::memory_order_relaxed);
+    }
+    count.misses.fetch_add(1, std::memory_order_relaxed);
+
+    std::unique_lock<std::mutex> lock(entry->mutex);
+    if (slot.fetching) {
+        // Someone is already asking for it: take their answer
+        count.coalesced.fetch_add(1, std::memory_order_relaxed);
+        entry->fetched.wait(lock, [&slot] { return !slot.fetching; });
+        if (slot.value.version() == 0) return false;
+        out = slot.value.load();
+        return Clock::now() - out.updated <= ttl[kind];
+    }
+    if (slot.value.version() > 0) {
+        // A fetch may have finished since the check above
+        out = slot.value.load();
+        if (Clock::now() - out.updated <= ttl[kind]) return true;
+    }
+    slot.fetching = true;
+    lock.unlock();
+
+    Quote fresh;
+    bool fetched = fetch(api, symbol, fresh);
+
+    lock.lock();
+    slot.fetching = false;
+    if (fetched) {
+        slot.value.store(fresh);
+        out = fresh;
+    } else {
+        count.failures.fetch_add(1, std::memory_order_relaxed);
+    }
+    entry->fetched.notify_all();
+    return fetched;
+}
+
+template <typename Quote>
+bool MarketDataCache::peek(const std::string& symbol, Kind kind, Slot<Quote> Entry::*member, Quote& out) {
+    Entry* entry = find(symbol, false);
+    if (!entry || (entry->*member).value.version() == 0) return false;
+    Quote cached = (entry->*member).value.load();
+    if (Clock::now() - cached.updated > ttl[kind]) return false;
+    out = cached;
+    return true;
+}
+
+bool MarketDataCache::cachedPrice(const std::string& symbol, PriceQuote& out) {
+    return peek(symbol, PriceData, &Entry::price, out);
+}
+
+bool MarketDataCache::cachedBookTicker(const std::string& symbol, BookQuote& out) {
+    return peek(symbol, BookData, &Entry::book, out);
+}
+
+bool MarketDataCache::lastPrice(BinanceAPI& api, const std::string& symbol, PriceQuote& out) {
+    return get(api, symbol, PriceData, &Entry::price, out);
+}
+
+bool MarketDataCache::bookTicker(BinanceAPI& api, const std::string& symbol, BookQuote& out) {
+    return get(api, symbol, BookData, &Entry::book, out);
+}
+
+bool MarketDataCache::latestKline(BinanceAPI& api, const std::string& symbol, KlineQuote& out) {
+    return get(api, symbol, KlineData, &Entry::kline, out);
+}
+
+bool MarketDataCache::fetch(BinanceAPI& api, const std::string& symbol, PriceQuote& out) {
+    std::string response = api.send_public_request("/api/v3/ticker/price?symbol=" + symbol);
+    TickerPrice ticker;
+    if (!decodeTickerPrice(response, ticker)) {
+        LOG_ERROR("Error parsing price: ", response);
+        return false;
+    }
+    out.price = ticker.price;
+    out.updated = Clock::now();
+    return true;
+}
+
+bool MarketDataCache::fetch(BinanceAPI& api, const std::string& symbol, BookQuote& out) {
+    std::string response = api.send_public_request("/api/v3/ticker/bookTicker?symbol=" + symbol);
+    BookTicker ticker;
+    if (!decodeBookTicker(response, ticker)) {
+        LOG_ERROR("Error parsing book ticker: ", response);
+        return false;
+    }
+    out.bid = ticker.bidPrice;
+    out.bidQty = ticker.bidQty;
+    out.ask = ticker.askPrice;
+    out.askQty = ticker.askQty;
+    out.updated = Clock::now();
+    return true;
+}
+
+bool MarketDataCache::fetch(BinanceAPI& api, const std::string& symbol, KlineQuote& out) {
+    std::string response = api.send_public_request("/api/v3/klines?symbol=" + symbol +
+                                                    "&interval=" + klineInterval + "&limit=1");
+    std::vector<Kline> klines;
+    if (!decodeKlines(response, klines) || klines.empty()) {
+        LOG_ERROR("Error parsing klines: ", response);
+        return false;
+    }
+    const Kline& kline = klines.back();
+    out.openTime = kline.openTime;
+    out.open = kline.open;
+    out.high = kline.high;
+    out.low = kline.low;
+    out.close = kline.close;
+    out.volume = kline.volume;
+    out.closed = kline.closeTime < ClockSync::getInstance().exchangeTimeMs();
+    out.updated = Clock::now();
+    return true;
+}
+
+void MarketDataCache::publish(const MarketEvent& event) {
+    Entry* entry = find(event.symbol, true);
+    if (!entry) return;
+
+    std::lock_guard<std::mutex> lock(entry->mutex);
+    // Streams can interleave, e.g. a kline close older than the last trade
+    auto newer = [&event](int64_t stored) { return event.eventTime == 0 || event.eventTime >= stored; };
+
+    if (event.type == MarketEvent::Trade || event.type == MarketEvent::Kline) {
+        if (entry->price.value.version() == 0 || newer(entry->price.value.load().eventTime)) {
+            PriceQuote quote;
+            quote.price = event.price;
+            quote.eventTime = event.eventTime;
+            quote.updated = event.received;
+            entry->price.value.store(quote);
+            counters[PriceData].streamUpdates.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    if (event.type == MarketEvent::Kline && event.interval == klineInterval) {
+        KlineQuote quote;
+        quote.openTime = event.openTime;
+        quote.open = event.open;
+        quote.high = event.high;
+        quote.low = event.low;
+        quote.close = event.price;
+        quote.volume = event.volume;
+        quote.closed = event.closed;
+        quote.eventTime = event.eventTime;
+        quote.updated = event.received;
+        entry->kline.value.store(quote);
+        counters[KlineData].streamUpdates.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (event.type == MarketEvent::BookTicker) {
+        BookQuote quote;
+        quote.bid = event.bid;
+        quote.bidQty = event.bidQty;
+        quote.ask = event.ask;
+        quote.askQty = event.askQty;
+        quote.eventTime = event.eventTime;
+        quote.updated = event.received;
+        entry->book.value.store(quote);
+        counters[BookData].streamUpdates.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+MarketDataCache::Stats MarketDataCache::getStats() const {
+    Stats stats;
+    for (int kind = 0; kind < KINDS; kind++) {
+        const Counters& count = counters[kind];
+        Stats::Counters& out = stats.kinds[kind];
+        out.hits = count.hits.load(std::memory_order_relaxed);
+        out.misses = count.misses.load(std::memory_order_relaxed);
+        out.expired = count.expired.load(std::memory_order_relaxed);
+        out.coalesced = count.coalesced.load(std::memory_order_relaxed);
+        out.failures = count.failures.load(std::memory_order_relaxed);
+        out.streamUpdates = count.streamUpdates.load(std::memory_order_relaxed);
+        if (out.hits > 0) out.meanHitAgeMs = count.hitAgeUs.load(std::memory_order_relaxed) / 1000.0 / out.hits;
+    }
+    for (const std::atomic<Entry*>& slot : table) {
+        if (slot.load(std::memory_order_acquire)) stats.symbols++;
+    }
+    return stats;
+}
@@ -0,0 +1,155 @@
+// market_data_cache.h
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "seqlock.h"
+
+class BinanceAPI;
+struct MarketEvent;
+
+// Cached values carry the time they were stored (steady clock) and, when
+// they came from a stream, the exchange event time
+struct PriceQuote {
+    double price = 0;
+    int64_t eventTime = 0;    // ms, 0 from REST
+    std::chrono::steady_clock::time_point updated;
+};
+
+struct BookQuote {
+    double bid = 0;
+    double bidQty = 0;
+    double ask = 0;
+    double askQty = 0;
+    int64_t eventTime = 0;
+    std::chrono::steady_clock::time_point updated;
+};
+
+struct KlineQuote {
+    int64_t openTime = 0;     // ms
+    double open = 0;
+    double high = 0;
+    double low = 0;
+    double close = 0;
+    double volume = 0;
+    bool closed = false;
+    int64_t eventTime = 0;
+    std::chrono::steady_clock::time_point updated;
+};
+
+// Process-wide cache of the latest price, book ticker and kline per symbol.
+// A value younger than its TTL is served from memory; otherwise the caller
+// fetches it over REST, and concurrent callers missing the same symbol and
+// kind wait for that one fetch instead of sending their own. MarketDataStream
+// publishes its events here, so with streams running most reads are hits.
+//
+// Reads that hit take no lock: symbols sit in a fixed open-addressing table
+// that only grows, and each value is behind a SeqLock.
+//
+// Settings (config.json, all optional):
+//   market_cache_price_ttl       ms a last price is served (default 1000)
+//   market_cache_book_ttl        ms a book ticker is served (default 1000)
+//   market_cache_kline_ttl       ms the latest kline is served (default 2000)
+//   market_cache_kline_interval  interval of the kline kept (default 1m)
+class MarketDataCache {
+public:
+    enum Kind { PriceData, BookData, KlineData };
+    static constexpr int KINDS = 3;
+
+    // Symbols the table holds; more are fetched uncached
+    static constexpr size_t MAX_SYMBOLS = 256;
+
+    struct Stats {
+        struct Counters {
+            uint64_t hits = 0;
+            uint64_t misses = 0;          // not cached or older than the TTL
+            uint64_t expired = 0;         // of the misses, cached but too old
+            uint64_t coalesced = 0;       // of the misses, waited for another caller's fetch
+            uint64_t failures = 0;        // fetches that failed
+            uint64_t streamUpdates = 0;   // values published by MarketDataStream
+            double meanHitAgeMs = 0;      // age of the values served from memory
+        };
+        Counters kinds[KINDS];
+        size_t symbols = 0;
+    };
+
+    static MarketDataCache& getInstance();
+
+    MarketDataCache(const MarketDataCache&) = delete;
+    MarketDataCache& operator=(const MarketDataCache&) = delete;
+
+    // Cached value if fresh, else fetched through `api`; false if the fetch failed
+    bool lastPrice(BinanceAPI& api, const std::string& symbol, PriceQuote& out);
+    bool bookTicker(BinanceAPI& api, const std::string& symbol, BookQuote& out);
+    bool latestKline(BinanceAPI& api, const std::string& symbol, KlineQuote& out);
+
+    // Cached value if fresh, never fetched: for callers that must not wait
+    // on REST. Not counted in the stats.
+    bool cachedPrice(const std::string& symbol, PriceQuote& out);
+    bool cachedBookTicker(const std::string& symbol, BookQuote& out);
+
+    // A kline, trade or bookTicker event; called on the stream's reader thread
+    void publish(const MarketEvent& event);
+
+    Stats getStats() const;
+    static const char* kindName(Kind kind);
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    template <typename Quote>
+    struct Slot {
+        SeqLock<Quote> value;     // version 0 until the first store
+        bool fetching = false;    // guarded by Entry::mutex
+    };
+
+    struct Entry {
+        explicit Entry(const std::string& symbol) : symbol(symbol) {}
+        const std::string symbol;
+        Slot<PriceQuote> price;
+        Slot<BookQuote> book;
+        Slot<KlineQuote> kline;
+        std::mutex mutex;                   // stores and fetch state
+        std::condition_variable fetched;
+    };
+
+    // Shared by all readers, so each on its own cache line
+    struct alignas(64) Counters {
+        std::atomic<uint64_t> hits{0};
+        std::atomic<uint64_t> misses{0};
+        std::atomic<uint64_t> expired{0};
+        std::atomic<uint64_t> coalesced{0};
+        std::atomic<uint64_t> failures{0};
+        std::atomic<uint64_t> streamUpdates{0};
+        std::atomic<uint64_t> hitAgeUs{0};
+    };
+
+    MarketDataCache();
+
+    Entry* find(const std::string& symbol, bool create);
+
+    template <typename Quote>
+    bool peek(const std::string& symbol, Kind kind, Slot<Quote> Entry::*member, Quote& out);
+
+    template <typename Quote>
+    bool get(BinanceAPI& api, const std::string& symbol, Kind kind, Slot<Quote> Entry::*member, Quote& out);
+
+    // One REST request each
+    bool fetch(BinanceAPI& api, const std::string& symbol, PriceQuote& out);
+    bool fetch(BinanceAPI& api, const std::string& symbol, BookQuote& out);
+    bool fetch(BinanceAPI& api, const std::string& symbol, KlineQuote& out);
+
+    Clock::duration ttl[KINDS];
+    std::string klineInterval;
+    Counters counters[KINDS];
+
+    std::atomic<Entry*> table[MAX_SYMBOLS];
+    std::mutex insertMutex;
+    std::vector<std::unique_ptr<Entry>> entries;   // owners of the table's entries
+    bool reportedFull;
+};
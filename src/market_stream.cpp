@@ -0,0 +1,321 @@
+// market_stream.cpp
+#include "market_stream.h"
+#include <poll.h>
+#include <algorithm>
+#include <cctype>
+#include "logger.h"
+#include <sstream>
+#include <nlohmann/json.hpp>
+#include "config/config.h"
+#include "market_data_cache.h"
+#include "response_decoder.h"
+
+using json = nlohmann::json;
+using Clock = std::chrono::steady_clock;
+
+MarketDataStream::MarketDataStream(std::vector<std::string> streams)
+    : streams(std::move(streams))
+    , running(false)
+    , connected(false)
+    , curl(nullptr)
+    , socket(CURL_SOCKET_BAD)
+    , nextRequestId(1)
+    , head(0)
+    , count(0)
+    , nextSample(0)
+    , latencySumUs(0) {
+    const Config& config = Config::getInstance();
+    url = config.getSetting("ws_url", "wss://stream.testnet.binance.vision") + "/stream";
+    caBundle = config.getSetting("ca_bundle");
+    connectTimeout = std::stol(config.getSetting("connect_timeout", "10"));
+    reconnectDelay = std::chrono::milliseconds(std::stol(config.getSetting("reconnect_delay", "1000")));
+    queue.resize(std::max(1L, std::stol(config.getSetting("market_queue_capacity", "1024"))));
+}
+
+MarketDataStream::~MarketDataStream() {
+    stop();
+}
+
+std::vector<std::string> MarketDataStream::configuredStreams(const std::string& symbol) {
+    std::string lowerSymbol = symbol;
+    std::transform(lowerSymbol.begin(), lowerSymbol.end(), lowerSymbol.begin(),
+                   [](unsigned char c) { return std::tolower(c); });
+
+    std::vector<std::string> names;
+    std::stringstream kinds(Config::getInstance().getSetting("market_streams", "kline_1m"));
+    std::string kind;
+    while (std::getline(kinds, kind, ',')) {
+        if (!kind.empty()) names.push_back(lowerSymbol + "@" + kind);
+    }
+    return names;
+}
+
+void MarketDataStream::start() {
+    if (running.exchange(true)) return;
+    reader = std::thread(&MarketDataStream::readerLoop, this);
+}
+
+void MarketDataStream::stop() {
+    if (!running.exchange(false)) return;
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        stopRequested.notify_all();
+        queueReady.notify_all();
+    }
+    if (reader.joinable()) reader.join();
+}
+
+bool MarketDataStream::pop(MarketEvent& event, std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> lock(queueMutex);
+    if (!queueReady.wait_for(lock, timeout, [this] { return count > 0 || !running; }) || count == 0) {
+        return false;
+    }
+    event = std::move(queue[head]);
+    head = (head + 1) % queue.size();
+    count--;
+    return true;
+}
+
+void MarketDataStream::push(MarketEvent&& event) {
+    std::lock_guard<std::mutex> lock(queueMutex);
+    if (count == queue.size()) {
+        // Full: the newest price matters more than the oldest one
+        head = (head + 1) % queue.size();
+        count--;
+        stats.dropped++;
+    }
+    queue[(head + count) % queue.size()] = std::move(event);
+    count++;
+    stats.received++;
+    queueReady.notify_one();
+}
+
+void MarketDataStream::recordSignal(const MarketEvent& event) {
+    auto latency = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - event.received).count();
+    uint32_t sample = static_cast<uint32_t>(std::min<int64_t>(latency, UINT32_MAX));
+
+    std::lock_guard<std::mutex> lock(queueMutex);
+    if (latencySamplesNs.size() < LATENCY_SAMPLES) {
+        latencySamplesNs.push_back(sample);
+    } else {
+        latencySamplesNs[nextSample] = sample;
+        nextSample = (nextSample + 1) % LATENCY_SAMPLES;
+    }
+    latencySumUs += sample / 1000.0;
+    stats.latencyMaxUs = std::max(stats.latencyMaxUs, sample / 1000.0);
+    stats.signals++;
+}
+
+MarketDataStream::Stats MarketDataStream::getStats() const {
+    std::vector<uint32_t> samples;
+    Stats result;
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        result = stats;
+        samples = latencySamplesNs;
+        if (stats.signals > 0) result.latencyMeanUs = latencySumUs / stats.signals;
+    }
+    if (!samples.empty()) {
+        // Percentiles over the most recent samples
+        std::sort(samples.begin(), samples.end());
+        result.latencyP50Us = samples[samples.size() / 2] / 1000.0;
+        result.latencyP99Us = samples[std::min(samples.size() - 1, samples.size() * 99 / 100)] / 1000.0;
+    }
+    return result;
+}
+
+void MarketDataStream::readerLoop() {
+    std::chrono::milliseconds delay = reconnectDelay;
+    while (running) {
+        if (connect()) {
+            uint64_t before = getStats().received;
+            while (running && receive()) {}
+            disconnect();
+            // A connection that delivered data resets the backoff
+            if (getStats().received > before) delay = reconnectDelay;
+        }
+        if (!running) break;
+
+        LOG_WARN("Market data stream disconnected, reconnecting in ", delay.count(), "ms...");
+        waitBeforeReconnect(delay);
+        delay = std::min(delay * 2, std::chrono::milliseconds(30000));
+    }
+}
+
+void MarketDataStream::waitBeforeReconnect(std::chrono::milliseconds delay) {
+    std::unique_lock<std::mutex> lock(queueMutex);
+    stopRequested.wait_for(lock, delay, [this] { return !running; });
+}
+
+bool MarketDataStream::connect() {
+    curl = curl_easy_init();
+    if (!curl) {
+        LOG_ERROR("Failed to initialize CURL.");
+        return false;
+    }
+    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+    curl_easy_setopt(curl, CURLOPT_CONNECT_ONLY, 2L);  // WebSocket upgrade, then curl_ws_recv/send
+    curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT, connectTimeout);
+    curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+    curl_easy_setopt(curl, CURLOPT_TCP_NODELAY, 1L);
+    curl_easy_setopt(curl, CURLOPT_TCP_KEEPALIVE, 1L);
+    if (!caBundle.empty()) curl_easy_setopt(curl, CURLOPT_CAINFO, caBundle.c_str());
+
+    CURLcode res = curl_easy_perform(curl);
+    if (res != CURLE_OK) {
+        LOG_ERROR("Market data stream connect failed: ", curl_easy_strerror(res));
+        disconnect();
+        return false;
+    }
+    curl_easy_getinfo(curl, CURLINFO_ACTIVESOCKET, &socket);
+
+    // Streams are per connection, so (re)subscribe every time
+    json request = {{"method", "SUBSCRIBE"}, {"params", streams}, {"id", nextRequestId++}};
+    if (!sendText(request.dump())) {
+        disconnect();
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        stats.connects++;
+    }
+    connected = true;
+    return true;
+}
+
+void MarketDataStream::disconnect() {
+    connected = false;
+    partial.clear();
+    if (curl) {
+        curl_easy_cleanup(curl);
+        curl = nullptr;
+    }
+    socket = CURL_SOCKET_BAD;
+}
+
+bool MarketDataStream::sendText(const std::string& text) {
+    size_t offset = 0;
+    while (offset < text.size()) {
+        size_t sent = 0;
+        CURLcode res = curl_ws_send(curl, text.data() + offset, text.size() - offset, &sent, 0, CURLWS_TEXT);
+        if (res == CURLE_AGAIN) {
+            pollfd fd{socket, POLLOUT, 0};
+            poll(&fd, 1, 100);
+            continue;
+        }
+        if (res != CURLE_OK) {
+            LOG_ERROR("Market data stream send failed: ", curl_easy_strerror(res));
+            return false;
+        }
+        offset += sent;
+    }
+    return true;
+}
+
+// Read everything available; false once the connection is gone
+bool MarketDataStream::receive() {
+    // Short timeout so stop() is noticed promptly
+    pollfd fd{socket, POLLIN, 0};
+    if (poll(&fd, 1, 250) == 0) return true;
+
+    char buffer[16384];
+    while (true) {
+        size_t length = 0;
+        const curl_ws_frame* frame = nullptr;
+        CURLcode res = curl_ws_recv(curl, buffer, sizeof(buffer), &length, &frame);
+        if (res == CURLE_AGAIN) return true;
+        if (res != CURLE_OK) {
+            LOG_ERROR("Market data stream read failed: ", curl_easy_strerror(res));
+            return false;
+        }
+        if (frame->flags & CURLWS_CLOSE) return false;
+        if (frame->flags & (CURLWS_PING | CURLWS_PONG)) continue;  // curl answers pings itself
+
+        if (partial.empty()) partialReceived = Clock::now();
+        partial.append(buffer, length);
+        if (frame->bytesleft == 0 && !(frame->flags & CURLWS_CONT)) {
+            handleMessage(partial, partialReceived);
+            partial.clear();
+        }
+    }
+}
+
+void MarketDataStream::handleMessage(const std::string& message, Clock::time_point received) {
+    if (depthHandler && message.find("\"depthUpdate\"") != std::string::npos) {
+        DepthUpdate update;
+        bool decoded = decodeDepthUpdate(message, update);
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            if (decoded) {
+                stats.received++;
+                stats.depthUpdates++;
+            } else {
+                stats.parseErrors++;
+            }
+        }
+        if (decoded) depthHandler(update);
+        return;
+    }
+
+    MarketEvent event;
+    if (!parseEvent(message, event)) return;
+    event.received = received;
+    MarketDataCache::getInstance().publish(event);
+    push(std::move(event));
+}
+
+bool MarketDataStream::parseEvent(const std::string& message, MarketEvent& event) {
+    json j = json::parse(message, nullptr, false);
+    if (j.is_discarded() || !j.is_object()) {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        stats.parseErrors++;
+        return false;
+    }
+    // Reply to our SUBSCRIBE request
+    if (j.contains("id")) {
+        if (j.contains("error")) {
+            LOG_ERROR("Market data subscription failed: ", j["error"].dump());
+        }
+        return false;
+    }
+
+    try {
+        // Combined streams wrap the payload as {"stream": ..., "data": ...}
+        const json& data = j.contains("data") ? j["data"] : j;
+        std::string type = data.value("e", "");
+        event.symbol = data.value("s", "");
+        event.eventTime = data.value("E", int64_t(0));
+        if (type == "kline") {
+            const json& k = data.at("k");
+            event.type = MarketEvent::Kline;
+            event.price = std::stod(k.at("c").get<std::string>());
+            event.volume = std::stod(k.at("v").get<std::string>());
+            event.open = std::stod(k.at("o").get<std::string>());
+            event.high = std::stod(k.at("h").get<std::string>());
+            event.low = std::stod(k.at("l").get<std::string>());
+            event.openTime = k.at("t").get<int64_t>();
+            event.interval = k.at("i").get<std::string>();
+            event.closed = k.at("x").get<bool>();
+        } else if (type == "trade") {
+            event.type = MarketEvent::Trade;
+            event.price = std::stod(data.at("p").get<std::string>());
+            event.volume = std::stod(data.at("q").get<std::string>());
+        } else if (data.contains("b") && data.contains("a")) {
+            event.type = MarketEvent::BookTicker;
+            event.bid = std::stod(data.at("b").get<std::string>());
+            event.bidQty = std::stod(data.at("B").get<std::string>());
+            event.ask = std::stod(data.at("a").get<std::string>());
+            event.askQty = std::stod(data.at("A").get<std::string>());
+            event.price = (event.bid + event.ask) / 2;
+        } else {
+            return false;  // a stream kind we don't decode
+        }
+    } catch (const std::exception& e) {
+        LOG_ERROR("Error parsing market data event: ", e.what());
+        std::lock_guard<std::mutex> lock(queueMutex);
+        stats.parseErrors++;
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,138 @@
+// market_stream.h
+#pragma once
+#include <curl/curl.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct DepthUpdate;
+
+// One decoded stream event
+struct MarketEvent {
+    enum Type { Kline, Trade, BookTicker };
+
+    Type type = Trade;
+    std::string symbol;
+    double price = 0;        // kline close, trade price or book mid
+    double volume = 0;       // kline volume or trade quantity
+    double open = 0;         // kline only
+    double high = 0;
+    double low = 0;
+    int64_t openTime = 0;    // kline start in ms
+    std::string interval;    // kline only, e.g. "1m"
+    double bid = 0;          // bookTicker only
+    double bidQty = 0;
+    double ask = 0;
+    double askQty = 0;
+    bool closed = true;      // false for a kline that is still forming
+    int64_t eventTime = 0;   // exchange time in ms, 0 if the stream has none
+    std::chrono::steady_clock::time_point received;
+
+    // A forming kline repeats its bar until it closes, so it is no new data point
+    bool isUpdate() const { return type != Kline || closed; }
+};
+
+// Push-style market data from the exchange's WebSocket streams (kline, trade,
+// bookTicker). A reader thread decodes each message into a MarketEvent and
+// hands it to the consumer through a bounded queue; if the consumer falls
+// behind, the oldest events are dropped and counted. Lost connections are
+// reopened with exponential backoff and every stream is subscribed again.
+// Each event is also published to the MarketDataCache.
+// Diff depth events (the depth / depth@100ms kinds) skip the queue: they go
+// to the depth handler on the reader thread, since a local book must see
+// every one of them in order.
+//
+// Settings (config.json, all optional):
+//   ws_url                 stream endpoint (default wss://stream.testnet.binance.vision)
+//   market_streams         comma separated stream kinds, e.g. "kline_1m,trade,bookTicker,depth@100ms"
+//   market_queue_capacity  events buffered for the consumer (default 1024)
+//   reconnect_delay        first reconnect delay in ms, doubled up to 30s (default 1000)
+class MarketDataStream {
+public:
+    struct Stats {
+        uint64_t received = 0;      // events decoded
+        uint64_t depthUpdates = 0;  // of which diff depth events
+        uint64_t dropped = 0;       // events overwritten in a full queue
+        uint64_t parseErrors = 0;
+        uint64_t connects = 0;
+        uint64_t signals = 0;       // recordSignal() calls
+        // Tick-to-signal latency: event read off the socket -> signal evaluated
+        double latencyMeanUs = 0;
+        double latencyP50Us = 0;
+        double latencyP99Us = 0;
+        double latencyMaxUs = 0;
+    };
+
+    // Stream names as the exchange spells them, e.g. "btcusdt@kline_1m"
+    explicit MarketDataStream(std::vector<std::string> streams);
+    ~MarketDataStream();
+
+    MarketDataStream(const MarketDataStream&) = delete;
+    MarketDataStream& operator=(const MarketDataStream&) = delete;
+
+    // "market_streams" from config applied to one symbol
+    static std::vector<std::string> configuredStreams(const std::string& symbol);
+
+    // Receives every diff depth event; set before start()
+    void setDepthHandler(std::function<void(DepthUpdate&)> handler) { depthHandler = std::move(handler); }
+
+    void start();
+    void stop();
+    bool isConnected() const { return connected; }
+
+    // Wait up to `timeout` for the next event; false on timeout or stop
+    bool pop(MarketEvent& event, std::chrono::milliseconds timeout);
+
+    // Called by the consumer once it has acted on `event`
+    void recordSignal(const MarketEvent& event);
+
+    Stats getStats() const;
+
+private:
+    void readerLoop();
+    bool connect();
+    void disconnect();
+    bool sendText(const std::string& text);
+    bool receive();
+    void handleMessage(const std::string& message, std::chrono::steady_clock::time_point received);
+    bool parseEvent(const std::string& message, MarketEvent& event);
+    void push(MarketEvent&& event);
+    void waitBeforeReconnect(std::chrono::milliseconds delay);
+
+    std::vector<std::string> streams;
+    std::string url;
+    std::string caBundle;
+    long connectTimeout;
+    std::chrono::milliseconds reconnectDelay;
+    std::function<void(DepthUpdate&)> depthHandler;
+
+    std::thread reader;
+    std::atomic<bool> running;
+    std::atomic<bool> connected;
+    CURL* curl;
+    curl_socket_t socket;
+    std::string partial;  // message being reassembled from frames
+    std::chrono::steady_clock::time_point partialReceived;
+    int nextRequestId;
+
+    // Ring buffer of pending events, oldest at `head`
+    mutable std::mutex queueMutex;
+    std::condition_variable queueReady;
+    std::condition_variable stopRequested;
+    std::vector<MarketEvent> queue;
+    size_t head;
+    size_t count;
+
+    // Counters and latency samples (guarded by queueMutex)
+    Stats stats;
+    std::vector<uint32_t> latencySamplesNs;  // most recent LATENCY_SAMPLES
+    size_t nextSample;
+    double latencySumUs;
+    static constexpr size_t LATENCY_SAMPLES = 4096;
+};
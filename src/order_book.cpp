@@ -0,0 +1,109 @@
+// order_book.cpp
+#include "order_book.h"
+#include <algorithm>
+#include <iterator>
+
+std::vector<DepthLevel>::const_iterator OrderBook::Side::find(double price) const {
+    return std::lower_bound(levels.begin(), levels.end(), price,
+        [this](const DepthLevel& level, double target) { return worse(level.price, target); });
+}
+
+void OrderBook::Side::set(double price, double quantity) {
+    auto it = levels.begin() + (find(price) - levels.cbegin());
+    bool exists = it != levels.end() && it->price == price;
+    if (quantity == 0) {
+        if (exists) levels.erase(it);
+    } else if (exists) {
+        it->quantity = quantity;
+    } else {
+        levels.insert(it, DepthLevel{price, quantity});
+    }
+}
+
+void OrderBook::Side::load(std::vector<DepthLevel>& snapshot) {
+    levels = std::move(snapshot);
+    levels.erase(std::remove_if(levels.begin(), levels.end(),
+        [](const DepthLevel& level) { return level.quantity == 0; }), levels.end());
+    // The exchange sends best first
+    std::sort(levels.begin(), levels.end(),
+        [this](const DepthLevel& a, const DepthLevel& b) { return worse(a.price, b.price); });
+}
+
+OrderBook::Update OrderBook::applyUpdate(DepthUpdate&& update) {
+    if (!isSynced) {
+        if (pending.size() == MAX_BUFFERED) pending.erase(pending.begin());
+        pending.push_back(std::move(update));
+        return Update::Buffered;
+    }
+    Update result = apply(update);
+    if (result == Update::Gap) {
+        clear();
+        pending.push_back(std::move(update));
+    }
+    return result;
+}
+
+bool OrderBook::applySnapshot(DepthSnapshot&& snapshot) {
+    bids.load(snapshot.bids);
+    asks.load(snapshot.asks);
+    lastId = snapshot.lastUpdateId;
+    isSynced = true;
+
+    std::vector<DepthUpdate> replay;
+    replay.swap(pending);
+    for (size_t i = 0; i < replay.size(); i++) {
+        if (apply(replay[i]) == Update::Gap) {
+            // Keep what is left for the next snapshot to start from
+            clear();
+            pending.assign(std::make_move_iterator(replay.begin() + i), std::make_move_iterator(replay.end()));
+            return false;
+        }
+    }
+    return true;
+}
+
+void OrderBook::clear() {
+    bids.levels.clear();
+    asks.levels.clear();
+    lastId = 0;
+    isSynced = false;
+    pending.clear();
+}
+
+// Called synced
+OrderBook::Update OrderBook::apply(const DepthUpdate& update) {
+    if (update.finalUpdateId <= lastId) return Update::Stale;
+    if (update.firstUpdateId > lastId + 1) return Update::Gap;
+    for (const DepthLevel& level : update.bids) bids.set(level.price, level.quantity);
+    for (const DepthLevel& level : update.asks) asks.set(level.price, level.quantity);
+    lastId = update.finalUpdateId;
+    return Update::Applied;
+}
+
+double OrderBook::quantityAt(BookSide side, double price) const {
+    const Side& levels = side == BookSide::Bid ? bids : asks;
+    auto it = levels.find(price);
+    return it != levels.levels.end() && it->price == price ? it->quantity : 0;
+}
+
+FillEstimate OrderBook::estimateFill(bool buy, double quantity) const {
+    const Side& side = buy ? asks : bids;
+    FillEstimate fill;
+    fill.requested = quantity;
+    if (side.levels.empty() || quantity <= 0) return fill;
+
+    fill.bestPrice = side.levels.back().price;
+    double remaining = quantity;
+    double notional = 0;
+    for (auto it = side.levels.rbegin(); it != side.levels.rend() && remaining > 0; ++it) {
+        double take = std::min(remaining, it->quantity);
+        notional += take * it->price;
+        remaining -= take;
+        fill.worstPrice = it->price;
+        fill.levels++;
+    }
+    fill.filled = remaining > 0 ? quantity - remaining : quantity;
+    fill.averagePrice = notional / fill.filled;
+    fill.slippage = (buy ? fill.averagePrice - fill.bestPrice : fill.bestPrice - fill.averagePrice) / fill.bestPrice;
+    return fill;
+}
@@ -0,0 +1,84 @@
+// order_book.h
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "response_decoder.h"
+
+enum class BookSide { Bid, Ask };
+
+// What a market order of `requested` would get from the visible book
+struct FillEstimate {
+    double requested = 0;
+    double filled = 0;          // less than requested when the book runs out
+    double averagePrice = 0;    // VWAP of the filled part
+    double worstPrice = 0;      // last level reached
+    double bestPrice = 0;       // touch before the order
+    double slippage = 0;        // averagePrice away from bestPrice, as a fraction
+    int levels = 0;             // levels reached
+
+    bool complete() const { return filled >= requested; }
+};
+
+// L2 book of one symbol, kept the way the exchange documents it: diff events
+// are buffered until a /api/v3/depth snapshot arrives, events the snapshot
+// already covers are skipped, and each later event must start right after
+// the previous one (U <= lastUpdateId + 1). A missing event clears the book
+// until a new snapshot is applied.
+//
+// Each side is one flat sorted array with the best price at the back, so
+// the common change near the touch moves few elements and a fill estimate
+// walks contiguous memory. Not thread-safe; OrderBookFeed serializes access.
+class OrderBook {
+public:
+    enum class Update { Applied, Buffered, Stale, Gap };
+
+    // Events kept while waiting for a snapshot; older ones are dropped
+    static constexpr size_t MAX_BUFFERED = 4096;
+
+    // Apply, or buffer while there is no snapshot. Gap drops the book and
+    // keeps this event buffered for the next snapshot.
+    Update applyUpdate(DepthUpdate&& update);
+
+    // Load a snapshot and replay the buffered events on top of it. False if
+    // the snapshot is older than the buffered events reach back (fetch
+    // another) or the replay found a gap.
+    bool applySnapshot(DepthSnapshot&& snapshot);
+
+    void clear();
+
+    bool synced() const { return isSynced; }
+    int64_t lastUpdateId() const { return lastId; }
+    size_t buffered() const { return pending.size(); }
+
+    // Zero price and quantity when the side is empty
+    DepthLevel bestBid() const { return bids.best(); }
+    DepthLevel bestAsk() const { return asks.best(); }
+    double quantityAt(BookSide side, double price) const;
+    size_t depth(BookSide side) const { return side == BookSide::Bid ? bids.levels.size() : asks.levels.size(); }
+
+    // Walk the asks (buy) or the bids (sell) for `quantity`
+    FillEstimate estimateFill(bool buy, double quantity) const;
+
+private:
+    struct Side {
+        bool isBid;
+        std::vector<DepthLevel> levels;   // worst first, best at the back
+
+        explicit Side(bool isBid) : isBid(isBid) {}
+        DepthLevel best() const { return levels.empty() ? DepthLevel{} : levels.back(); }
+        // Whether `a` is further from the touch than `b`
+        bool worse(double a, double b) const { return isBid ? a < b : a > b; }
+        std::vector<DepthLevel>::const_iterator find(double price) const;
+        void set(double price, double quantity);
+        void load(std::vector<DepthLevel>& snapshot);
+    };
+
+    Update apply(const DepthUpdate& update);
+
+    Side bids{true};
+    Side asks{false};
+    int64_t lastId = 0;
+    bool isSynced = false;
+    std::vector<DepthUpdate> pending;
+};
@@ -0,0 +1,130 @@
+// order_book_feed.cpp
+#include "order_book_feed.h"
+#include "api.h"
+#include "config/config.h"
+#include "logger.h"
+
+OrderBookFeed::OrderBookFeed(BinanceAPI& api, const std::vector<std::string>& symbols)
+    : api(api)
+    , fetchesInFlight(0) {
+    snapshotLimit = std::stoi(Config::getInstance().getSetting("depth_snapshot_limit", "1000"));
+    for (const std::string& symbol : symbols) {
+        books.emplace(symbol, std::make_unique<Entry>());
+    }
+}
+
+OrderBookFeed::~OrderBookFeed() {
+    // Snapshot callbacks hold on to the entries
+    std::unique_lock<std::mutex> lock(fetchMutex);
+    fetchDone.wait(lock, [this] { return fetchesInFlight == 0; });
+}
+
+void OrderBookFeed::onUpdate(DepthUpdate& update) {
+    auto it = books.find(update.symbol);
+    if (it == books.end()) return;
+    const std::string& symbol = it->first;
+    Entry& entry = *it->second;
+
+    bool fetch = false;
+    {
+        std::lock_guard<std::mutex> lock(entry.mutex);
+        int64_t previousId = entry.book.lastUpdateId();
+        switch (entry.book.applyUpdate(std::move(update))) {
+            case OrderBook::Update::Applied:
+                entry.stats.updates++;
+                break;
+            case OrderBook::Update::Stale:
+                entry.stats.stale++;
+                break;
+            case OrderBook::Update::Gap:
+                entry.stats.gaps++;
+                LOG_WARN("Order book ", symbol, " missed updates after ", previousId, ", resyncing");
+                break;
+            case OrderBook::Update::Buffered:
+                break;
+        }
+
+        std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        if (!entry.book.synced() && !entry.fetching && now >= entry.nextFetch) {
+            entry.fetching = true;
+            entry.nextFetch = now + std::chrono::seconds(1);
+            entry.stats.snapshots++;
+            fetch = true;
+        }
+    }
+    if (fetch) requestSnapshot(symbol, entry);
+}
+
+void OrderBookFeed::requestSnapshot(const std::string& symbol, Entry& entry) {
+    {
+        std::lock_guard<std::mutex> lock(fetchMutex);
+        fetchesInFlight++;
+    }
+    std::string endpoint = "/api/v3/depth?symbol=" + symbol + "&limit=" + std::to_string(snapshotLimit);
+    api.send_public_request_async(endpoint, [this, &symbol, &entry](const std::string& body) {
+        DepthSnapshot snapshot;
+        bool decoded = decodeDepthSnapshot(body, snapshot);
+        {
+            std::lock_guard<std::mutex> lock(entry.mutex);
+            entry.fetching = false;
+            if (!decoded) {
+                LOG_ERROR("Bad depth snapshot for ", symbol, ": ", body);
+            } else if (!entry.book.applySnapshot(std::move(snapshot))) {
+                LOG_WARN("Depth snapshot for ", symbol, " does not reach the buffered updates, fetching another");
+            } else {
+                LOG_INFO("Order book ", symbol, " synced at update ", entry.book.lastUpdateId());
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(fetchMutex);
+        fetchesInFlight--;
+        fetchDone.notify_all();
+    });
+}
+
+const OrderBookFeed::Entry* OrderBookFeed::find(const std::string& symbol) const {
+    auto it = books.find(symbol);
+    return it == books.end() ? nullptr : it->second.get();
+}
+
+bool OrderBookFeed::top(const std::string& symbol, DepthLevel& bid, DepthLevel& ask) const {
+    const Entry* entry = find(symbol);
+    if (!entry) return false;
+    std::lock_guard<std::mutex> lock(entry->mutex);
+    if (!entry->book.synced()) return false;
+    bid = entry->book.bestBid();
+    ask = entry->book.bestAsk();
+    return true;
+}
+
+bool OrderBookFeed::quantityAt(const std::string& symbol, BookSide side, double price, double& quantity) const {
+    const Entry* entry = find(symbol);
+    if (!entry) return false;
+    std::lock_guard<std::mutex> lock(entry->mutex);
+    if (!entry->book.synced()) return false;
+    quantity = entry->book.quantityAt(side, price);
+    return true;
+}
+
+bool OrderBookFeed::estimateFill(const std::string& symbol, bool buy, double quantity, FillEstimate& fill) const {
+    const Entry* entry = find(symbol);
+    if (!entry) return false;
+    std::lock_guard<std::mutex> lock(entry->mutex);
+    if (!entry->book.synced()) return false;
+    fill = entry->book.estimateFill(buy, quantity);
+    return true;
+}
+
+OrderBookFeed::Stats OrderBookFeed::getStats() const {
+    Stats total;
+    for (const auto& item : books) {
+        const Entry& entry = *item.second;
+        std::lock_guard<std::mutex> lock(entry.mutex);
+        total.updates += entry.stats.updates;
+        total.stale += entry.stats.stale;
+        total.gaps += entry.stats.gaps;
+        total.snapshots += entry.stats.snapshots;
+        if (entry.book.synced()) total.syncedBooks++;
+    }
+    return total;
+}
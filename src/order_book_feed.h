@@ -0,0 +1,68 @@
+// order_book_feed.h
+#pragma once
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "order_book.h"
+
+class BinanceAPI;
+
+// Local order books for a fixed set of symbols, fed with <symbol>@depth
+// stream events (see MarketDataStream::setDepthHandler) and /api/v3/depth
+// snapshots. A book asks for a snapshot once it has buffered its first
+// events, and again after a gap, at most once a second. Queries are
+// thread-safe and take one uncontended lock; they fail while the book is
+// not synced.
+//
+// Setting (config.json, optional):
+//   depth_snapshot_limit  levels per side in a snapshot (default 1000)
+class OrderBookFeed {
+public:
+    struct Stats {
+        uint64_t updates = 0;      // events applied
+        uint64_t stale = 0;        // events the snapshot already covered
+        uint64_t gaps = 0;         // missed events, book dropped and resynced
+        uint64_t snapshots = 0;    // snapshots requested
+        size_t syncedBooks = 0;
+    };
+
+    OrderBookFeed(BinanceAPI& api, const std::vector<std::string>& symbols);
+    ~OrderBookFeed();
+
+    OrderBookFeed(const OrderBookFeed&) = delete;
+    OrderBookFeed& operator=(const OrderBookFeed&) = delete;
+
+    // One stream event; called on the stream's reader thread
+    void onUpdate(DepthUpdate& update);
+
+    bool top(const std::string& symbol, DepthLevel& bid, DepthLevel& ask) const;
+    bool quantityAt(const std::string& symbol, BookSide side, double price, double& quantity) const;
+    bool estimateFill(const std::string& symbol, bool buy, double quantity, FillEstimate& fill) const;
+
+    Stats getStats() const;
+
+private:
+    struct Entry {
+        mutable std::mutex mutex;
+        OrderBook book;
+        bool fetching = false;
+        std::chrono::steady_clock::time_point nextFetch;
+        Stats stats;
+    };
+
+    const Entry* find(const std::string& symbol) const;
+    void requestSnapshot(const std::string& symbol, Entry& entry);
+
+    BinanceAPI& api;
+    int snapshotLimit;
+    std::unordered_map<std::string, std::unique_ptr<Entry>> books;  // fixed after construction
+
+    std::mutex fetchMutex;
+    std::condition_variable fetchDone;
+    int fetchesInFlight;
+};
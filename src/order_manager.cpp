@@ -1,15 +1,12 @@
 #include "order_manager.h"
-#include <openssl/hmac.h>
-#include <sstream>
-#include <iomanip>
-#include <ctime>
+#include <cmath>
 #include <cstdlib> // For getenv()
-#include <nlohmann/json.hpp>
-#include <iostream>
+#include "logger.h"
 #include <curl/curl.h>
 #include "config/config.h"
-
-using json = nlohmann::json;
+#include "response_decoder.h"
+#include "order_book_feed.h"
+#include "market_data_cache.h"
 
 // Helper function to safely get environment variables
 std::string get_env_var(const std::string& key) {
@@ -17,175 +14,237 @@ std::string get_env_var(const std::string& key) {
     return val == nullptr ? "" : std::string(val);
 }
 
-// Function to generate HMAC SHA256 signature
-std::string hmac_sha256(const std::string &data, const std::string &key) {
-    unsigned char* digest = HMAC(EVP_sha256(), key.c_str(), key.length(), 
-                                 (unsigned char*)data.c_str(), data.length(), nullptr, nullptr);
-    
-    std::ostringstream hex_stream;
-    for (int i = 0; i < 32; i++)
-        hex_stream << std::hex << std::setw(2) << std::setfill('0') << (int)digest[i];
-
-    return hex_stream.str();
-}
-
-// Function to get current timestamp
-long get_timestamp() {
-    return std::time(nullptr) * 1000;
+// Error codes (with a 4xx) that mean the exchange did not take the order.
+// Anything else, notably -1000 unknown, -1001 disconnected, -1006
+// unexpected response and -1007 timeout, leaves its state open.
+static bool isOrderRejection(int code) {
+    switch (code) {
+        case -1002:    // unauthorized
+        case -1003:    // too many requests
+        case -1013:    // filter failure
+        case -1015:    // too many new orders
+        case -1021:    // timestamp outside recvWindow
+        case -1022:    // bad signature
+        case -2010:    // new order rejected
+        case -2014:    // bad API key format
+        case -2015:    // API key, IP or permissions refused
+            return true;
+        default:
+            return code <= -1100 && code >= -1199;    // malformed parameters
+    }
 }
 
-// Add these as member variables in the OrderManager class header file
-// and remove these global variables
-std::string BASE_URL = "https://testnet.binance.vision/api/v3/order";
-std::string API_KEY;
-std::string SECRET_KEY;
-
 // Update the place_order function to be a member of OrderManager
 std::string OrderManager::place_order(const std::string& symbol, 
                                     const std::string& side, 
                                     const std::string& type, 
                                     double quantity, 
                                     double price) {
-    CURL *curl = curl_easy_init();
-    if (!curl) {
-        std::cerr << "Failed to initialize CURL." << std::endl;
-        return "";
-    }
-
-    std::ostringstream params;
-    params << "symbol=" << symbol << "&side=" << side 
-           << "&type=" << type << "&quantity=" << quantity 
-           << "&timestamp=" << std::time(nullptr) * 1000;
-
-    if (type == "LIMIT") params << "&price=" << price << "&timeInForce=GTC";
-
-    std::string query = params.str();
-    std::string signature = hmac_sha256(query, api_secret);
-    query += "&signature=" + signature;
-
-    std::string url = base_url + "?" + query;
-    
-    struct curl_slist *headers = nullptr;
-    headers = curl_slist_append(headers, ("X-MBX-APIKEY: " + api_key).c_str());
-
-    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-    curl_easy_setopt(curl, CURLOPT_POST, 1);
-    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
-    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, NULL);
-
-    CURLcode res = curl_easy_perform(curl);
-    curl_easy_cleanup(curl);
-
-    return (res == CURLE_OK) ? "Order Placed" : "Order Failed";
+    if (type == "MARKET" && !checkSlippage(symbol, side, quantity)) return "";
+    return sendOrder(symbol, side, type, quantity, price);
 }
 
 OrderManager::OrderManager() 
-    : config(Config::getInstance()) {
+    : config(Config::getInstance())
+    , orderBook(nullptr) {
     api_key = config.getApiKey();
     api_secret = config.getApiSecret();
     base_url = config.getSetting("base_url") + "/api/v3/order";
+    maxSlippage = std::stod(config.getSetting("max_slippage", "0.1"));
+    closedRetention = std::chrono::seconds(std::stol(config.getSetting("closed_order_retention", "3600")));
 }
 
-bool OrderManager::validateOrder(const std::string& symbol, 
-                               const std::string& side, 
-                               const std::string& type, 
-                               double quantity, 
-                               double price) const {
-    // Get minimum order size from config
-    double min_order_size = std::stod(config.getSetting("min_order_size", "10.0"));
-    
-    if (quantity * price < min_order_size) {
-        std::cerr << "Order size too small. Minimum is " << min_order_size << " USD" << std::endl;
-        return false;
+bool OrderManager::checkSlippage(const std::string& symbol, const std::string& side, double quantity) const {
+    if (!orderBook) return true;
+
+    FillEstimate fill;
+    if (!orderBook->estimateFill(symbol, side == "BUY", quantity, fill)) {
+        LOG_WARN("No synced order book for ", symbol, ", sending market order unchecked");
+        return true;
     }
-    
-    // Validate side
-    if (side != "BUY" && side != "SELL") {
-        std::cerr << "Invalid side. Must be BUY or SELL" << std::endl;
+    if (!fill.complete()) {
+        LOG_WARN("Market ", side, " of ", quantity, " ", symbol, " rejected: book shows only ", fill.filled,
+                 " over ", fill.levels, " levels");
         return false;
     }
-    
-    // Validate type
-    if (type != "MARKET" && type != "LIMIT") {
-        std::cerr << "Invalid order type. Must be MARKET or LIMIT" << std::endl;
+    if (fill.slippage * 100 > maxSlippage) {
+        LOG_WARN("Market ", side, " of ", quantity, " ", symbol, " rejected: expected fill ", fill.averagePrice,
+                 " is ", fill.slippage * 100, "% from ", fill.bestPrice, ", limit ", maxSlippage, "%");
         return false;
     }
-    
+    LOG_DEBUG("Market ", side, " of ", quantity, " ", symbol, " expected at ", fill.averagePrice,
+              " over ", fill.levels, " levels");
     return true;
 }
 
+double OrderManager::referencePrice(const std::string& symbol) const {
+    MarketDataCache& cache = MarketDataCache::getInstance();
+    PriceQuote last;
+    if (cache.cachedPrice(symbol, last) && last.price > 0) return last.price;
+    DepthLevel bid, ask;
+    if (orderBook && orderBook->top(symbol, bid, ask)) return (bid.price + ask.price) / 2;
+    BookQuote book;
+    if (cache.cachedBookTicker(symbol, book) && book.bid > 0 && book.ask > 0) return (book.bid + book.ask) / 2;
+    return 0;
+}
+
 std::string OrderManager::placeMarketOrder(const std::string& symbol, const std::string& side, double quantity) {
-    // Format the parameters exactly as Binance expects
-    std::stringstream query;
-    query << std::fixed << std::setprecision(8);
-    query << "symbol=" << symbol
-          << "&type=MARKET"
-          << "&side=" << side
-          << "&quantity=" << quantity;
-    
-    // Send POST request
-    std::string response = api.send_signed_request("/api/v3/order", query.str(), "POST");
-    
-    // Parse and format the response
-    try {
-        json j = json::parse(response);
-        std::cout << "\nMarket Order Result:" << std::endl;
-        std::cout << "Status: " << j["status"].get<std::string>() << std::endl;
-        std::cout << "Order ID: " << j["orderId"].get<int>() << std::endl;
-        std::cout << "Price: " << j["fills"][0]["price"].get<std::string>() << " USDT" << std::endl;
-        std::cout << "Quantity: " << j["executedQty"].get<std::string>() << " BTC" << std::endl;
-        std::cout << "Total: " << j["cummulativeQuoteQty"].get<std::string>() << " USDT\n" << std::endl;
-    } catch (const std::exception& e) {
-        std::cout << "Raw response: " << response << std::endl;
-    }
-    
-    return response;
+    if (!checkSlippage(symbol, side, quantity)) return "";
+    return sendOrder(symbol, side, "MARKET", quantity, 0.0);
 }
 
 std::string OrderManager::placeLimitOrder(const std::string& symbol, const std::string& side, double quantity, double price) {
-    // Format the parameters exactly as Binance expects
-    std::stringstream query;
-    query << std::fixed << std::setprecision(8);
-    query << "symbol=" << symbol
-          << "&type=LIMIT"
-          << "&side=" << side
-          << "&timeInForce=GTC"
-          << "&quantity=" << quantity
-          << "&price=" << std::setprecision(2) << price;
-    
-    std::string queryStr = query.str();
-    std::cout << "Debug - Limit Order Query: " << queryStr << std::endl;
+    return sendOrder(symbol, side, "LIMIT", quantity, price);
+}
+
+std::string OrderManager::sendOrder(const std::string& symbol,
+                                    const std::string& side,
+                                    const std::string& type,
+                                    double quantity,
+                                    double price) {
+    tracker.removeClosed(closedRetention);
+
+    if (side != "BUY" && side != "SELL") {
+        LOG_ERROR("Invalid side ", side, ". Must be BUY or SELL");
+        return "";
+    }
+    if (type != "MARKET" && type != "LIMIT") {
+        LOG_ERROR("Invalid order type ", type, ". Must be MARKET or LIMIT");
+        return "";
+    }
+    // From here on amounts are exact; the strategy's doubles are taken at
+    // the nearest 1e-8 and rounded to the symbol's step and tick below
+    constexpr double LARGEST = 9e10;
+    if (!(std::fabs(quantity) < LARGEST) || !(std::fabs(price) < LARGEST)) {
+        LOG_ERROR("Invalid ", type, " ", side, " of ", quantity, " ", symbol, " at ", price);
+        return "";
+    }
+    double reference = referencePrice(symbol);
+    RiskCheck check = risk.check(symbol, side == "BUY", type == "MARKET", Decimal::fromDouble(quantity),
+                                 Decimal::fromDouble(price), reference);
+    if (!check.ok()) {
+        LOG_ERROR(type, " ", side, " of ", quantity, " ", symbol, " (price ", price, ", market ", reference,
+                  ") not sent: ", riskRejectName(check.reject));
+        return "";
+    }
+
+    TrackedOrder order;
+    order.clientOrderId = tracker.nextClientOrderId();
+    order.symbol = symbol;
+    order.side = side;
+    order.type = type;
+    order.quantity = check.quantity;
+    if (type == "LIMIT") order.price = check.price;
+    std::string clientOrderId = order.clientOrderId;
+    if (!tracker.add(std::move(order))) return "";
+
+    // Format the parameters exactly as Binance expects; built and signed in place
+    RequestBuilder request;
+    api.begin_request(request, "/api/v3/order");
+    request.add("symbol", symbol)
+           .add("type", type)
+           .add("side", side);
+    if (type == "LIMIT") request.add("timeInForce", "GTC");
+    request.add("quantity", check.quantity, check.quantityDecimals);
+    if (type == "LIMIT") request.add("price", check.price, check.priceDecimals);
+    request.add("newClientOrderId", clientOrderId);
+
+    LOG_DEBUG("Order query: ", request.query());
     
     // Send POST request
-    std::string response = api.send_signed_request("/api/v3/order", queryStr, "POST");
+    long status = 0;
+    std::string response = api.send_signed_request(request, "POST", &status);
     
     // Parse and format the response
-    try {
-        json j = json::parse(response);
-        std::cout << "\nLimit Order Result:" << std::endl;
-        std::cout << "Status: " << j["status"].get<std::string>() << std::endl;
-        std::cout << "Order ID: " << j["orderId"].get<int>() << std::endl;
-        std::cout << "Price: " << j["price"].get<std::string>() << " USDT" << std::endl;
-        std::cout << "Quantity: " << j["origQty"].get<std::string>() << " BTC\n" << std::endl;
-    } catch (const std::exception& e) {
-        std::cout << "Raw response: " << response << std::endl;
+    OrderAck ack;
+    ApiError error;
+    if (decodeOrderAck(response, ack)) {
+        applyAck(ack, symbol, side);
+        if (type == "MARKET") {
+            LOG_INFO("Market order ", clientOrderId, " (", ack.orderId, ") ", ack.status, ": ", ack.executedQty.text(),
+                     " BTC at ", ack.firstFillPrice.text(), " USDT, total ", ack.cummulativeQuoteQty.text(), " USDT");
+        } else {
+            LOG_INFO("Limit order ", clientOrderId, " (", ack.orderId, ") ", ack.status, ": ", ack.origQty.text(),
+                     " BTC at ", ack.price.text(), " USDT");
+        }
+    } else if (status >= 400 && status < 500 && decodeApiError(response, error) && isOrderRejection(error.code)) {
+        tracker.reject(clientOrderId);
+        LOG_ERROR("Order ", clientOrderId, " rejected: ", error.code, " ", error.msg);
+    } else {
+        // No reply, a 5xx or a code that does not say the order was refused:
+        // it may or may not be on the book
+        LOG_WARN("Order ", clientOrderId, " state unknown until refreshed, HTTP ", status, ", response: ", response);
     }
     
-    return response;
+    return clientOrderId;
+}
+
+bool OrderManager::cancelOrder(const std::string& clientOrderId) {
+    TrackedOrder order;
+    if (!tracker.find(clientOrderId, order)) {
+        LOG_ERROR("Order ", clientOrderId, " is not tracked");
+        return false;
+    }
+    RequestBuilder request;
+    api.begin_request(request, "/api/v3/order");
+    request.add("symbol", order.symbol)
+           .add("origClientOrderId", clientOrderId);
+    return applyResponse(order, api.send_signed_request(request, "DELETE"), "cancel");
+}
+
+bool OrderManager::refreshOrder(const std::string& clientOrderId) {
+    TrackedOrder order;
+    if (!tracker.find(clientOrderId, order)) {
+        LOG_ERROR("Order ", clientOrderId, " is not tracked");
+        return false;
+    }
+    RequestBuilder request;
+    api.begin_request(request, "/api/v3/order");
+    request.add("symbol", order.symbol)
+           .add("origClientOrderId", clientOrderId);
+    return applyResponse(order, api.send_signed_request(request, "GET"), "query");
+}
+
+bool OrderManager::applyResponse(const TrackedOrder& order, const std::string& response, const char* action) {
+    OrderAck ack;
+    if (decodeOrderAck(response, ack)) {
+        applyAck(ack, order.symbol, order.side);
+        return true;
+    }
+    ApiError error;
+    if (decodeApiError(response, error)) {
+        LOG_ERROR("Order ", order.clientOrderId, " ", action, " failed: ", error.code, " ", error.msg);
+    } else {
+        LOG_ERROR("Unexpected order ", action, " response for ", order.clientOrderId, ": ", response);
+    }
+    return false;
+}
+
+void OrderManager::applyAck(const OrderAck& ack, const std::string& symbol, const std::string& side) {
+    Decimal filled;
+    if (tracker.apply(ack, &filled) && filled > Decimal()) risk.recordFill(symbol, side == "BUY", filled);
 }
 
 std::string OrderManager::getAccountInfo() {
     return api.send_signed_request("/api/v3/account", "");
 }
 
-double OrderManager::getCurrentPrice(const std::string& symbol) {
-    std::string response = api.send_public_request("/api/v3/ticker/price?symbol=" + symbol);
-    
-    try {
-        json j = json::parse(response);
-        return std::stod(j["price"].get<std::string>());
-    } catch (const std::exception& e) {
-        std::cerr << "Error parsing price: " << e.what() << std::endl;
-        return 0.0;
+bool OrderManager::getAccountBalances(AccountBalances& balances) {
+    std::string response = getAccountInfo();
+    if (decodeAccountBalances(response, balances)) return true;
+
+    ApiError error;
+    if (decodeApiError(response, error)) {
+        LOG_ERROR("Error getting account info: ", error.code, " ", error.msg);
+    } else {
+        LOG_ERROR("Error parsing account info");
     }
+    return false;
+}
+
+double OrderManager::getCurrentPrice(const std::string& symbol) {
+    // Shared with every other caller; fetched only when the cached one is stale
+    PriceQuote quote;
+    if (!MarketDataCache::getInstance().lastPrice(api, symbol, quote)) return 0.0;
+    return quote.price;
 }
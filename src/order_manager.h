@@ -1,7 +1,14 @@
 #pragma once
+#include <chrono>
 #include <string>
+#include <vector>
 #include "api.h"
 #include "config/config.h"
+#include "response_decoder.h"
+#include "order_tracker.h"
+#include "pre_trade_risk.h"
+
+class OrderBookFeed;
 
 class OrderManager {
 private:
@@ -10,19 +17,49 @@ private:
     std::string api_key;
     std::string api_secret;
     std::string base_url;
+    const OrderBookFeed* orderBook;  // local books for the slippage check, may be null
+    double maxSlippage;     // percent a market order may fill away from the touch (max_slippage)
+    OrderTracker tracker;   // every order sent, by clientOrderId
+    std::chrono::seconds closedRetention;  // how long final orders stay tracked (closed_order_retention)
+    PreTradeRisk risk;      // exchange filters and our limits, checked before sending
     
     // Helper methods
-    bool validateOrder(const std::string& symbol, 
-                      const std::string& side, 
-                      const std::string& type, 
-                      double quantity, 
-                      double price) const;
+    // False if the local book shows a market order would fill too far away
+    bool checkSlippage(const std::string& symbol, const std::string& side, double quantity) const;
+    // Market price for the pre-trade check from data already in memory: the
+    // cached last price, else the mid of the local book or cached book
+    // ticker; 0 if there is none. Never sends a request.
+    double referencePrice(const std::string& symbol) const;
+    // Track, send and apply the reply; the clientOrderId, "" if not sent
+    std::string sendOrder(const std::string& symbol,
+                          const std::string& side,
+                          const std::string& type,
+                          double quantity,
+                          double price);
+    // Apply a query or cancel reply to the tracked order
+    bool applyResponse(const TrackedOrder& order, const std::string& response, const char* action);
+    // Update the tracker, and the risk position with what the update filled
+    void applyAck(const OrderAck& ack, const std::string& symbol, const std::string& side);
 
 public:
     // Declare constructor (but don't define it here)
     OrderManager();
+
+    // Check market orders against these books before sending them
+    void attachOrderBook(const OrderBookFeed& books) { orderBook = &books; }
+
+    // Fetch the exchange filters of the symbols we trade up front; orders
+    // are never held up by the request, so until a symbol's filters are
+    // loaded its orders are rejected
+    bool loadSymbolFilters(const std::vector<std::string>& symbols) { return risk.loadFilters(api, symbols); }
+    bool hasSymbolFilters(const std::string& symbol) const { return risk.hasFilters(symbol); }
+    PreTradeRisk::Stats getRiskStats() const { return risk.getStats(); }
     
-    // Place orders
+    // Place orders. Each passes the pre-trade check, which rounds quantity
+    // and price to the symbol's filters, is sent with a generated
+    // newClientOrderId and tracked from then on; they return that id ("" if
+    // the order was not sent) for findOrder(), cancelOrder() and
+    // refreshOrder().
     std::string place_order(const std::string& symbol, 
                            const std::string& side, 
                            const std::string& type, 
@@ -37,9 +74,21 @@ public:
                                const std::string& side, 
                                double quantity, 
                                double price);
+
+    // Cancel an open order; false if it is not tracked or the exchange refused
+    bool cancelOrder(const std::string& clientOrderId);
+
+    // Ask the exchange for the order's state, e.g. after a lost reply
+    bool refreshOrder(const std::string& clientOrderId);
+
+    // From the tracker, without a request
+    bool findOrder(const std::string& clientOrderId, TrackedOrder& order) const { return tracker.find(clientOrderId, order); }
+    std::vector<TrackedOrder> getOpenOrders(const std::string& symbol = "") const { return tracker.openOrders(symbol); }
+    OrderTracker::Stats getOrderStats() const { return tracker.getStats(); }
     
     // Get account information
     std::string getAccountInfo();
+    bool getAccountBalances(AccountBalances& balances);  // non-zero balances only
     
     // Get current price for a symbol
     double getCurrentPrice(const std::string& symbol);
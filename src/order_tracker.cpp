@@ -0,0 +1,238 @@
+// order_tracker.cpp
+#include "order_tracker.h"
+#include <algorithm>
+#include <cctype>
+#include <functional>
+#include <mutex>
+#include "config/config.h"
+#include "logger.h"
+
+const char* orderStatusName(OrderStatus status) {
+    switch (status) {
+        case OrderStatus::PendingNew: return "PENDING_NEW";
+        case OrderStatus::New: return "NEW";
+        case OrderStatus::PartiallyFilled: return "PARTIALLY_FILLED";
+        case OrderStatus::Filled: return "FILLED";
+        case OrderStatus::Canceled: return "CANCELED";
+        case OrderStatus::Rejected: return "REJECTED";
+        case OrderStatus::Expired: return "EXPIRED";
+    }
+    return "";
+}
+
+bool parseOrderStatus(std::string_view name, OrderStatus& status) {
+    if (name == "NEW") status = OrderStatus::New;
+    else if (name == "PARTIALLY_FILLED") status = OrderStatus::PartiallyFilled;
+    else if (name == "FILLED") status = OrderStatus::Filled;
+    else if (name == "CANCELED") status = OrderStatus::Canceled;
+    else if (name == "REJECTED") status = OrderStatus::Rejected;
+    else if (name == "EXPIRED" || name == "EXPIRED_IN_MATCH") status = OrderStatus::Expired;
+    else if (name == "PENDING_NEW") status = OrderStatus::PendingNew;
+    else return false;
+    return true;
+}
+
+// Order of the states; an update may not lower it
+static int stage(OrderStatus status) {
+    switch (status) {
+        case OrderStatus::PendingNew: return 0;
+        case OrderStatus::New: return 1;
+        case OrderStatus::PartiallyFilled: return 2;
+        default: return 3;
+    }
+}
+
+static std::string base36(uint64_t value) {
+    const char* digits = "0123456789abcdefghijklmnopqrstuvwxyz";
+    std::string text;
+    do {
+        text.insert(text.begin(), digits[value % 36]);
+        value /= 36;
+    } while (value > 0);
+    return text;
+}
+
+OrderTracker::OrderTracker()
+    : byClientId(INITIAL_SLOTS, Slot{0, EMPTY})
+    , byOrderId(INITIAL_SLOTS, Slot{0, EMPTY})
+    , nextId(1) {
+    // Only characters the exchange accepts in a clientOrderId
+    std::string prefix;
+    for (char c : Config::getInstance().getSetting("client_order_prefix", "bot")) {
+        if (std::isalnum(static_cast<unsigned char>(c)) || c == '_' || c == '-') prefix += c;
+    }
+    prefix = prefix.substr(0, 16);
+    int64_t startMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    idPrefix = prefix + "-" + base36(startMs) + "-";
+}
+
+std::string OrderTracker::nextClientOrderId() {
+    return idPrefix + base36(nextId.fetch_add(1, std::memory_order_relaxed));
+}
+
+uint32_t OrderTracker::hashOf(std::string_view clientOrderId) {
+    size_t hash = std::hash<std::string_view>()(clientOrderId);
+    return static_cast<uint32_t>(hash ^ (hash >> 32));
+}
+
+uint32_t OrderTracker::hashOf(int64_t orderId) {
+    // Exchange ids are sequential; mix them so they spread over the table
+    uint64_t x = static_cast<uint64_t>(orderId) + 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return static_cast<uint32_t>(x ^ (x >> 31));
+}
+
+int32_t OrderTracker::findClient(std::string_view clientOrderId) const {
+    uint32_t hash = hashOf(clientOrderId);
+    size_t mask = byClientId.size() - 1;
+    for (size_t i = hash & mask; byClientId[i].position != EMPTY; i = (i + 1) & mask) {
+        const Slot& slot = byClientId[i];
+        if (slot.hash == hash && orders[slot.position].clientOrderId == clientOrderId) return slot.position;
+    }
+    return EMPTY;
+}
+
+int32_t OrderTracker::findExchange(int64_t orderId) const {
+    uint32_t hash = hashOf(orderId);
+    size_t mask = byOrderId.size() - 1;
+    for (size_t i = hash & mask; byOrderId[i].position != EMPTY; i = (i + 1) & mask) {
+        const Slot& slot = byOrderId[i];
+        if (slot.hash == hash && orders[slot.position].orderId == orderId) return slot.position;
+    }
+    return EMPTY;
+}
+
+// The tables are kept at most 70% full, so a free slot is always found
+void OrderTracker::insert(std::vector<Slot>& index, uint32_t hash, int32_t position) {
+    size_t mask = index.size() - 1;
+    size_t i = hash & mask;
+    while (index[i].position != EMPTY) i = (i + 1) & mask;
+    index[i] = Slot{hash, position};
+}
+
+void OrderTracker::rebuild(size_t slots) {
+    byClientId.assign(slots, Slot{0, EMPTY});
+    byOrderId.assign(slots, Slot{0, EMPTY});
+    for (size_t i = 0; i < orders.size(); i++) {
+        insert(byClientId, hashOf(orders[i].clientOrderId), static_cast<int32_t>(i));
+        if (orders[i].orderId != 0) insert(byOrderId, hashOf(orders[i].orderId), static_cast<int32_t>(i));
+    }
+}
+
+bool OrderTracker::add(TrackedOrder order) {
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    if (findClient(order.clientOrderId) != EMPTY) {
+        LOG_ERROR("Order ", order.clientOrderId, " is already tracked");
+        return false;
+    }
+    if ((orders.size() + 1) * 10 > byClientId.size() * 7) rebuild(byClientId.size() * 2);
+
+    order.created = order.updated = std::chrono::steady_clock::now();
+    int32_t position = static_cast<int32_t>(orders.size());
+    insert(byClientId, hashOf(order.clientOrderId), position);
+    if (order.orderId != 0) insert(byOrderId, hashOf(order.orderId), position);
+    orders.push_back(std::move(order));
+    return true;
+}
+
+bool OrderTracker::apply(const OrderAck& update, Decimal* filled) {
+    // A cancel reply names the canceled order in origClientOrderId
+    const std::string& clientOrderId = update.origClientOrderId.empty() ? update.clientOrderId
+                                                                        : update.origClientOrderId;
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    int32_t position = clientOrderId.empty() ? EMPTY : findClient(clientOrderId);
+    if (position == EMPTY && update.orderId != 0) position = findExchange(update.orderId);
+    if (position == EMPTY) {
+        stats.unknown++;
+        return false;
+    }
+
+    TrackedOrder& order = orders[position];
+    OrderStatus status = order.status;
+    parseOrderStatus(update.status, status);
+    // The same ack twice, e.g. the order response and its execution report
+    if (status == order.status && update.executedQty == order.executedQty &&
+        (update.orderId == 0 || update.orderId == order.orderId)) {
+        return false;
+    }
+    if (!order.isOpen() || stage(status) < stage(order.status) || update.executedQty < order.executedQty) {
+        stats.stale++;
+        return false;
+    }
+
+    if (order.orderId == 0 && update.orderId != 0) {
+        order.orderId = update.orderId;
+        insert(byOrderId, hashOf(order.orderId), position);
+    }
+    if (status != order.status) {
+        LOG_DEBUG("Order ", order.clientOrderId, " ", orderStatusName(order.status), " -> ", orderStatusName(status));
+    }
+    order.status = status;
+    if (filled) *filled = update.executedQty - order.executedQty;
+    order.executedQty = update.executedQty;
+    order.cummulativeQuoteQty = update.cummulativeQuoteQty;
+    if (!update.origQty.isZero()) order.quantity = update.origQty;
+    if (update.updateTime > 0) order.updateTime = update.updateTime;
+    order.updated = std::chrono::steady_clock::now();
+    stats.applied++;
+    return true;
+}
+
+bool OrderTracker::reject(const std::string& clientOrderId) {
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    int32_t position = findClient(clientOrderId);
+    if (position == EMPTY || !orders[position].isOpen()) return false;
+    orders[position].status = OrderStatus::Rejected;
+    orders[position].updated = std::chrono::steady_clock::now();
+    stats.applied++;
+    return true;
+}
+
+bool OrderTracker::find(const std::string& clientOrderId, TrackedOrder& out) const {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    int32_t position = findClient(clientOrderId);
+    if (position == EMPTY) return false;
+    out = orders[position];
+    return true;
+}
+
+bool OrderTracker::findByOrderId(int64_t orderId, TrackedOrder& out) const {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    int32_t position = findExchange(orderId);
+    if (position == EMPTY) return false;
+    out = orders[position];
+    return true;
+}
+
+std::vector<TrackedOrder> OrderTracker::openOrders(const std::string& symbol) const {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    std::vector<TrackedOrder> result;
+    for (const TrackedOrder& order : orders) {
+        if (order.isOpen() && (symbol.empty() || order.symbol == symbol)) result.push_back(order);
+    }
+    return result;
+}
+
+size_t OrderTracker::removeClosed(std::chrono::steady_clock::duration age) {
+    std::chrono::steady_clock::time_point cutoff = std::chrono::steady_clock::now() - age;
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    size_t before = orders.size();
+    orders.erase(std::remove_if(orders.begin(), orders.end(), [cutoff](const TrackedOrder& order) {
+        return !order.isOpen() && order.updated < cutoff;
+    }), orders.end());
+    size_t removed = before - orders.size();
+    if (removed > 0) rebuild(byClientId.size());
+    return removed;
+}
+
+OrderTracker::Stats OrderTracker::getStats() const {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    Stats result = stats;
+    result.tracked = orders.size();
+    for (const TrackedOrder& order : orders) {
+        if (order.isOpen()) result.open++;
+    }
+    return result;
+}
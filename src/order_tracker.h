@@ -0,0 +1,125 @@
+// order_tracker.h
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "response_decoder.h"
+
+// Order lifecycle as the exchange reports it, plus PendingNew for an order
+// that was sent but not acknowledged yet. Filled, Canceled, Rejected and
+// Expired are final.
+enum class OrderStatus : uint8_t { PendingNew, New, PartiallyFilled, Filled, Canceled, Rejected, Expired };
+
+const char* orderStatusName(OrderStatus status);
+
+// Exchange spelling ("NEW", "PARTIALLY_FILLED", ...); false for statuses
+// that leave the state alone (PENDING_CANCEL) and unknown ones
+bool parseOrderStatus(std::string_view name, OrderStatus& status);
+
+struct TrackedOrder {
+    std::string clientOrderId;     // newClientOrderId we sent
+    int64_t orderId = 0;           // exchange id, 0 until acknowledged
+    std::string symbol;
+    std::string side;              // BUY or SELL
+    std::string type;              // MARKET or LIMIT
+    Decimal price;                 // limit price, 0 for market orders
+    Decimal quantity;
+    Decimal executedQty;
+    Decimal cummulativeQuoteQty;
+    OrderStatus status = OrderStatus::PendingNew;
+    int64_t updateTime = 0;        // exchange ms of the last update applied
+    std::chrono::steady_clock::time_point created;
+    std::chrono::steady_clock::time_point updated;
+
+    bool isOpen() const {
+        return status == OrderStatus::PendingNew || status == OrderStatus::New ||
+               status == OrderStatus::PartiallyFilled;
+    }
+    double averagePrice() const {
+        return executedQty.isZero() ? 0 : cummulativeQuoteQty.toDouble() / executedQty.toDouble();
+    }
+};
+
+// Every order this process sent, keyed by clientOrderId and, once the
+// exchange acknowledged it, by orderId. Updates come from order responses
+// (place, query, cancel) or execution reports, decoded as OrderAck; one that
+// would move an order backwards (a lower status or less filled than already
+// seen, as when replies arrive out of order) is counted and ignored.
+//
+// Orders live in one vector; the two indexes are open-addressing tables of
+// (hash, position) slots probed linearly, so lookups touch one or two cache
+// lines and never allocate. Thread-safe: lookups share a reader lock,
+// updates take it exclusively.
+//
+// Setting (config.json, optional):
+//   client_order_prefix   start of generated clientOrderIds (default "bot")
+class OrderTracker {
+public:
+    struct Stats {
+        size_t tracked = 0;
+        size_t open = 0;
+        uint64_t applied = 0;      // updates that changed an order
+        uint64_t stale = 0;        // updates older than what was seen
+        uint64_t unknown = 0;      // updates for orders not tracked here
+    };
+
+    OrderTracker();
+
+    OrderTracker(const OrderTracker&) = delete;
+    OrderTracker& operator=(const OrderTracker&) = delete;
+
+    // newClientOrderId for the next order: prefix, start time and a counter,
+    // unique across restarts and at most 36 characters as the exchange requires
+    std::string nextClientOrderId();
+
+    // Start tracking an order about to be sent; false if its id is taken
+    bool add(TrackedOrder order);
+
+    // Order response or execution report; false if it changed nothing,
+    // including a duplicate (same status, executedQty and orderId), which is
+    // not counted. `filled` gets the quantity this update executed, when given.
+    bool apply(const OrderAck& update, Decimal* filled = nullptr);
+
+    // The exchange refused the order outright
+    bool reject(const std::string& clientOrderId);
+
+    bool find(const std::string& clientOrderId, TrackedOrder& out) const;
+    bool findByOrderId(int64_t orderId, TrackedOrder& out) const;
+
+    // Open orders, of one symbol or all
+    std::vector<TrackedOrder> openOrders(const std::string& symbol = "") const;
+
+    // Forget final orders last updated longer ago than `age`; returns how many
+    size_t removeClosed(std::chrono::steady_clock::duration age);
+
+    Stats getStats() const;
+
+private:
+    struct Slot {
+        uint32_t hash;
+        int32_t position;          // into orders, EMPTY if unused
+    };
+    static constexpr int32_t EMPTY = -1;
+    static constexpr size_t INITIAL_SLOTS = 64;   // power of two
+
+    static uint32_t hashOf(std::string_view clientOrderId);
+    static uint32_t hashOf(int64_t orderId);
+
+    int32_t findClient(std::string_view clientOrderId) const;
+    int32_t findExchange(int64_t orderId) const;
+    void insert(std::vector<Slot>& index, uint32_t hash, int32_t position);
+    void rebuild(size_t slots);
+
+    mutable std::shared_mutex mutex;
+    std::vector<TrackedOrder> orders;
+    std::vector<Slot> byClientId;
+    std::vector<Slot> byOrderId;
+    Stats stats;                   // counters only; sizes are computed
+
+    std::string idPrefix;          // prefix and start time
+    std::atomic<uint64_t> nextId;
+};
@@ -0,0 +1,196 @@
+// pre_trade_risk.cpp
+#include "pre_trade_risk.h"
+#include "api.h"
+#include "config/config.h"
+#include "logger.h"
+
+const char* riskRejectName(RiskReject reason) {
+    switch (reason) {
+        case RiskReject::None: return "none";
+        case RiskReject::UnknownSymbol: return "unknown symbol";
+        case RiskReject::NotTrading: return "symbol not trading";
+        case RiskReject::QuantityTooSmall: return "quantity too small";
+        case RiskReject::QuantityTooLarge: return "quantity too large";
+        case RiskReject::PriceOutOfRange: return "price out of range";
+        case RiskReject::PercentPrice: return "price too far from market";
+        case RiskReject::NoReferencePrice: return "no reference price";
+        case RiskReject::NotionalTooSmall: return "notional too small";
+        case RiskReject::NotionalTooLarge: return "notional too large";
+        case RiskReject::MaxPosition: return "position limit";
+        case RiskReject::OrderRate: return "order rate limit";
+        case RiskReject::Count: break;
+    }
+    return "?";
+}
+
+PreTradeRisk::PreTradeRisk() {
+    const Config& config = Config::getInstance();
+    if (!Decimal::parse(config.getSetting("min_order_size", "10.0"), minOrderSize)) {
+        LOG_ERROR("Invalid min_order_size, using 10");
+        minOrderSize = Decimal::fromInteger(10);
+    }
+    if (!Decimal::parse(config.getSetting("max_position", "0"), maxPosition)) {
+        LOG_ERROR("Invalid max_position, not limiting the position");
+        maxPosition = Decimal();
+    }
+    maxOrderRate = std::stoul(config.getSetting("max_order_rate", "0"));
+    recentOrders.reserve(maxOrderRate);
+}
+
+bool PreTradeRisk::loadFilters(BinanceAPI& api, const std::vector<std::string>& symbolNames) {
+    bool ok = true;
+    for (const std::string& symbol : symbolNames) {
+        std::string response = api.send_public_request("/api/v3/exchangeInfo?symbol=" + symbol);
+        std::vector<SymbolInfo> infos;
+        if (!decodeExchangeInfo(response, infos) || infos.empty()) {
+            LOG_ERROR("Error loading exchange filters of ", symbol, ": ", response);
+            ok = false;
+            continue;
+        }
+        for (const SymbolInfo& info : infos) {
+            setFilters(info);
+            LOG_INFO("Filters ", info.symbol, " (", info.status, "): tick ", info.tickSize.text(), ", step ",
+                     info.stepSize.text(), ", qty ", info.minQty.text(), "..", info.maxQty.text(), ", min notional ",
+                     info.minNotional.text());
+        }
+    }
+    return ok;
+}
+
+void PreTradeRisk::setFilters(const SymbolInfo& info) {
+    std::lock_guard<std::mutex> lock(mutex);
+    SymbolFilters& filters = symbols[info.symbol];   // keeps the position of a reload
+    filters.trading = info.status == "TRADING";
+    filters.tickSize = info.tickSize;
+    filters.minPrice = info.minPrice;
+    filters.maxPrice = info.maxPrice;
+    filters.stepSize = info.stepSize;
+    filters.minQty = info.minQty;
+    filters.maxQty = info.maxQty;
+    filters.marketStepSize = info.marketStepSize;
+    filters.marketMinQty = info.marketMinQty;
+    filters.marketMaxQty = info.marketMaxQty;
+    filters.minNotional = info.minNotional;
+    filters.maxNotional = info.maxNotional;
+    filters.minNotionalMarket = info.minNotionalMarket;
+    filters.maxNotionalMarket = info.maxNotionalMarket;
+    filters.bidUp = info.bidMultiplierUp;
+    filters.bidDown = info.bidMultiplierDown;
+    filters.askUp = info.askMultiplierUp;
+    filters.askDown = info.askMultiplierDown;
+    filters.priceDecimals = Decimal::decimalsOf(filters.tickSize);
+    filters.quantityDecimals = Decimal::decimalsOf(filters.stepSize);
+    stats.symbols = symbols.size();
+}
+
+bool PreTradeRisk::hasFilters(const std::string& symbol) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return symbols.count(symbol) > 0;
+}
+
+RiskCheck PreTradeRisk::check(const std::string& symbol, bool buy, bool market, Decimal quantity, Decimal price,
+                              double referencePrice) {
+    Clock::time_point now = Clock::now();
+    RiskCheck result;
+    std::lock_guard<std::mutex> lock(mutex);
+    stats.checked++;
+    auto it = symbols.find(symbol);
+    result.reject = it == symbols.end() ? RiskReject::UnknownSymbol
+                                        : evaluate(it->second, buy, market, quantity, price, referencePrice, result, now);
+    if (result.ok()) stats.passed++;
+    else stats.rejected[static_cast<size_t>(result.reject)]++;
+    return result;
+}
+
+// Called locked
+RiskReject PreTradeRisk::evaluate(SymbolFilters& filters, bool buy, bool market, Decimal quantity, Decimal price,
+                                  double referencePrice, RiskCheck& result, Clock::time_point now) {
+    if (!filters.trading) return RiskReject::NotTrading;
+    result.quantityDecimals = filters.quantityDecimals;
+    result.priceDecimals = filters.priceDecimals;
+
+    // LOT_SIZE, plus MARKET_LOT_SIZE where the exchange sets it
+    const Decimal zero;
+    Decimal step = market && filters.marketStepSize > zero ? filters.marketStepSize : filters.stepSize;
+    Decimal qty = step > zero ? quantity.roundDown(step) : quantity;
+    if (qty <= zero || qty < filters.minQty || (market && qty < filters.marketMinQty)) {
+        return RiskReject::QuantityTooSmall;
+    }
+    if ((filters.maxQty > zero && qty > filters.maxQty) ||
+        (market && filters.marketMaxQty > zero && qty > filters.marketMaxQty)) {
+        return RiskReject::QuantityTooLarge;
+    }
+    result.quantity = qty;
+
+    if (!market) {
+        // PRICE_FILTER; rounding never makes the order more aggressive
+        Decimal rounded = price;
+        if (filters.tickSize > zero) rounded = buy ? price.roundDown(filters.tickSize) : price.roundUp(filters.tickSize);
+        if (rounded <= zero || rounded < filters.minPrice || (filters.maxPrice > zero && rounded > filters.maxPrice)) {
+            return RiskReject::PriceOutOfRange;
+        }
+        result.price = rounded;
+
+        // PERCENT_PRICE; the exchange compares with its average price, the
+        // reference is the closest we have
+        double up = buy ? filters.bidUp : filters.askUp;
+        double down = buy ? filters.bidDown : filters.askDown;
+        double limit = rounded.toDouble();
+        if (up > 0 || down > 0) {
+            if (referencePrice <= 0) return RiskReject::NoReferencePrice;
+            if ((up > 0 && limit > referencePrice * up) || (down > 0 && limit < referencePrice * down)) {
+                return RiskReject::PercentPrice;
+            }
+        }
+    }
+
+    // MIN_NOTIONAL / NOTIONAL, which market orders only get when applyToMarket says so
+    Decimal minNotional = !market || filters.minNotionalMarket ? filters.minNotional : zero;
+    Decimal maxNotional = !market || filters.maxNotionalMarket ? filters.maxNotional : zero;
+    if (minOrderSize > minNotional) minNotional = minOrderSize;
+    if (minNotional > zero || maxNotional > zero) {
+        Decimal notionalPrice = market ? Decimal::fromDouble(referencePrice) : result.price;
+        if (notionalPrice <= zero) return RiskReject::NoReferencePrice;
+        Decimal notional = qty * notionalPrice;
+        if (notional < minNotional) return RiskReject::NotionalTooSmall;
+        if (maxNotional > zero && notional > maxNotional) return RiskReject::NotionalTooLarge;
+    }
+
+    // An order that reduces the position always passes
+    if (maxPosition > zero) {
+        Decimal after = buy ? filters.position + qty : filters.position - qty;
+        Decimal size = after < zero ? -after : after;
+        Decimal current = filters.position < zero ? -filters.position : filters.position;
+        if (size > maxPosition && size > current) return RiskReject::MaxPosition;
+    }
+
+    if (maxOrderRate > 0) {
+        if (recentOrders.size() < maxOrderRate) {
+            recentOrders.push_back(now);
+        } else {
+            // The oldest of the last maxOrderRate must be a second old
+            if (now - recentOrders[nextOrder] < std::chrono::seconds(1)) return RiskReject::OrderRate;
+            recentOrders[nextOrder] = now;
+        }
+        nextOrder = (nextOrder + 1) % maxOrderRate;
+    }
+    return RiskReject::None;
+}
+
+void PreTradeRisk::recordFill(const std::string& symbol, bool buy, Decimal quantity) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = symbols.find(symbol);
+    if (it == symbols.end()) return;
+    it->second.position += buy ? quantity : -quantity;
+}
+
+Decimal PreTradeRisk::position(const std::string& symbol) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = symbols.find(symbol);
+    return it == symbols.end() ? Decimal() : it->second.position;
+}
+
+PreTradeRisk::Stats PreTradeRisk::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return stats;
+}
@@ -0,0 +1,130 @@
+// pre_trade_risk.h
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "response_decoder.h"
+
+class BinanceAPI;
+
+enum class RiskReject : uint8_t {
+    None,
+    UnknownSymbol,      // no filters loaded
+    NotTrading,         // symbol status is not TRADING
+    QuantityTooSmall,   // below minQty, or rounded down to nothing
+    QuantityTooLarge,
+    PriceOutOfRange,    // outside minPrice..maxPrice
+    PercentPrice,       // too far from the reference price
+    NoReferencePrice,   // a market order's notional or PERCENT_PRICE cannot be checked
+    NotionalTooSmall,
+    NotionalTooLarge,
+    MaxPosition,
+    OrderRate,
+    Count
+};
+
+const char* riskRejectName(RiskReject reason);
+
+// Outcome of a check; quantity and price are rounded to the symbol's step
+// and tick and are what should be sent, with that many decimals
+struct RiskCheck {
+    RiskReject reject = RiskReject::None;
+    Decimal quantity;
+    Decimal price;             // 0 for market orders
+    int quantityDecimals = 8;
+    int priceDecimals = 8;
+
+    bool ok() const { return reject == RiskReject::None; }
+};
+
+// Checks an order against the exchange filters of its symbol and our own
+// limits before it is sent, so the exchange has nothing to reject. The steps
+// run in the exchange's order: round the quantity down to the step size and
+// the price to the tick (down for a buy, up for a sell, so the order never
+// gets more aggressive), then LOT_SIZE (and MARKET_LOT_SIZE for market
+// orders), PRICE_FILTER, PERCENT_PRICE against the reference price, the
+// notional against MIN_NOTIONAL/NOTIONAL and min_order_size, the filled
+// position and the order rate.
+//
+// Filters are fetched once per symbol from /api/v3/exchangeInfo and kept as
+// Decimal, so rounding and range checks are exact integer arithmetic; a
+// check does no allocation or I/O. Thread-safe.
+//
+// Settings (config.json, all optional):
+//   min_order_size   smallest notional in quote asset we send (default 10.0)
+//   max_position     largest filled position per symbol in base asset, either
+//                    side (default 0, no limit)
+//   max_order_rate   orders accepted per second (default 0, no limit)
+class PreTradeRisk {
+public:
+    struct Stats {
+        uint64_t checked = 0;
+        uint64_t passed = 0;
+        uint64_t rejected[static_cast<size_t>(RiskReject::Count)] = {};
+        size_t symbols = 0;
+    };
+
+    PreTradeRisk();
+
+    // Fetch and store the filters of `symbols` (weight 20 each); false if
+    // any failed
+    bool loadFilters(BinanceAPI& api, const std::vector<std::string>& symbols);
+    void setFilters(const SymbolInfo& info);
+    bool hasFilters(const std::string& symbol) const;
+
+    // `referencePrice` is the current market price, 0 if unknown; it is
+    // needed for market orders and for limit orders of symbols with a
+    // percent price filter
+    RiskCheck check(const std::string& symbol, bool buy, bool market, Decimal quantity, Decimal price,
+                    double referencePrice);
+
+    // Executed quantity of our orders, to keep the position limit
+    void recordFill(const std::string& symbol, bool buy, Decimal quantity);
+    Decimal position(const std::string& symbol) const;
+
+    Stats getStats() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    // exchangeInfo filters of one symbol, 0 when unset
+    struct SymbolFilters {
+        bool trading = false;
+        Decimal tickSize;
+        Decimal minPrice;
+        Decimal maxPrice;
+        Decimal stepSize;
+        Decimal minQty;
+        Decimal maxQty;
+        Decimal marketStepSize;
+        Decimal marketMinQty;
+        Decimal marketMaxQty;
+        Decimal minNotional;
+        Decimal maxNotional;
+        bool minNotionalMarket = false;
+        bool maxNotionalMarket = false;
+        double bidUp = 0;           // percent price multipliers, 0 when unset
+        double bidDown = 0;
+        double askUp = 0;
+        double askDown = 0;
+        int priceDecimals = 8;
+        int quantityDecimals = 8;
+        Decimal position;           // filled, base asset, negative when short
+    };
+
+    RiskReject evaluate(SymbolFilters& filters, bool buy, bool market, Decimal quantity, Decimal price,
+                        double referencePrice, RiskCheck& result, Clock::time_point now);
+
+    Decimal minOrderSize;
+    Decimal maxPosition;
+    size_t maxOrderRate;
+
+    mutable std::mutex mutex;
+    std::unordered_map<std::string, SymbolFilters> symbols;
+    std::vector<Clock::time_point> recentOrders;   // ring of the last maxOrderRate accepted
+    size_t nextOrder = 0;
+    Stats stats;
+};
@@ -0,0 +1,202 @@
+// rate_limiter.cpp
+#include "rate_limiter.h"
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+
+static bool equalsIgnoreCase(std::string_view a, std::string_view b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); i++) {
+        if (std::tolower(static_cast<unsigned char>(a[i])) != std::tolower(static_cast<unsigned char>(b[i]))) return false;
+    }
+    return true;
+}
+
+// Value of `key` in "a=1&b=2", empty if absent
+static std::string_view queryParam(std::string_view query, std::string_view key) {
+    while (!query.empty()) {
+        size_t end = query.find('&');
+        std::string_view pair = query.substr(0, end);
+        if (pair.size() > key.size() && pair.compare(0, key.size(), key) == 0 && pair[key.size()] == '=') {
+            return pair.substr(key.size() + 1);
+        }
+        if (end == std::string_view::npos) break;
+        query.remove_prefix(end + 1);
+    }
+    return {};
+}
+
+RequestCost requestCost(std::string_view method, std::string_view endpoint) {
+    size_t queryStart = endpoint.find('?');
+    std::string_view path = endpoint.substr(0, queryStart);
+    std::string_view query = queryStart == std::string_view::npos ? std::string_view() : endpoint.substr(queryStart + 1);
+    bool oneSymbol = !queryParam(query, "symbol").empty();
+
+    RequestCost cost;
+    if (path == "/api/v3/order" || path == "/api/v3/order/cancelReplace") {
+        if (method == "GET") {
+            cost.weight = 4;
+            cost.priority = RequestPriority::Account;
+        } else {
+            cost.countsOrder = method == "POST";
+            cost.priority = RequestPriority::Order;
+        }
+    } else if (path == "/api/v3/order/test") {
+        cost.priority = RequestPriority::Order;
+    } else if (path == "/api/v3/openOrders") {
+        if (method == "DELETE") {
+            cost.priority = RequestPriority::Order;
+        } else {
+            cost.weight = oneSymbol ? 6 : 80;
+            cost.priority = RequestPriority::Account;
+        }
+    } else if (path == "/api/v3/account" || path == "/api/v3/myTrades" || path == "/api/v3/allOrders") {
+        cost.weight = 20;
+        cost.priority = RequestPriority::Account;
+    } else if (path == "/api/v3/ticker/price" || path == "/api/v3/ticker/bookTicker") {
+        cost.weight = oneSymbol ? 2 : 4;
+    } else if (path == "/api/v3/ticker/24hr") {
+        cost.weight = oneSymbol ? 2 : 80;
+    } else if (path == "/api/v3/depth") {
+        int limit = 100;
+        std::string_view text = queryParam(query, "limit");
+        std::from_chars(text.data(), text.data() + text.size(), limit);
+        cost.weight = limit <= 100 ? 5 : limit <= 500 ? 25 : limit <= 1000 ? 50 : 250;
+    } else if (path == "/api/v3/klines" || path == "/api/v3/uiKlines" || path == "/api/v3/avgPrice") {
+        cost.weight = 2;
+    } else if (path == "/api/v3/trades" || path == "/api/v3/historicalTrades") {
+        cost.weight = 25;
+    } else if (path == "/api/v3/exchangeInfo") {
+        cost.weight = 20;
+    }
+    return cost;
+}
+
+void RateLimiter::Bucket::refill(Clock::time_point now) {
+    if (now <= updated) return;
+    double elapsed = std::chrono::duration<double>(now - updated).count();
+    tokens = std::min(capacity, tokens + capacity * elapsed / interval.count());
+    updated = now;
+}
+
+RateLimiter::Clock::duration RateLimiter::Bucket::wait(double needed, Clock::time_point now) {
+    refill(now);
+    needed = std::min(needed, capacity);  // an oversized request waits for a full bucket
+    Clock::duration result = Clock::duration::zero();
+    if (now < windowEnd && windowLeft < needed) result = windowEnd - now;
+    if (tokens < needed) {
+        double seconds = (needed - tokens) * interval.count() / capacity;
+        result = std::max(result, std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(seconds)));
+    }
+    return result;
+}
+
+// End of the exchange window `now` falls in; windows start on multiples of
+// the interval in wall-clock time
+static RateLimiter::Clock::time_point windowEndAt(std::chrono::seconds interval, RateLimiter::Clock::time_point now) {
+    auto intoWindow = std::chrono::system_clock::now().time_since_epoch() % interval;
+    return now + (interval - intoWindow);
+}
+
+void RateLimiter::Bucket::take(double amount, Clock::time_point now) {
+    refill(now);
+    tokens -= amount;
+    if (now >= windowEnd) {
+        windowEnd = windowEndAt(interval, now);
+        windowLeft = capacity;
+    }
+    windowLeft -= amount;
+}
+
+void RateLimiter::Bucket::report(double used, Clock::time_point now) {
+    if (now >= windowEnd) {
+        // First response of a window nothing has been sent in yet
+        windowEnd = windowEndAt(interval, now);
+        windowLeft = capacity - used;
+        return;
+    }
+    // The local count may include requests still in flight that the
+    // exchange has not counted yet, so the header can only lower it
+    windowLeft = std::min(windowLeft, capacity - used);
+}
+
+RateLimiter::RateLimiter(const Limits& limits)
+    : weight{static_cast<double>(limits.weightPerMinute), std::chrono::seconds(60)}
+    , orders10s{static_cast<double>(limits.ordersPer10s), std::chrono::seconds(10)}
+    , ordersDay{static_cast<double>(limits.ordersPerDay), std::chrono::seconds(86400)}
+    , orderReserve(std::clamp(limits.orderReserve, 0.0, 0.9))
+    , lastReportedWeight(-1) {
+    Clock::time_point now = Clock::now();
+    for (Bucket* bucket : {&weight, &orders10s, &ordersDay}) {
+        bucket->capacity = std::max(1.0, bucket->capacity);
+        bucket->tokens = bucket->capacity;
+        bucket->updated = now;
+    }
+}
+
+RateLimiter::Clock::duration RateLimiter::delay(const RequestCost& cost, Clock::time_point now) {
+    Clock::duration result = pausedUntil > now ? pausedUntil - now : Clock::duration::zero();
+
+    // Everything but orders has to leave the reserve untouched
+    double needed = cost.weight;
+    if (cost.priority != RequestPriority::Order) needed += orderReserve * weight.capacity;
+    result = std::max(result, weight.wait(needed, now));
+
+    if (cost.countsOrder) {
+        result = std::max(result, orders10s.wait(1, now));
+        result = std::max(result, ordersDay.wait(1, now));
+    }
+    return result;
+}
+
+void RateLimiter::take(const RequestCost& cost, Clock::time_point now) {
+    weight.take(cost.weight, now);
+    if (cost.countsOrder) {
+        orders10s.take(1, now);
+        ordersDay.take(1, now);
+    }
+}
+
+// "1M" -> 60s, "10S" -> 10s, "1D" -> 86400s; zero when unparsable
+static std::chrono::seconds intervalLength(std::string_view text) {
+    long count = 0;
+    std::from_chars_result result = std::from_chars(text.data(), text.data() + text.size(), count);
+    if (result.ec != std::errc() || result.ptr != text.data() + text.size() - 1) return std::chrono::seconds(0);
+    switch (std::toupper(static_cast<unsigned char>(text.back()))) {
+        case 'S': return std::chrono::seconds(count);
+        case 'M': return std::chrono::seconds(count * 60);
+        case 'H': return std::chrono::seconds(count * 3600);
+        case 'D': return std::chrono::seconds(count * 86400);
+    }
+    return std::chrono::seconds(0);
+}
+
+void RateLimiter::observeHeader(std::string_view name, std::string_view value, Clock::time_point now) {
+    static constexpr std::string_view USED_WEIGHT = "x-mbx-used-weight-";
+    static constexpr std::string_view ORDER_COUNT = "x-mbx-order-count-";
+
+    Bucket* bucket = nullptr;
+    std::string_view interval;
+    if (name.size() > USED_WEIGHT.size() && equalsIgnoreCase(name.substr(0, USED_WEIGHT.size()), USED_WEIGHT)) {
+        interval = name.substr(USED_WEIGHT.size());
+        if (intervalLength(interval) == weight.interval) bucket = &weight;
+    } else if (name.size() > ORDER_COUNT.size() && equalsIgnoreCase(name.substr(0, ORDER_COUNT.size()), ORDER_COUNT)) {
+        interval = name.substr(ORDER_COUNT.size());
+        std::chrono::seconds length = intervalLength(interval);
+        if (length == orders10s.interval) bucket = &orders10s;
+        else if (length == ordersDay.interval) bucket = &ordersDay;
+    }
+    if (!bucket) return;
+
+    long used = 0;
+    while (!value.empty() && value.front() == ' ') value.remove_prefix(1);
+    std::from_chars_result result = std::from_chars(value.data(), value.data() + value.size(), used);
+    if (result.ec != std::errc()) return;
+
+    bucket->report(used, now);
+    if (bucket == &weight) lastReportedWeight = static_cast<int>(used);
+}
+
+void RateLimiter::pause(Clock::duration duration, Clock::time_point now) {
+    pausedUntil = std::max(pausedUntil, now + duration);
+}
@@ -0,0 +1,79 @@
+// rate_limiter.h
+#pragma once
+#include <chrono>
+#include <string_view>
+
+// Request classes in the order they are served. Cancels are Order too: they
+// must get out even when polling has used up the budget.
+enum class RequestPriority { Order = 0, Account = 1, MarketData = 2 };
+constexpr int REQUEST_PRIORITIES = 3;
+
+// What one REST call costs against the exchange limits
+struct RequestCost {
+    int weight = 1;              // REQUEST_WEIGHT units
+    bool countsOrder = false;    // new orders also count against the ORDERS limits
+    RequestPriority priority = RequestPriority::MarketData;
+};
+
+// Cost of `method` on `endpoint` ("/api/v3/depth?symbol=BTCUSDT&limit=500"),
+// from the exchange's published weights; unknown endpoints weigh 1
+RequestCost requestCost(std::string_view method, std::string_view endpoint);
+
+// Client-side copy of the exchange's rate limits as token buckets: request
+// weight per minute, orders per 10 seconds and orders per day. Buckets refill
+// continuously, but the exchange counts in fixed windows aligned to the clock,
+// so the X-MBX-USED-WEIGHT-* and X-MBX-ORDER-COUNT-* response headers also cap
+// a bucket at what is left of the current window (other processes on the same
+// IP or key included) until that window ends. A share of the weight budget is
+// held back for orders, so polling can never leave an order waiting on weight.
+// Not thread-safe; RequestScheduler serializes access.
+class RateLimiter {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Limits {
+        int weightPerMinute = 6000;
+        int ordersPer10s = 100;
+        int ordersPerDay = 200000;
+        double orderReserve = 0.2;   // share of the weight budget only orders may use
+    };
+
+    explicit RateLimiter(const Limits& limits);
+
+    // How long until a request of `cost` fits; zero means it may start now
+    Clock::duration delay(const RequestCost& cost, Clock::time_point now);
+
+    // Spend the tokens of a request that starts now
+    void take(const RequestCost& cost, Clock::time_point now);
+
+    // One response header; anything but the X-MBX usage headers is ignored
+    void observeHeader(std::string_view name, std::string_view value, Clock::time_point now);
+
+    // Hold every request back, e.g. for Retry-After after a 429 or 418
+    void pause(Clock::duration duration, Clock::time_point now);
+
+    // Weight the exchange last reported for the current minute, -1 if never
+    int reportedWeight() const { return lastReportedWeight; }
+
+private:
+    struct Bucket {
+        double capacity = 0;
+        std::chrono::seconds interval{0};
+        double tokens = 0;
+        Clock::time_point updated{};
+        double windowLeft = 0;           // exchange's count for the current window
+        Clock::time_point windowEnd{};
+
+        void refill(Clock::time_point now);
+        Clock::duration wait(double needed, Clock::time_point now);
+        void take(double amount, Clock::time_point now);
+        void report(double used, Clock::time_point now);
+    };
+
+    Bucket weight;
+    Bucket orders10s;
+    Bucket ordersDay;
+    double orderReserve;
+    Clock::time_point pausedUntil;
+    int lastReportedWeight;
+};
@@ -0,0 +1,115 @@
+// request_builder.cpp
+#include "request_builder.h"
+#include <charconv>
+#include <cstring>
+
+void RequestBuilder::clear() {
+    length = 0;
+    queryStart = 0;
+    overflow = false;
+    buffer[0] = '\0';
+}
+
+char* RequestBuilder::reserve(size_t n) {
+    if (overflow || CAPACITY - length < n) {
+        overflow = true;
+        return nullptr;
+    }
+    return buffer + length;
+}
+
+void RequestBuilder::append(std::string_view text) {
+    char* out = reserve(text.size());
+    if (!out) return;
+    std::memcpy(out, text.data(), text.size());
+    commit(out + text.size());
+}
+
+void RequestBuilder::separator() {
+    if (length > queryStart) append("&");
+}
+
+RequestBuilder& RequestBuilder::url(std::string_view base, std::string_view endpoint) {
+    clear();
+    append(base);
+    append(endpoint);
+    append("?");
+    queryStart = length;
+    return *this;
+}
+
+RequestBuilder& RequestBuilder::add(std::string_view key, std::string_view value) {
+    separator();
+    append(key);
+    append("=");
+    append(value);
+    return *this;
+}
+
+RequestBuilder& RequestBuilder::add(std::string_view key, int64_t value) {
+    separator();
+    append(key);
+    append("=");
+    char* out = reserve(20);
+    if (!out) return *this;
+    commit(std::to_chars(out, buffer + CAPACITY, value).ptr);
+    return *this;
+}
+
+RequestBuilder& RequestBuilder::add(std::string_view key, double value, int precision) {
+    separator();
+    append(key);
+    append("=");
+    char* out = reserve(1);
+    if (!out) return *this;
+    std::to_chars_result result = std::to_chars(out, buffer + CAPACITY, value, std::chars_format::fixed, precision);
+    if (result.ec != std::errc()) {
+        overflow = true;
+        return *this;
+    }
+    commit(result.ptr);
+    return *this;
+}
+
+RequestBuilder& RequestBuilder::add(std::string_view key, Decimal value, int decimals) {
+    separator();
+    append(key);
+    append("=");
+    char* out = reserve(1);
+    if (!out) return *this;
+    char* end = value.format(out, buffer + CAPACITY, decimals);
+    if (!end) {
+        overflow = true;
+        return *this;
+    }
+    commit(end);
+    return *this;
+}
+
+RequestBuilder& RequestBuilder::addQuery(std::string_view query) {
+    if (query.empty()) return *this;
+    separator();
+    if (query.back() == '&') query.remove_suffix(1);
+    append(query);
+    return *this;
+}
+
+RequestBuilder& RequestBuilder::addTimestamp(int64_t millis) {
+    return add("timestamp", millis);
+}
+
+bool RequestBuilder::sign(const HmacSigner& signer) {
+    static constexpr std::string_view SIGNATURE = "&signature=";
+    if (overflow) return false;
+    size_t queryLength = length - queryStart;
+
+    char* out = reserve(SIGNATURE.size() + HmacSigner::HEX_SIZE);
+    if (!out) return false;
+    std::memcpy(out, SIGNATURE.data(), SIGNATURE.size());
+    if (!signer.sign(buffer + queryStart, queryLength, out + SIGNATURE.size())) {
+        buffer[length] = '\0';
+        return false;
+    }
+    commit(out + SIGNATURE.size() + HmacSigner::HEX_SIZE);
+    return true;
+}
@@ -0,0 +1,59 @@
+// request_builder.h
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include "decimal.h"
+#include "hmac_signer.h"
+
+// Fixed-capacity builder for a request URL ("<base><endpoint>?<query>") in
+// an inline buffer, so building and signing an order never touches the heap.
+// Values are formatted with std::to_chars; the timestamp and signature are
+// appended in place and c_str() can be handed to curl as is. Appends past
+// the capacity are dropped and flagged; check ok() before sending.
+class RequestBuilder {
+public:
+    static constexpr size_t CAPACITY = 2048;
+
+    RequestBuilder() { clear(); }
+
+    void clear();
+
+    // URL part: base and endpoint, then '?' to start the query
+    RequestBuilder& url(std::string_view base, std::string_view endpoint);
+
+    // Query parameters ("key=value", '&'-separated)
+    RequestBuilder& add(std::string_view key, std::string_view value);
+    RequestBuilder& add(std::string_view key, const char* value) { return add(key, std::string_view(value)); }
+    RequestBuilder& add(std::string_view key, int64_t value);
+    RequestBuilder& add(std::string_view key, double value, int precision);
+    // Exact, with the symbol's `decimals`
+    RequestBuilder& add(std::string_view key, Decimal value, int decimals);
+
+    // Raw, already encoded query text such as "symbol=BTCUSDT&limit=5"
+    RequestBuilder& addQuery(std::string_view query);
+
+    // timestamp=<millis>, normally ClockSync::exchangeTimeMs()
+    RequestBuilder& addTimestamp(int64_t millis);
+
+    // Sign the query so far and append &signature=<hex>
+    bool sign(const HmacSigner& signer);
+
+    bool ok() const { return !overflow; }
+    const char* c_str() const { return buffer; }
+    size_t size() const { return length; }
+    std::string_view str() const { return std::string_view(buffer, length); }
+    std::string_view query() const { return std::string_view(buffer + queryStart, length - queryStart); }
+    std::string_view endpoint() const { return std::string_view(buffer, queryStart > 0 ? queryStart - 1 : 0); }
+
+private:
+    void append(std::string_view text);
+    void separator();
+    char* reserve(size_t n);
+    void commit(char* end) { length = end - buffer; buffer[length] = '\0'; }
+
+    char buffer[CAPACITY + 1];
+    size_t length;
+    size_t queryStart;
+    bool overflow;
+};
@@ -0,0 +1,265 @@
+// request_scheduler.cpp
+#include "request_scheduler.h"
+#include <algorithm>
+#include <charconv>
+#include "logger.h"
+#include <strings.h>
+#include "config/config.h"
+
+RequestScheduler& RequestScheduler::getInstance() {
+    static RequestScheduler instance;
+    return instance;
+}
+
+static RateLimiter::Limits configuredLimits() {
+    const Config& config = Config::getInstance();
+    RateLimiter::Limits limits;
+    limits.weightPerMinute = std::stoi(config.getSetting("rate_limit_weight", "6000"));
+    limits.ordersPer10s = std::stoi(config.getSetting("rate_limit_orders_10s", "100"));
+    limits.ordersPerDay = std::stoi(config.getSetting("rate_limit_orders_1d", "200000"));
+    limits.orderReserve = std::stod(config.getSetting("rate_limit_reserve", "0.2"));
+    return limits;
+}
+
+RequestScheduler::RequestScheduler()
+    : limiter(configuredLimits())
+    , nextDue(Clock::time_point::max())
+    , stopping(false) {
+    // Make sure the engine outlives the requests started on it
+    AsyncHttpClient::getInstance();
+    timer = std::thread(&RequestScheduler::timerLoop, this);
+}
+
+RequestScheduler::~RequestScheduler() {
+    std::vector<Pending> abandoned;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+        for (std::deque<Pending>& queue : queues) {
+            for (Pending& pending : queue) {
+                if (pending.admitted) *pending.admitted = true;
+                else abandoned.push_back(std::move(pending));
+            }
+            queue.clear();
+        }
+    }
+    admitted.notify_all();
+    wake.notify_one();
+    timer.join();
+
+    for (Pending& pending : abandoned) {
+        HttpResponse response;
+        response.result = CURLE_ABORTED_BY_CALLBACK;
+        pending.callback(response);
+    }
+}
+
+void RequestScheduler::submit(HttpRequest request, const RequestCost& cost, AsyncHttpClient::Callback callback,
+                              Prepare prepare) {
+    if (!request.admitExtra) {
+        request.admitExtra = [this, cost] { return tryAcquire(cost); };
+    }
+    Pending pending;
+    pending.cost = cost;
+    pending.request = std::move(request);
+    pending.callback = std::move(callback);
+    pending.prepare = std::move(prepare);
+    enqueue(std::move(pending));
+}
+
+void RequestScheduler::submitShared(HttpRequest request, const RequestCost& cost, AsyncHttpClient::Callback callback) {
+    if (request.method != "GET") {
+        submit(std::move(request), cost, std::move(callback));
+        return;
+    }
+
+    std::string url = request.url;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = shared.find(url);
+        if (it != shared.end()) {
+            it->second.push_back(std::move(callback));
+            stats.coalesced++;
+            return;
+        }
+        shared[url].push_back(std::move(callback));
+    }
+
+    submit(std::move(request), cost, [this, url](HttpResponse& response) {
+        std::vector<AsyncHttpClient::Callback> callers;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto it = shared.find(url);
+            if (it == shared.end()) return;
+            callers.swap(it->second);
+            shared.erase(it);
+        }
+        for (size_t i = 0; i < callers.size(); i++) {
+            try {
+                if (i + 1 == callers.size()) {
+                    callers[i](response);
+                } else {
+                    HttpResponse copy = response;
+                    callers[i](copy);
+                }
+            } catch (const std::exception& e) {
+                LOG_ERROR("Request callback failed: ", e.what());
+            }
+        }
+    });
+}
+
+void RequestScheduler::acquire(const RequestCost& cost) {
+    bool granted = false;
+    Pending pending;
+    pending.cost = cost;
+    pending.admitted = &granted;
+    enqueue(std::move(pending));
+
+    std::unique_lock<std::mutex> lock(mutex);
+    admitted.wait(lock, [&granted] { return granted; });
+}
+
+bool RequestScheduler::tryAcquire(const RequestCost& cost) {
+    Clock::time_point now = Clock::now();
+    std::lock_guard<std::mutex> lock(mutex);
+    bool waiting = false;
+    for (int priority = 0; priority <= static_cast<int>(cost.priority); priority++) {
+        waiting = waiting || !queues[priority].empty();
+    }
+    if (stopping || waiting || limiter.delay(cost, now) > Clock::duration::zero()) {
+        stats.extraRefused++;
+        return false;
+    }
+    limiter.take(cost, now);
+    stats.extra++;
+    return true;
+}
+
+void RequestScheduler::enqueue(Pending pending) {
+    pending.queued = Clock::now();
+    std::unique_lock<std::mutex> lock(mutex);
+    if (stopping) {
+        lock.unlock();
+        if (pending.admitted) {
+            *pending.admitted = true;
+        } else {
+            HttpResponse response;
+            response.result = CURLE_FAILED_INIT;
+            pending.callback(response);
+        }
+        return;
+    }
+    std::deque<Pending>& queue = queues[static_cast<int>(pending.cost.priority)];
+    queue.push_back(std::move(pending));
+    dispatch(lock, &queue.back());
+}
+
+// Start whatever the limits allow, highest class first; returns unlocked.
+// `added` is the request just queued, the only one that has not waited.
+void RequestScheduler::dispatch(std::unique_lock<std::mutex>& lock, const Pending* added) {
+    Clock::time_point now = Clock::now();
+    Clock::time_point previousDue = nextDue;
+    std::vector<Pending> ready;
+    bool admittedWaiter = false;
+
+    nextDue = Clock::time_point::max();
+    for (int priority = 0; priority < REQUEST_PRIORITIES; priority++) {
+        std::deque<Pending>& queue = queues[priority];
+        while (!queue.empty() && limiter.delay(queue.front().cost, now) == Clock::duration::zero()) {
+            Pending& next = queue.front();
+            limiter.take(next.cost, now);
+            stats.started[priority]++;
+            if (&next != added) stats.delayed++;
+            stats.maxWaitMs[priority] = std::max(stats.maxWaitMs[priority],
+                std::chrono::duration<double, std::milli>(now - next.queued).count());
+            if (next.admitted) {
+                *next.admitted = true;
+                admittedWaiter = true;
+            } else {
+                ready.push_back(std::move(next));
+            }
+            queue.pop_front();
+        }
+        if (queue.empty()) continue;
+
+        const Pending& blocked = queue.front();
+        nextDue = std::min(nextDue, now + limiter.delay(blocked.cost, now));
+
+        // Lower classes may only go ahead when this one waits on the order
+        // count alone, which they do not spend
+        RequestCost weightOnly = blocked.cost;
+        weightOnly.countsOrder = false;
+        if (limiter.delay(weightOnly, now) > Clock::duration::zero()) break;
+    }
+    lock.unlock();
+
+    if (admittedWaiter) admitted.notify_all();
+    if (nextDue < previousDue) wake.notify_one();
+    for (Pending& pending : ready) {
+        if (pending.prepare && !pending.prepare(pending.request)) {
+            HttpResponse response;
+            response.result = CURLE_FAILED_INIT;
+            pending.callback(response);
+            continue;
+        }
+        AsyncHttpClient::getInstance().submit(std::move(pending.request),
+            [this, callback = std::move(pending.callback)](HttpResponse& response) {
+                observe(response);
+                callback(response);
+            });
+    }
+}
+
+void RequestScheduler::timerLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (!stopping) {
+        if (nextDue == Clock::time_point::max()) wake.wait(lock);
+        else wake.wait_until(lock, nextDue);
+        if (stopping) break;
+        if (Clock::now() >= nextDue) {
+            dispatch(lock, nullptr);
+            lock.lock();
+        }
+    }
+}
+
+void RequestScheduler::observe(CURL* curl, long status) {
+    Clock::time_point now = Clock::now();
+    std::string retryAfter;  // curl reuses the header struct on every call
+    std::lock_guard<std::mutex> lock(mutex);
+    curl_header* header = nullptr;
+    while ((header = curl_easy_nextheader(curl, CURLH_HEADER, -1, header))) {
+        limiter.observeHeader(header->name, header->value, now);
+        if (strcasecmp(header->name, "Retry-After") == 0) retryAfter = header->value;
+    }
+    observeStatus(status, retryAfter, now);
+}
+
+void RequestScheduler::observe(const HttpResponse& response) {
+    if (!response.ok()) return;
+    Clock::time_point now = Clock::now();
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const auto& header : response.headers) {
+        limiter.observeHeader(header.first, header.second, now);
+    }
+    observeStatus(response.status, response.header("Retry-After"), now);
+}
+
+// Called locked
+void RequestScheduler::observeStatus(long status, std::string_view retryAfter, Clock::time_point now) {
+    if (status != 429 && status != 418) return;
+    long seconds = 60;
+    std::from_chars(retryAfter.data(), retryAfter.data() + retryAfter.size(), seconds);
+    LOG_WARN("Rate limited (HTTP ", status, "), holding requests for ", seconds, "s");
+    stats.limited++;
+    limiter.pause(std::chrono::seconds(seconds), now);
+}
+
+RequestScheduler::Stats RequestScheduler::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    Stats result = stats;
+    for (const std::deque<Pending>& queue : queues) result.queued += queue.size();
+    result.reportedWeight = limiter.reportedWeight();
+    return result;
+}
@@ -0,0 +1,109 @@
+// request_scheduler.h
+#pragma once
+#include <curl/curl.h>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "async_http.h"
+#include "rate_limiter.h"
+
+// Admission control in front of every REST call. Requests wait in one queue
+// per RequestPriority and are started highest class first, as soon as the
+// RateLimiter has budget for them; responses feed the exchange's usage
+// headers back into the limiter, and a 429/418 holds everything back for
+// its Retry-After. Identical public GETs that are already queued or in
+// flight are coalesced: later callers share the first caller's response.
+//
+// Engine requests are started on AsyncHttpClient once admitted; their retries
+// and hedge copies must fit the limits right away or they are held back (see
+// HttpRequest::admitExtra). Callers that send on their own handle (the
+// blocking signed path) call acquire() before and observe() after the transfer.
+//
+// Settings (config.json, all optional):
+//   rate_limit_weight      request weight per minute (default 6000)
+//   rate_limit_orders_10s  new orders per 10 seconds (default 100)
+//   rate_limit_orders_1d   new orders per day (default 200000)
+//   rate_limit_reserve     share of the weight kept for orders (default 0.2)
+class RequestScheduler {
+public:
+    struct Stats {
+        uint64_t started[REQUEST_PRIORITIES] = {};
+        uint64_t delayed = 0;         // could not start right away
+        uint64_t extra = 0;           // retries and hedge copies admitted
+        uint64_t extraRefused = 0;    // ... held back for lack of budget
+        uint64_t coalesced = 0;       // answered by an identical request in flight
+        uint64_t limited = 0;         // 429 or 418 responses
+        double maxWaitMs[REQUEST_PRIORITIES] = {};
+        size_t queued = 0;
+        int reportedWeight = -1;      // last X-MBX-USED-WEIGHT-1M
+    };
+
+    // Process-wide scheduler; its timer thread starts on first use
+    static RequestScheduler& getInstance();
+
+    RequestScheduler();
+    ~RequestScheduler();
+
+    RequestScheduler(const RequestScheduler&) = delete;
+    RequestScheduler& operator=(const RequestScheduler&) = delete;
+
+    // Runs when a request is admitted, right before it starts (e.g. to
+    // timestamp and sign it); false fails the request without sending it
+    using Prepare = std::function<bool(HttpRequest&)>;
+
+    // Start `request` on the engine once admitted; the callback runs on the
+    // engine's event loop thread and must not block
+    void submit(HttpRequest request, const RequestCost& cost, AsyncHttpClient::Callback callback,
+                Prepare prepare = nullptr);
+
+    // As submit(), but a GET for a URL already queued or in flight joins it
+    void submitShared(HttpRequest request, const RequestCost& cost, AsyncHttpClient::Callback callback);
+
+    // Block until a request of `cost` may be sent
+    void acquire(const RequestCost& cost);
+
+    // Take the budget for a request of `cost` if it fits now and nothing of
+    // the same or a higher class is waiting; never blocks
+    bool tryAcquire(const RequestCost& cost);
+
+    // Usage headers and status of a finished request
+    void observe(CURL* curl, long status);
+    void observe(const HttpResponse& response);
+
+    Stats getStats() const;
+
+private:
+    using Clock = RateLimiter::Clock;
+
+    struct Pending {
+        RequestCost cost;
+        Clock::time_point queued;
+        bool* admitted = nullptr;    // acquire() waiter, or an engine request:
+        HttpRequest request;
+        AsyncHttpClient::Callback callback;
+        Prepare prepare;
+    };
+
+    void enqueue(Pending pending);
+    void dispatch(std::unique_lock<std::mutex>& lock, const Pending* added);
+    void timerLoop();
+    void observeStatus(long status, std::string_view retryAfter, Clock::time_point now);
+
+    mutable std::mutex mutex;
+    std::condition_variable admitted;     // acquire() waiters
+    std::condition_variable wake;         // timer thread
+    std::deque<Pending> queues[REQUEST_PRIORITIES];
+    std::unordered_map<std::string, std::vector<AsyncHttpClient::Callback>> shared;  // URL -> joined callers
+    RateLimiter limiter;
+    Clock::time_point nextDue;            // when a queued request can start
+    bool stopping;
+    Stats stats;
+    std::thread timer;
+};
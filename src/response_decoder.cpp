@@ -0,0 +1,518 @@
+// response_decoder.cpp
+#include "response_decoder.h"
+#include <charconv>
+#include <cstring>
+
+void JsonScanner::skipWhitespace() {
+    while (pos < text.size() && (text[pos] == ' ' || text[pos] == '\n' || text[pos] == '\r' || text[pos] == '\t')) {
+        pos++;
+    }
+}
+
+bool JsonScanner::expect(char c) {
+    skipWhitespace();
+    if (failed || pos >= text.size() || text[pos] != c) return fail();
+    pos++;
+    return true;
+}
+
+bool JsonScanner::nextKey(std::string_view& key) {
+    skipWhitespace();
+    if (failed || pos >= text.size()) return fail();
+    if (text[pos] == '}') {
+        pos++;
+        return false;
+    }
+    if (text[pos] == ',') pos++;
+    return readString(key) && expect(':');
+}
+
+bool JsonScanner::nextElement() {
+    skipWhitespace();
+    if (failed || pos >= text.size()) return fail();
+    if (text[pos] == ']') {
+        pos++;
+        return false;
+    }
+    if (text[pos] == ',') pos++;
+    return true;
+}
+
+bool JsonScanner::readString(std::string_view& value) {
+    if (!expect('"')) return false;
+    size_t start = pos;
+    while (true) {
+        const char* quote = static_cast<const char*>(std::memchr(text.data() + pos, '"', text.size() - pos));
+        if (!quote) return fail();
+        size_t end = quote - text.data();
+        pos = end + 1;
+
+        // The closing quote is the first one not escaped by an odd run of backslashes
+        size_t backslashes = 0;
+        while (end - backslashes > start && text[end - backslashes - 1] == '\\') backslashes++;
+        if (backslashes % 2 == 0) {
+            value = text.substr(start, end - start);
+            return true;
+        }
+    }
+}
+
+bool JsonScanner::readString(std::string& value) {
+    std::string_view raw;
+    if (!readString(raw)) return false;
+    value.assign(raw.data(), raw.size());
+    return true;
+}
+
+// Number text, with or without surrounding quotes
+bool JsonScanner::numberText(std::string_view& value) {
+    skipWhitespace();
+    if (failed || pos >= text.size()) return fail();
+    if (text[pos] == '"') return readString(value);
+    size_t start = pos;
+    while (pos < text.size() && (text[pos] == '-' || text[pos] == '+' || text[pos] == '.' ||
+                                 text[pos] == 'e' || text[pos] == 'E' ||
+                                 (text[pos] >= '0' && text[pos] <= '9'))) {
+        pos++;
+    }
+    value = text.substr(start, pos - start);
+    return !value.empty() || fail();
+}
+
+bool JsonScanner::readNumber(double& value) {
+    std::string_view number;
+    if (!numberText(number)) return false;
+    std::from_chars_result result = std::from_chars(number.data(), number.data() + number.size(), value);
+    return (result.ec == std::errc() && result.ptr == number.data() + number.size()) || fail();
+}
+
+bool JsonScanner::readDecimal(Decimal& value) {
+    std::string_view number;
+    if (!numberText(number)) return false;
+    return Decimal::parse(number, value) || fail();
+}
+
+bool JsonScanner::readInteger(int64_t& value) {
+    std::string_view number;
+    if (!numberText(number)) return false;
+    std::from_chars_result result = std::from_chars(number.data(), number.data() + number.size(), value);
+    return (result.ec == std::errc() && result.ptr == number.data() + number.size()) || fail();
+}
+
+bool JsonScanner::readBool(bool& value) {
+    skipWhitespace();
+    if (text.compare(pos, 4, "true") == 0) {
+        value = true;
+        pos += 4;
+        return true;
+    }
+    if (text.compare(pos, 5, "false") == 0) {
+        value = false;
+        pos += 5;
+        return true;
+    }
+    return fail();
+}
+
+bool JsonScanner::skipValue() {
+    skipWhitespace();
+    if (failed || pos >= text.size()) return fail();
+
+    if (text[pos] == '"') {
+        std::string_view ignored;
+        return readString(ignored);
+    }
+    if (text[pos] == '{' || text[pos] == '[') {
+        // Skip the whole nested value by bracket depth, stepping over strings
+        int depth = 0;
+        do {
+            char c = text[pos];
+            if (c == '"') {
+                std::string_view ignored;
+                if (!readString(ignored)) return false;
+                continue;
+            }
+            if (c == '{' || c == '[') depth++;
+            else if (c == '}' || c == ']') depth--;
+            pos++;
+        } while (depth > 0 && pos < text.size());
+        return depth == 0 || fail();
+    }
+    // Number, true, false or null
+    size_t start = pos;
+    while (pos < text.size() && text[pos] != ',' && text[pos] != '}' && text[pos] != ']' &&
+           text[pos] != ' ' && text[pos] != '\n' && text[pos] != '\r' && text[pos] != '\t') {
+        pos++;
+    }
+    return pos > start || fail();
+}
+
+bool decodeTickerPrice(std::string_view json, TickerPrice& out) {
+    JsonScanner scanner(json);
+    if (!scanner.beginObject()) return false;
+    bool havePrice = false;
+    std::string_view key;
+    while (scanner.nextKey(key)) {
+        if (key == "symbol") scanner.readString(out.symbol);
+        else if (key == "price") havePrice = scanner.readNumber(out.price);
+        else scanner.skipValue();
+    }
+    return scanner.ok() && havePrice;
+}
+
+bool decodeBookTicker(std::string_view json, BookTicker& out) {
+    JsonScanner scanner(json);
+    if (!scanner.beginObject()) return false;
+    int found = 0;
+    std::string_view key;
+    while (scanner.nextKey(key)) {
+        if (key == "symbol") scanner.readString(out.symbol);
+        else if (key == "bidPrice") found += scanner.readNumber(out.bidPrice);
+        else if (key == "bidQty") found += scanner.readNumber(out.bidQty);
+        else if (key == "askPrice") found += scanner.readNumber(out.askPrice);
+        else if (key == "askQty") found += scanner.readNumber(out.askQty);
+        else scanner.skipValue();
+    }
+    return scanner.ok() && found == 4;
+}
+
+// [[openTime, "open", "high", "low", "close", "volume", closeTime, ...], ...]
+bool decodeKlines(std::string_view json, std::vector<Kline>& out) {
+    out.clear();
+    JsonScanner scanner(json);
+    if (!scanner.beginArray()) return false;
+    while (scanner.nextElement()) {
+        Kline kline;
+        if (!scanner.beginArray() ||
+            !scanner.nextElement() || !scanner.readInteger(kline.openTime) ||
+            !scanner.nextElement() || !scanner.readNumber(kline.open) ||
+            !scanner.nextElement() || !scanner.readNumber(kline.high) ||
+            !scanner.nextElement() || !scanner.readNumber(kline.low) ||
+            !scanner.nextElement() || !scanner.readNumber(kline.close) ||
+            !scanner.nextElement() || !scanner.readNumber(kline.volume) ||
+            !scanner.nextElement() || !scanner.readInteger(kline.closeTime)) {
+            return false;
+        }
+        while (scanner.nextElement()) scanner.skipValue();
+        out.push_back(kline);
+    }
+    return scanner.ok();
+}
+
+static bool decodeFills(JsonScanner& scanner, OrderAck& out) {
+    Decimal notional;
+    Decimal quantity;
+    if (!scanner.beginArray()) return false;
+    while (scanner.nextElement()) {
+        Decimal fillPrice;
+        Decimal fillQty;
+        std::string_view key;
+        if (!scanner.beginObject()) return false;
+        while (scanner.nextKey(key)) {
+            if (key == "price") scanner.readDecimal(fillPrice);
+            else if (key == "qty") scanner.readDecimal(fillQty);
+            else scanner.skipValue();
+        }
+        if (out.fillCount == 0) out.firstFillPrice = fillPrice;
+        out.fillCount++;
+        notional += fillPrice * fillQty;
+        quantity += fillQty;
+    }
+    if (!quantity.isZero()) out.averageFillPrice = notional.toDouble() / quantity.toDouble();
+    return scanner.ok();
+}
+
+bool decodeOrderAck(std::string_view json, OrderAck& out) {
+    JsonScanner scanner(json);
+    if (!scanner.beginObject()) return false;
+    bool haveOrderId = false;
+    std::string_view key;
+    while (scanner.nextKey(key)) {
+        if (key == "symbol") scanner.readString(out.symbol);
+        else if (key == "orderId") haveOrderId = scanner.readInteger(out.orderId);
+        else if (key == "clientOrderId") scanner.readString(out.clientOrderId);
+        else if (key == "origClientOrderId") scanner.readString(out.origClientOrderId);
+        else if (key == "status") scanner.readString(out.status);
+        else if (key == "transactTime" || key == "updateTime") scanner.readInteger(out.updateTime);
+        else if (key == "price") scanner.readDecimal(out.price);
+        else if (key == "origQty") scanner.readDecimal(out.origQty);
+        else if (key == "executedQty") scanner.readDecimal(out.executedQty);
+        else if (key == "cummulativeQuoteQty") scanner.readDecimal(out.cummulativeQuoteQty);
+        else if (key == "fills") decodeFills(scanner, out);
+        else scanner.skipValue();
+    }
+    return scanner.ok() && haveOrderId;
+}
+
+bool decodeExecutionReport(std::string_view json, OrderAck& out) {
+    JsonScanner scanner(json);
+    if (!scanner.beginObject()) return false;
+    bool isReport = false;
+    bool haveOrderId = false;
+    Decimal lastQty;
+    std::string_view type;
+    std::string_view key;
+    while (scanner.nextKey(key)) {
+        if (key == "e") isReport = scanner.readString(type) && type == "executionReport";
+        else if (key == "s") scanner.readString(out.symbol);
+        else if (key == "i") haveOrderId = scanner.readInteger(out.orderId);
+        else if (key == "c") scanner.readString(out.clientOrderId);
+        else if (key == "C") scanner.readString(out.origClientOrderId);
+        else if (key == "X") scanner.readString(out.status);
+        else if (key == "p") scanner.readDecimal(out.price);
+        else if (key == "q") scanner.readDecimal(out.origQty);
+        else if (key == "z") scanner.readDecimal(out.executedQty);
+        else if (key == "Z") scanner.readDecimal(out.cummulativeQuoteQty);
+        else if (key == "l") scanner.readDecimal(lastQty);
+        else if (key == "L") scanner.readDecimal(out.firstFillPrice);
+        else if (key == "T") scanner.readInteger(out.updateTime);
+        else scanner.skipValue();
+    }
+    if (lastQty > Decimal()) {
+        out.fillCount = 1;
+        out.averageFillPrice = out.firstFillPrice.toDouble();
+    } else {
+        out.firstFillPrice = Decimal();
+    }
+    return scanner.ok() && isReport && haveOrderId;
+}
+
+bool decodeAccountBalances(std::string_view json, AccountBalances& out, bool skipEmpty) {
+    JsonScanner scanner(json);
+    if (!scanner.beginObject()) return false;
+    bool haveBalances = false;
+    std::string_view key;
+    while (scanner.nextKey(key)) {
+        if (key == "canTrade") {
+            scanner.readBool(out.canTrade);
+        } else if (key == "accountType") {
+            scanner.readString(out.accountType);
+        } else if (key == "balances") {
+            if (!scanner.beginArray()) return false;
+            while (scanner.nextElement()) {
+                std::string_view asset;
+                double free = 0;
+                double locked = 0;
+                if (!scanner.beginObject()) return false;
+                while (scanner.nextKey(key)) {
+                    if (key == "asset") scanner.readString(asset);
+                    else if (key == "free") scanner.readNumber(free);
+                    else if (key == "locked") scanner.readNumber(locked);
+                    else scanner.skipValue();
+                }
+                if (skipEmpty && free == 0 && locked == 0) continue;
+                out.balances.push_back({std::string(asset), free, locked});
+            }
+            haveBalances = scanner.ok();
+        } else {
+            scanner.skipValue();
+        }
+    }
+    return scanner.ok() && haveBalances;
+}
+
+bool decodeServerTime(std::string_view json, ServerTime& out) {
+    JsonScanner scanner(json);
+    if (!scanner.beginObject()) return false;
+    bool haveTime = false;
+    std::string_view key;
+    while (scanner.nextKey(key)) {
+        if (key == "serverTime") haveTime = scanner.readInteger(out.serverTime);
+        else scanner.skipValue();
+    }
+    return scanner.ok() && haveTime;
+}
+
+// {"filterType": ..., ...}; the type may come after the values
+static bool decodeFilter(JsonScanner& scanner, SymbolInfo& out) {
+    if (!scanner.beginObject()) return false;
+    std::string_view type;
+    Decimal minPrice, maxPrice, tickSize;
+    Decimal minQty, maxQty, stepSize;
+    Decimal minNotional, maxNotional;
+    bool applyMin = false, applyMax = false;
+    double up = 0, down = 0, bidUp = 0, bidDown = 0, askUp = 0, askDown = 0;
+    std::string_view key;
+    while (scanner.nextKey(key)) {
+        if (key == "filterType") scanner.readString(type);
+        else if (key == "minPrice") scanner.readDecimal(minPrice);
+        else if (key == "maxPrice") scanner.readDecimal(maxPrice);
+        else if (key == "tickSize") scanner.readDecimal(tickSize);
+        else if (key == "minQty") scanner.readDecimal(minQty);
+        else if (key == "maxQty") scanner.readDecimal(maxQty);
+        else if (key == "stepSize") scanner.readDecimal(stepSize);
+        else if (key == "minNotional") scanner.readDecimal(minNotional);
+        else if (key == "maxNotional") scanner.readDecimal(maxNotional);
+        else if (key == "applyToMarket" || key == "applyMinToMarket") scanner.readBool(applyMin);
+        else if (key == "applyMaxToMarket") scanner.readBool(applyMax);
+        else if (key == "multiplierUp") scanner.readNumber(up);
+        else if (key == "multiplierDown") scanner.readNumber(down);
+        else if (key == "bidMultiplierUp") scanner.readNumber(bidUp);
+        else if (key == "bidMultiplierDown") scanner.readNumber(bidDown);
+        else if (key == "askMultiplierUp") scanner.readNumber(askUp);
+        else if (key == "askMultiplierDown") scanner.readNumber(askDown);
+        else scanner.skipValue();
+    }
+    // `type` points into the input, which outlives this call
+    if (type == "PRICE_FILTER") {
+        out.minPrice = minPrice;
+        out.maxPrice = maxPrice;
+        out.tickSize = tickSize;
+    } else if (type == "LOT_SIZE") {
+        out.minQty = minQty;
+        out.maxQty = maxQty;
+        out.stepSize = stepSize;
+    } else if (type == "MARKET_LOT_SIZE") {
+        out.marketMinQty = minQty;
+        out.marketMaxQty = maxQty;
+        out.marketStepSize = stepSize;
+    } else if (type == "MIN_NOTIONAL" || type == "NOTIONAL") {
+        out.minNotional = minNotional;
+        out.maxNotional = maxNotional;
+        out.minNotionalMarket = applyMin;
+        out.maxNotionalMarket = applyMax;
+    } else if (type == "PERCENT_PRICE") {
+        out.bidMultiplierUp = out.askMultiplierUp = up;
+        out.bidMultiplierDown = out.askMultiplierDown = down;
+    } else if (type == "PERCENT_PRICE_BY_SIDE") {
+        out.bidMultiplierUp = bidUp;
+        out.bidMultiplierDown = bidDown;
+        out.askMultiplierUp = askUp;
+        out.askMultiplierDown = askDown;
+    }
+    return scanner.ok();
+}
+
+static bool decodeSymbolInfo(JsonScanner& scanner, SymbolInfo& out) {
+    if (!scanner.beginObject()) return false;
+    bool haveSymbol = false;
+    std::string_view key;
+    while (scanner.nextKey(key)) {
+        if (key == "symbol") {
+            haveSymbol = scanner.readString(out.symbol);
+        } else if (key == "status") {
+            scanner.readString(out.status);
+        } else if (key == "baseAsset") {
+            scanner.readString(out.baseAsset);
+        } else if (key == "quoteAsset") {
+            scanner.readString(out.quoteAsset);
+        } else if (key == "filters") {
+            if (!scanner.beginArray()) return false;
+            while (scanner.nextElement()) {
+                if (!decodeFilter(scanner, out)) return false;
+            }
+        } else {
+            scanner.skipValue();
+        }
+    }
+    return scanner.ok() && haveSymbol;
+}
+
+bool decodeExchangeInfo(std::string_view json, std::vector<SymbolInfo>& out) {
+    out.clear();
+    JsonScanner scanner(json);
+    if (!scanner.beginObject()) return false;
+    bool haveSymbols = false;
+    std::string_view key;
+    while (scanner.nextKey(key)) {
+        if (key == "symbols") {
+            if (!scanner.beginArray()) return false;
+            while (scanner.nextElement()) {
+                SymbolInfo info;
+                if (!decodeSymbolInfo(scanner, info)) return false;
+                out.push_back(std::move(info));
+            }
+            haveSymbols = true;
+        } else {
+            scanner.skipValue();
+        }
+    }
+    return scanner.ok() && haveSymbols;
+}
+
+// [["price","qty"], ...]
+static bool decodeLevels(JsonScanner& scanner, std::vector<DepthLevel>& out) {
+    out.clear();
+    if (!scanner.beginArray()) return false;
+    while (scanner.nextElement()) {
+        DepthLevel level;
+        if (!scanner.beginArray() || !scanner.nextElement() || !scanner.readNumber(level.price) ||
+            !scanner.nextElement() || !scanner.readNumber(level.quantity)) {
+            return false;
+        }
+        while (scanner.nextElement()) scanner.skipValue();
+        out.push_back(level);
+    }
+    return scanner.ok();
+}
+
+bool decodeDepthSnapshot(std::string_view json, DepthSnapshot& out) {
+    JsonScanner scanner(json);
+    if (!scanner.beginObject()) return false;
+    bool haveId = false;
+    bool haveBids = false;
+    bool haveAsks = false;
+    std::string_view key;
+    while (scanner.nextKey(key)) {
+        if (key == "lastUpdateId") haveId = scanner.readInteger(out.lastUpdateId);
+        else if (key == "bids") haveBids = decodeLevels(scanner, out.bids);
+        else if (key == "asks") haveAsks = decodeLevels(scanner, out.asks);
+        else scanner.skipValue();
+    }
+    return scanner.ok() && haveId && haveBids && haveAsks;
+}
+
+static bool decodeDepthEvent(JsonScanner& scanner, DepthUpdate& out) {
+    if (!scanner.beginObject()) return false;
+    bool haveIds = false;
+    bool isDepth = false;
+    std::string_view key;
+    while (scanner.nextKey(key)) {
+        if (key == "data") {
+            // Combined stream wrapper
+            isDepth = haveIds = decodeDepthEvent(scanner, out);
+        } else if (key == "e") {
+            std::string_view type;
+            isDepth = scanner.readString(type) && type == "depthUpdate";
+        } else if (key == "E") {
+            scanner.readInteger(out.eventTime);
+        } else if (key == "s") {
+            scanner.readString(out.symbol);
+        } else if (key == "U") {
+            scanner.readInteger(out.firstUpdateId);
+        } else if (key == "u") {
+            haveIds = scanner.readInteger(out.finalUpdateId);
+        } else if (key == "b") {
+            decodeLevels(scanner, out.bids);
+        } else if (key == "a") {
+            decodeLevels(scanner, out.asks);
+        } else {
+            scanner.skipValue();
+        }
+    }
+    return scanner.ok() && isDepth && haveIds;
+}
+
+bool decodeDepthUpdate(std::string_view json, DepthUpdate& out) {
+    JsonScanner scanner(json);
+    return decodeDepthEvent(scanner, out);
+}
+
+bool decodeApiError(std::string_view json, ApiError& out) {
+    JsonScanner scanner(json);
+    if (!scanner.beginObject()) return false;
+    bool haveCode = false;
+    std::string_view key;
+    while (scanner.nextKey(key)) {
+        int64_t code = 0;
+        if (key == "code") {
+            haveCode = scanner.readInteger(code);
+            out.code = static_cast<int>(code);
+        } else if (key == "msg") {
+            scanner.readString(out.msg);
+        } else {
+            scanner.skipValue();
+        }
+    }
+    return scanner.ok() && haveCode;
+}
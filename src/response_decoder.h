@@ -0,0 +1,186 @@
+// response_decoder.h
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "decimal.h"
+
+// Typed decoders for REST responses. Instead of building a JSON DOM they
+// walk the text once, read only the keys a struct needs, skip everything
+// else in place and convert numbers (quoted or not) with std::from_chars;
+// order prices and quantities are read exactly as Decimal.
+// Each returns false on malformed input or when a required key is missing;
+// an exchange error body ({"code":...,"msg":...}) can be read with
+// decodeApiError().
+
+struct TickerPrice {
+    std::string symbol;
+    double price = 0;
+};
+
+struct BookTicker {
+    std::string symbol;
+    double bidPrice = 0;
+    double bidQty = 0;
+    double askPrice = 0;
+    double askQty = 0;
+};
+
+// One row of GET /api/v3/klines
+struct Kline {
+    int64_t openTime = 0;    // ms
+    double open = 0;
+    double high = 0;
+    double low = 0;
+    double close = 0;
+    double volume = 0;
+    int64_t closeTime = 0;   // ms, in the future while the kline is forming
+};
+
+struct OrderAck {
+    std::string symbol;
+    int64_t orderId = 0;
+    std::string clientOrderId;
+    std::string origClientOrderId;   // cancel replies: the order canceled
+    std::string status;
+    Decimal price;
+    Decimal origQty;
+    Decimal executedQty;
+    Decimal cummulativeQuoteQty;
+    int fillCount = 0;
+    Decimal firstFillPrice;      // fills[0].price, 0 without fills
+    double averageFillPrice = 0; // quantity-weighted over all fills
+    int64_t updateTime = 0;      // transactTime or updateTime, ms
+};
+
+struct AccountBalances {
+    struct Balance {
+        std::string asset;
+        double free = 0;
+        double locked = 0;
+    };
+    bool canTrade = false;
+    std::string accountType;
+    std::vector<Balance> balances;
+};
+
+struct ServerTime {
+    int64_t serverTime = 0;  // exchange clock in ms
+};
+
+// One [price, quantity] entry of a depth response or update
+struct DepthLevel {
+    double price = 0;
+    double quantity = 0;     // 0 in an update removes the level
+};
+
+// GET /api/v3/depth
+struct DepthSnapshot {
+    int64_t lastUpdateId = 0;
+    std::vector<DepthLevel> bids;
+    std::vector<DepthLevel> asks;
+};
+
+// <symbol>@depth stream event: the levels that changed in updates
+// firstUpdateId..finalUpdateId
+struct DepthUpdate {
+    std::string symbol;
+    int64_t eventTime = 0;
+    int64_t firstUpdateId = 0;   // U
+    int64_t finalUpdateId = 0;   // u
+    std::vector<DepthLevel> bids;
+    std::vector<DepthLevel> asks;
+};
+
+// One symbol of GET /api/v3/exchangeInfo with the filters orders must pass;
+// a value stays 0 when its filter is absent
+struct SymbolInfo {
+    std::string symbol;
+    std::string status;             // TRADING, BREAK, ...
+    std::string baseAsset;
+    std::string quoteAsset;
+    // PRICE_FILTER
+    Decimal minPrice;
+    Decimal maxPrice;
+    Decimal tickSize;
+    // LOT_SIZE, and MARKET_LOT_SIZE for market orders
+    Decimal minQty;
+    Decimal maxQty;
+    Decimal stepSize;
+    Decimal marketMinQty;
+    Decimal marketMaxQty;
+    Decimal marketStepSize;
+    // MIN_NOTIONAL or NOTIONAL
+    Decimal minNotional;
+    Decimal maxNotional;
+    bool minNotionalMarket = false;   // also checked for market orders
+    bool maxNotionalMarket = false;
+    // PERCENT_PRICE (same for both sides) or PERCENT_PRICE_BY_SIDE
+    double bidMultiplierUp = 0;
+    double bidMultiplierDown = 0;
+    double askMultiplierUp = 0;
+    double askMultiplierDown = 0;
+};
+
+struct ApiError {
+    int code = 0;
+    std::string msg;
+};
+
+bool decodeTickerPrice(std::string_view json, TickerPrice& out);
+bool decodeBookTicker(std::string_view json, BookTicker& out);
+bool decodeKlines(std::string_view json, std::vector<Kline>& out);
+bool decodeOrderAck(std::string_view json, OrderAck& out);
+
+// User data stream executionReport, read into the fields an order response
+// has (last fill as the only fill)
+bool decodeExecutionReport(std::string_view json, OrderAck& out);
+
+// With skipEmpty, assets whose free and locked amounts are both zero are left out
+bool decodeAccountBalances(std::string_view json, AccountBalances& out, bool skipEmpty = true);
+
+bool decodeServerTime(std::string_view json, ServerTime& out);
+bool decodeExchangeInfo(std::string_view json, std::vector<SymbolInfo>& out);
+bool decodeDepthSnapshot(std::string_view json, DepthSnapshot& out);
+
+// The event alone or wrapped by a combined stream ({"stream":...,"data":{...}})
+bool decodeDepthUpdate(std::string_view json, DepthUpdate& out);
+
+bool decodeApiError(std::string_view json, ApiError& out);
+
+// Forward-only reader over one JSON text, used by the decoders above.
+// Strings are returned raw (between the quotes, escapes left as is), which
+// is all exchange keys, symbols and decimal strings need.
+class JsonScanner {
+public:
+    explicit JsonScanner(std::string_view text) : text(text), pos(0), failed(false) {}
+
+    bool beginObject() { return expect('{'); }
+    bool beginArray() { return expect('['); }
+
+    // Next key of the current object; false (and the '}' consumed) at its end
+    bool nextKey(std::string_view& key);
+    // Whether another element follows in the current array; consumes ']' at its end
+    bool nextElement();
+
+    bool readString(std::string_view& value);
+    bool readString(std::string& value);
+    bool readNumber(double& value);      // 1.5 or "1.5"
+    bool readDecimal(Decimal& value);    // 1.5 or "1.5", exactly
+    bool readInteger(int64_t& value);    // 42 or "42"
+    bool readBool(bool& value);
+    bool skipValue();
+
+    bool ok() const { return !failed; }
+
+private:
+    void skipWhitespace();
+    bool expect(char c);
+    bool fail() { failed = true; return false; }
+    bool numberText(std::string_view& value);
+
+    std::string_view text;
+    size_t pos;
+    bool failed;
+};
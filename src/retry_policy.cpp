@@ -0,0 +1,57 @@
+// retry_policy.cpp
+#include "retry_policy.h"
+#include <algorithm>
+
+std::chrono::milliseconds RetryPolicy::retryDelay(int retry, std::minstd_rand& random) const {
+    int64_t delay = backoff.count();
+    for (int i = 1; i < retry && delay < maxBackoff.count(); i++) delay *= 2;
+    delay = std::min<int64_t>(delay, maxBackoff.count());
+    std::uniform_int_distribution<int64_t> jitter(delay / 2, delay);
+    return std::chrono::milliseconds(jitter(random));
+}
+
+// `fraction` quantile of `values` (reordered)
+static int64_t quantile(std::vector<int64_t>& values, double fraction) {
+    size_t index = std::min(values.size() - 1, static_cast<size_t>(fraction * values.size()));
+    std::nth_element(values.begin(), values.begin() + index, values.end());
+    return values[index];
+}
+
+void LatencyTracker::record(const std::string& endpoint, Clock::duration latency) {
+    int64_t us = std::chrono::duration_cast<std::chrono::microseconds>(latency).count();
+    std::lock_guard<std::mutex> lock(mutex);
+    Endpoint& entry = endpoints[endpoint];
+    if (entry.recentUs.size() < RECENT) entry.recentUs.push_back(us);
+    else entry.recentUs[entry.next] = us;
+    entry.next = (entry.next + 1) % RECENT;
+    entry.samples++;
+
+    // A quantile of 256 values is cheap, but not worth doing on every reply
+    if (entry.samples >= MIN_SAMPLES && (entry.samples - MIN_SAMPLES) % 8 == 0) {
+        std::vector<int64_t> values = entry.recentUs;
+        entry.p95Us = quantile(values, 0.95);
+    }
+}
+
+LatencyTracker::Clock::duration LatencyTracker::p95(const std::string& endpoint) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = endpoints.find(endpoint);
+    if (it == endpoints.end()) return Clock::duration::zero();
+    return std::chrono::microseconds(it->second.p95Us);
+}
+
+std::vector<LatencyTracker::Summary> LatencyTracker::summary() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::vector<Summary> result;
+    for (const auto& entry : endpoints) {
+        Summary summary;
+        summary.endpoint = entry.first;
+        summary.samples = entry.second.samples;
+        std::vector<int64_t> values = entry.second.recentUs;
+        summary.p50Ms = quantile(values, 0.50) / 1000.0;
+        summary.p95Ms = quantile(values, 0.95) / 1000.0;
+        summary.p99Ms = quantile(values, 0.99) / 1000.0;
+        result.push_back(summary);
+    }
+    return result;
+}
@@ -0,0 +1,65 @@
+// retry_policy.h
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// How AsyncHttpClient retries and hedges one request. A try that fails at
+// the transport level, runs past attemptTimeout or gets a 5xx is retried
+// after an exponential backoff with jitter, so callers that failed together
+// do not come back together. A hedged request also gets a second copy when
+// its try is still running after the endpoint's recent p95 latency; the
+// first answer wins and the other copy is cancelled. Only hedge requests
+// that are safe to send twice (public GETs).
+struct RetryPolicy {
+    int attempts = 1;                                 // tries, hedge copies not counted
+    std::chrono::milliseconds attemptTimeout{0};      // per try; 0 keeps the pool's timeout
+    std::chrono::milliseconds backoff{100};           // before the first retry, doubling after
+    std::chrono::milliseconds maxBackoff{2000};
+    bool hedge = false;
+    std::chrono::milliseconds minHedgeDelay{20};      // never hedge sooner than this
+
+    // Wait before retry number `retry` (1 for the first): uniform in the
+    // upper half of the doubled backoff
+    std::chrono::milliseconds retryDelay(int retry, std::minstd_rand& random) const;
+};
+
+// Latency of recent successful tries per endpoint (URL without the query),
+// which sets when a hedged request gets its second copy. Thread-safe.
+class LatencyTracker {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Summary {
+        std::string endpoint;
+        uint64_t samples = 0;        // since start
+        double p50Ms = 0;            // of the recent ones
+        double p95Ms = 0;
+        double p99Ms = 0;
+    };
+
+    void record(const std::string& endpoint, Clock::duration latency);
+
+    // Recent p95 of `endpoint`; zero until MIN_SAMPLES tries have been seen
+    Clock::duration p95(const std::string& endpoint) const;
+
+    std::vector<Summary> summary() const;
+
+    static constexpr size_t RECENT = 256;
+    static constexpr size_t MIN_SAMPLES = 20;
+
+private:
+    struct Endpoint {
+        std::vector<int64_t> recentUs;   // ring of the last RECENT
+        size_t next = 0;
+        uint64_t samples = 0;
+        int64_t p95Us = 0;               // refreshed every few samples
+    };
+
+    mutable std::mutex mutex;
+    std::unordered_map<std::string, Endpoint> endpoints;
+};
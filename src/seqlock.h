@@ -0,0 +1,57 @@
+// seqlock.h
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+// One value of a small trivially copyable type that many threads read and
+// few write. Readers never block or write shared memory: they copy the value
+// and retry if a store ran meanwhile (the sequence is odd during a store or
+// changed across the copy). Stores must be serialized by the caller. The
+// value is kept in atomic words so the racy copy is well defined.
+template <typename T>
+class SeqLock {
+    static_assert(std::is_trivially_copyable_v<T>, "SeqLock holds plain data");
+
+public:
+    SeqLock() : sequence(0) {
+        for (std::atomic<uint64_t>& word : words) word.store(0, std::memory_order_relaxed);
+    }
+
+    // Callers serialize stores
+    void store(const T& value) {
+        uint64_t buffer[WORDS] = {};
+        std::memcpy(buffer, &value, sizeof(T));
+        uint64_t current = sequence.load(std::memory_order_relaxed);
+        sequence.store(current + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t i = 0; i < WORDS; i++) words[i].store(buffer[i], std::memory_order_relaxed);
+        sequence.store(current + 2, std::memory_order_release);
+    }
+
+    T load() const {
+        uint64_t buffer[WORDS];
+        uint64_t before;
+        uint64_t after;
+        do {
+            before = sequence.load(std::memory_order_acquire);
+            for (size_t i = 0; i < WORDS; i++) buffer[i] = words[i].load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            after = sequence.load(std::memory_order_relaxed);
+        } while (before != after || (before & 1));
+        T value;
+        std::memcpy(&value, buffer, sizeof(T));
+        return value;
+    }
+
+    // Stores so far; 0 until the first one
+    uint64_t version() const { return sequence.load(std::memory_order_acquire) / 2; }
+
+private:
+    static constexpr size_t WORDS = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    std::atomic<uint64_t> sequence;
+    std::atomic<uint64_t> words[WORDS];
+};
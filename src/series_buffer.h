@@ -0,0 +1,98 @@
+// series_buffer.h
+#pragma once
+#include <cstddef>
+#include <new>
+#include <memory>
+#include <algorithm>
+#include <type_traits>
+
+// Read-only view over a contiguous run of series values, oldest first
+template <typename T>
+class SeriesView {
+public:
+    SeriesView() : first(nullptr), count(0) {}
+    SeriesView(const T* data, size_t size) : first(data), count(size) {}
+
+    const T* begin() const { return first; }
+    const T* end() const { return first + count; }
+    const T* data() const { return first; }
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    // Chronological access (0 = oldest) and access from the newest (0 = newest)
+    const T& operator[](size_t i) const { return first[i]; }
+    const T& ago(size_t n) const { return first[count - 1 - n]; }
+    const T& front() const { return first[0]; }
+    const T& back() const { return first[count - 1]; }
+
+    // The most recent n values (or all of them if fewer are available)
+    SeriesView last(size_t n) const {
+        n = std::min(n, count);
+        return SeriesView(end() - n, n);
+    }
+
+private:
+    const T* first;
+    size_t count;
+};
+
+// Fixed-capacity circular series for price/volume history.
+// Every value is written twice (at pos and pos + capacity), so the most
+// recent size() values always form one contiguous run: dropping the oldest
+// value never moves memory, and readers get a SeriesView without copying.
+template <typename T>
+class SeriesBuffer {
+    static_assert(std::is_trivially_copyable<T>::value, "SeriesBuffer holds plain values");
+
+public:
+    static constexpr size_t CACHE_LINE = 64;
+
+    explicit SeriesBuffer(size_t capacity)
+        : cap(std::max<size_t>(capacity, 1))
+        , head(0)
+        , count(0)
+        , storage(allocate(2 * cap)) {}
+
+    SeriesBuffer(SeriesBuffer&&) = default;
+    SeriesBuffer& operator=(SeriesBuffer&&) = default;
+
+    void push_back(const T& value) {
+        storage[head] = value;
+        storage[head + cap] = value;
+        head = (head + 1 == cap) ? 0 : head + 1;
+        if (count < cap) count++;
+    }
+
+    void clear() {
+        head = 0;
+        count = 0;
+    }
+
+    size_t size() const { return count; }
+    size_t capacity() const { return cap; }
+    bool empty() const { return count == 0; }
+    bool full() const { return count == cap; }
+
+    SeriesView<T> view() const { return SeriesView<T>(storage.get() + head + cap - count, count); }
+    SeriesView<T> last(size_t n) const { return view().last(n); }
+
+    const T* begin() const { return view().begin(); }
+    const T* end() const { return storage.get() + head + cap; }
+    const T& operator[](size_t i) const { return view()[i]; }
+    const T& ago(size_t n) const { return storage[head + cap - 1 - n]; }
+    const T& back() const { return ago(0); }
+
+private:
+    struct AlignedDelete {
+        void operator()(T* p) const { ::operator delete[](p, std::align_val_t(CACHE_LINE)); }
+    };
+
+    static T* allocate(size_t n) {
+        return static_cast<T*>(::operator new[](n * sizeof(T), std::align_val_t(CACHE_LINE)));
+    }
+
+    size_t cap;
+    size_t head;   // next write position in [0, cap)
+    size_t count;
+    std::unique_ptr<T[], AlignedDelete> storage;
+};
@@ -0,0 +1,245 @@
+// signal_kernels.cpp
+#include "signal_kernels.h"
+#include "cpu_features.h"
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define SIGNAL_KERNELS_X86 1
+#endif
+
+BitColumn& BitColumn::operator&=(const BitColumn& other) {
+    for (size_t w = 0; w < words.size(); w++) words[w] &= other.words[w];
+    return *this;
+}
+
+BitColumn& BitColumn::operator|=(const BitColumn& other) {
+    for (size_t w = 0; w < words.size(); w++) words[w] |= other.words[w];
+    return *this;
+}
+
+BitColumn BitColumn::operator~() const {
+    BitColumn result(count);
+    for (size_t w = 0; w < words.size(); w++) result.words[w] = ~words[w];
+    result.clearPadding();
+    return result;
+}
+
+void BitColumn::clearBelow(size_t n) {
+    n = std::min(n, count);
+    size_t fullWords = n / 64;
+    std::fill(words.begin(), words.begin() + fullWords, 0);
+    if (n % 64 != 0) words[fullWords] &= ~uint64_t(0) << (n % 64);
+}
+
+void BitColumn::clearPadding() {
+    if (count % 64 != 0) words.back() &= (uint64_t(1) << (count % 64)) - 1;
+}
+
+BitColumn atLeastThreeOfFive(const BitColumn& a, const BitColumn& b, const BitColumn& c,
+                             const BitColumn& d, const BitColumn& e) {
+    // Bit-sliced count: two full adders give count = sum + 2 * (carry1 + carry2)
+    BitColumn result(a.size());
+    for (size_t w = 0; w < result.wordCount(); w++) {
+        uint64_t x = a.data()[w], y = b.data()[w], z = c.data()[w];
+        uint64_t sum1 = x ^ y ^ z;
+        uint64_t carry1 = (x & y) | (z & (x ^ y));
+        uint64_t u = d.data()[w], v = e.data()[w];
+        uint64_t sum2 = sum1 ^ u ^ v;
+        uint64_t carry2 = (sum1 & u) | (v & (sum1 ^ u));
+        result.data()[w] = (carry1 & carry2) | ((carry1 ^ carry2) & sum2);
+    }
+    return result;
+}
+
+// Scalar kernels (also used for the tail after the last full AVX2 block)
+
+static void greaterScalar(const double* a, const double* b, size_t begin, size_t n, BitColumn& out) {
+    for (size_t i = begin; i < n; i++) {
+        if (a[i] > b[i]) out.set(i);
+    }
+}
+
+static void greaterValueScalar(const double* a, double value, size_t begin, size_t n, BitColumn& out) {
+    for (size_t i = begin; i < n; i++) {
+        if (a[i] > value) out.set(i);
+    }
+}
+
+static void lessValueScalar(const double* a, double value, size_t begin, size_t n, BitColumn& out) {
+    for (size_t i = begin; i < n; i++) {
+        if (a[i] < value) out.set(i);
+    }
+}
+
+static void greaterQuotientScalar(const double* a, const double* b, double divisor,
+                                  size_t begin, size_t n, BitColumn& out) {
+    for (size_t i = begin; i < n; i++) {
+        if (a[i] > b[i] / divisor) out.set(i);
+    }
+}
+
+static void lessPreviousScalar(const double* x, size_t begin, size_t n, BitColumn& out) {
+    for (size_t i = std::max<size_t>(begin, 1); i < n; i++) {
+        if (x[i] < x[i - 1]) out.set(i);
+    }
+}
+
+static void higherLowsScalar(const double* x, size_t begin, size_t n, BitColumn& out) {
+    for (size_t i = std::max<size_t>(begin, 3); i < n; i++) {
+        if (std::min(x[i], x[i - 1]) > std::min(x[i - 2], x[i - 3])) out.set(i);
+    }
+}
+
+#ifdef SIGNAL_KERNELS_X86
+
+// Each AVX2 block covers 4 bars starting at a multiple of 4, so its
+// movemask never straddles a 64-bit word.
+static inline void storeBlock(BitColumn& out, size_t i, int mask) {
+    out.data()[i >> 6] |= uint64_t(mask) << (i & 63);
+}
+
+__attribute__((target("avx2")))
+static size_t greaterAvx2(const double* a, const double* b, size_t n, BitColumn& out) {
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d cmp = _mm256_cmp_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i), _CMP_GT_OQ);
+        storeBlock(out, i, _mm256_movemask_pd(cmp));
+    }
+    return i;
+}
+
+__attribute__((target("avx2")))
+static size_t greaterValueAvx2(const double* a, double value, size_t n, BitColumn& out) {
+    __m256d v = _mm256_set1_pd(value);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d cmp = _mm256_cmp_pd(_mm256_loadu_pd(a + i), v, _CMP_GT_OQ);
+        storeBlock(out, i, _mm256_movemask_pd(cmp));
+    }
+    return i;
+}
+
+__attribute__((target("avx2")))
+static size_t lessValueAvx2(const double* a, double value, size_t n, BitColumn& out) {
+    __m256d v = _mm256_set1_pd(value);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d cmp = _mm256_cmp_pd(_mm256_loadu_pd(a + i), v, _CMP_LT_OQ);
+        storeBlock(out, i, _mm256_movemask_pd(cmp));
+    }
+    return i;
+}
+
+__attribute__((target("avx2")))
+static size_t greaterQuotientAvx2(const double* a, const double* b, double divisor, size_t n, BitColumn& out) {
+    // Divide rather than multiply by the reciprocal so the comparison is
+    // bit-for-bit the same as the per-bar rule
+    __m256d d = _mm256_set1_pd(divisor);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d quotient = _mm256_div_pd(_mm256_loadu_pd(b + i), d);
+        __m256d cmp = _mm256_cmp_pd(_mm256_loadu_pd(a + i), quotient, _CMP_GT_OQ);
+        storeBlock(out, i, _mm256_movemask_pd(cmp));
+    }
+    return i;
+}
+
+__attribute__((target("avx2")))
+static size_t lessPreviousAvx2(const double* x, size_t n, BitColumn& out) {
+    // Start at bar 4; bars 1-3 are left to the scalar pass
+    size_t i = 4;
+    for (; i + 4 <= n; i += 4) {
+        __m256d cmp = _mm256_cmp_pd(_mm256_loadu_pd(x + i), _mm256_loadu_pd(x + i - 1), _CMP_LT_OQ);
+        storeBlock(out, i, _mm256_movemask_pd(cmp));
+    }
+    return i;
+}
+
+__attribute__((target("avx2")))
+static size_t higherLowsAvx2(const double* x, size_t n, BitColumn& out) {
+    // Start at bar 4: bars 0-2 never qualify and bar 3 is left to the scalar pass
+    size_t i = 4;
+    for (; i + 4 <= n; i += 4) {
+        __m256d recent = _mm256_min_pd(_mm256_loadu_pd(x + i), _mm256_loadu_pd(x + i - 1));
+        __m256d earlier = _mm256_min_pd(_mm256_loadu_pd(x + i - 2), _mm256_loadu_pd(x + i - 3));
+        storeBlock(out, i, _mm256_movemask_pd(_mm256_cmp_pd(recent, earlier, _CMP_GT_OQ)));
+    }
+    return i;
+}
+
+#endif
+
+static bool hasAvx2() {
+    return simdLevel() >= SimdLevel::AVX2;
+}
+
+const char* signalKernelIsa() {
+    return hasAvx2() ? "avx2" : "scalar";
+}
+
+BitColumn greaterThan(const double* a, const double* b, size_t n) {
+    BitColumn out(n);
+    size_t done = 0;
+#ifdef SIGNAL_KERNELS_X86
+    if (hasAvx2()) done = greaterAvx2(a, b, n, out);
+#endif
+    greaterScalar(a, b, done, n, out);
+    return out;
+}
+
+BitColumn greaterThan(const double* a, double value, size_t n) {
+    BitColumn out(n);
+    size_t done = 0;
+#ifdef SIGNAL_KERNELS_X86
+    if (hasAvx2()) done = greaterValueAvx2(a, value, n, out);
+#endif
+    greaterValueScalar(a, value, done, n, out);
+    return out;
+}
+
+BitColumn lessThan(const double* a, double value, size_t n) {
+    BitColumn out(n);
+    size_t done = 0;
+#ifdef SIGNAL_KERNELS_X86
+    if (hasAvx2()) done = lessValueAvx2(a, value, n, out);
+#endif
+    lessValueScalar(a, value, done, n, out);
+    return out;
+}
+
+BitColumn greaterThanQuotient(const double* a, const double* b, double divisor, size_t n) {
+    BitColumn out(n);
+    size_t done = 0;
+#ifdef SIGNAL_KERNELS_X86
+    if (hasAvx2()) done = greaterQuotientAvx2(a, b, divisor, n, out);
+#endif
+    greaterQuotientScalar(a, b, divisor, done, n, out);
+    return out;
+}
+
+BitColumn lessThanPrevious(const double* x, size_t n) {
+    BitColumn out(n);
+    size_t done = 0;
+#ifdef SIGNAL_KERNELS_X86
+    if (hasAvx2() && n >= 8) {
+        lessPreviousScalar(x, 0, 4, out);
+        done = lessPreviousAvx2(x, n, out);
+    }
+#endif
+    lessPreviousScalar(x, done, n, out);
+    return out;
+}
+
+BitColumn higherLows(const double* x, size_t n) {
+    BitColumn out(n);
+    size_t done = 0;
+#ifdef SIGNAL_KERNELS_X86
+    if (hasAvx2() && n >= 8) {
+        higherLowsScalar(x, 0, 4, out);
+        done = higherLowsAvx2(x, n, out);
+    }
+#endif
+    higherLowsScalar(x, done, n, out);
+    return out;
+}
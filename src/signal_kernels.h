@@ -0,0 +1,56 @@
+// signal_kernels.h
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// One bit per bar, packed 64 bars to a word
+class BitColumn {
+public:
+    BitColumn() : count(0) {}
+    explicit BitColumn(size_t count) : words((count + 63) / 64, 0), count(count) {}
+
+    size_t size() const { return count; }
+    bool test(size_t i) const { return (words[i >> 6] >> (i & 63)) & 1; }
+    void set(size_t i) { words[i >> 6] |= uint64_t(1) << (i & 63); }
+    uint64_t* data() { return words.data(); }
+    const uint64_t* data() const { return words.data(); }
+    size_t wordCount() const { return words.size(); }
+
+    BitColumn& operator&=(const BitColumn& other);
+    BitColumn& operator|=(const BitColumn& other);
+    BitColumn operator~() const;
+
+    // Clear bits [0, n)
+    void clearBelow(size_t n);
+
+private:
+    void clearPadding();
+
+    std::vector<uint64_t> words;
+    size_t count;
+};
+
+inline BitColumn operator&(BitColumn a, const BitColumn& b) { return a &= b; }
+inline BitColumn operator|(BitColumn a, const BitColumn& b) { return a |= b; }
+
+// Bit i set where at least 3 of the 5 inputs have bit i set
+BitColumn atLeastThreeOfFive(const BitColumn& a, const BitColumn& b, const BitColumn& c,
+                             const BitColumn& d, const BitColumn& e);
+
+// Whole-series comparison kernels. Each sets bit i of the result from
+// element i of its inputs; AVX2 is used when simdLevel() allows it, with a
+// scalar fallback that gives identical results.
+BitColumn greaterThan(const double* a, const double* b, size_t n);            // a[i] > b[i]
+BitColumn greaterThan(const double* a, double value, size_t n);               // a[i] > value
+BitColumn lessThan(const double* a, double value, size_t n);                  // a[i] < value
+BitColumn greaterThanQuotient(const double* a, const double* b, double divisor, size_t n);  // a[i] > b[i] / divisor
+
+// x[i] < x[i-1]; bit 0 is clear
+BitColumn lessThanPrevious(const double* x, size_t n);
+
+// min(x[i], x[i-1]) > min(x[i-2], x[i-3]); bits 0..2 are clear
+BitColumn higherLows(const double* x, size_t n);
+
+// Which implementation the kernels dispatch to ("avx2" or "scalar")
+const char* signalKernelIsa();
@@ -1,5 +1,6 @@
 #include "strategy.h"
-#include <iostream>
+#include "window_kernels.h"
+#include "logger.h"
 #include <thread>
 #include <chrono>
 #include <numeric>
@@ -15,13 +16,14 @@ TradingStrategy::TradingStrategy(BinanceAPI& api, OrderManager& orderManager,
     , symbol(symbol)
     , shortPeriod(shortPeriod)
     , longPeriod(longPeriod)
-    , running(false) {}
+    , running(false)
+    , priceHistory(longPeriod) {}
 
 // Run strategy
 void TradingStrategy::run() {
     running = true;
     while (running) {
-        std::cout << "Strategy running..." << std::endl;
+        LOG_INFO("Strategy running...");
         std::this_thread::sleep_for(std::chrono::seconds(1));
     }
 }
@@ -31,10 +33,8 @@ void TradingStrategy::stop() {
 }
 
 void TradingStrategy::updateMarketData(double historicalPrice) {
+    // Ring buffer keeps the last longPeriod prices without moving memory
     priceHistory.push_back(historicalPrice);
-    if (priceHistory.size() > longPeriod) {
-        priceHistory.erase(priceHistory.begin());
-    }
 }
 
 bool TradingStrategy::shouldEnterLong() const {
@@ -58,10 +58,5 @@ bool TradingStrategy::shouldExitLong() const {
 double TradingStrategy::calculateSMA(int period) const {
     if (priceHistory.size() < period) return 0.0;
     
-    double sum = std::accumulate(
-        priceHistory.end() - period,
-        priceHistory.end(),
-        0.0
-    );
-    return sum / period;
+    return windowMean(priceHistory.last(period).data(), period);
 }
\ No newline at end of file
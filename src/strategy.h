@@ -2,6 +2,7 @@
 
 #include "api.h"
 #include "order_manager.h"
+#include "series_buffer.h"
 #include <string>
 #include <atomic>
 #include <vector>
@@ -25,6 +26,6 @@ private:
     int longPeriod;
     std::atomic<bool> running;
     double lastPrice;
-    std::vector<double> priceHistory;
+    SeriesBuffer<double> priceHistory;
     double calculateSMA(int period) const;
 };
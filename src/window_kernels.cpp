@@ -0,0 +1,547 @@
+// window_kernels.cpp
+#include "window_kernels.h"
+#include "cpu_features.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define WINDOW_KERNELS_X86 1
+#endif
+
+// Every implementation has to round the same way, so multiplies and adds
+// must never be fused into FMAs (which AVX-512 targets would allow)
+#if defined(__clang__)
+#pragma clang fp contract(off)
+#elif defined(__GNUC__)
+#pragma GCC optimize("fp-contract=off")
+#endif
+
+static constexpr size_t LANES = 8;
+
+// Fixed combine order shared by every implementation
+static double combineLanes(const double* lanes) {
+    return ((lanes[0] + lanes[4]) + (lanes[1] + lanes[5])) +
+           ((lanes[2] + lanes[6]) + (lanes[3] + lanes[7]));
+}
+
+// Scalar implementations
+
+static double sumScalar(const double* x, size_t n) {
+    double lanes[LANES] = {};
+    size_t i = 0;
+    for (; i + LANES <= n; i += LANES) {
+        for (size_t j = 0; j < LANES; j++) lanes[j] += x[i + j];
+    }
+    double total = combineLanes(lanes);
+    for (; i < n; i++) total += x[i];
+    return total;
+}
+
+static double squaredDeviationsScalar(const double* x, size_t n, double mean) {
+    double lanes[LANES] = {};
+    size_t i = 0;
+    for (; i + LANES <= n; i += LANES) {
+        for (size_t j = 0; j < LANES; j++) {
+            double d = x[i + j] - mean;
+            lanes[j] += d * d;
+        }
+    }
+    double total = combineLanes(lanes);
+    for (; i < n; i++) {
+        double d = x[i] - mean;
+        total += d * d;
+    }
+    return total;
+}
+
+static double minScalar(const double* x, size_t n) {
+    double result = x[0];
+    for (size_t i = 1; i < n; i++) result = std::min(result, x[i]);
+    return result;
+}
+
+static double maxScalar(const double* x, size_t n) {
+    double result = x[0];
+    for (size_t i = 1; i < n; i++) result = std::max(result, x[i]);
+    return result;
+}
+
+static size_t countWithinScalar(const double* x, size_t n, double center, double threshold) {
+    size_t count = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (std::abs(x[i] - center) < threshold) count++;
+    }
+    return count;
+}
+
+static void trueRangeScalar(const double* high, const double* low, const double* prevClose,
+                            size_t begin, size_t n, double* out) {
+    for (size_t i = begin; i < n; i++) {
+        out[i] = std::max({high[i] - low[i],
+                           std::abs(high[i] - prevClose[i]),
+                           std::abs(low[i] - prevClose[i])});
+    }
+}
+
+static void simulatedTrueRangeScalar(const double* close, const double* prevClose, double range,
+                                     size_t begin, size_t n, double* out) {
+    double up = 1 + range;
+    double down = 1 - range;
+    for (size_t i = begin; i < n; i++) {
+        double high = close[i] * up;
+        double low = close[i] * down;
+        out[i] = std::max({high - low,
+                           std::abs(high - prevClose[i]),
+                           std::abs(low - prevClose[i])});
+    }
+}
+
+#ifdef WINDOW_KERNELS_X86
+
+// SSE2: four 2-wide accumulators cover the 8 lanes
+
+__attribute__((target("sse2")))
+static double sumSse2(const double* x, size_t n) {
+    __m128d a0 = _mm_setzero_pd(), a1 = _mm_setzero_pd(), a2 = _mm_setzero_pd(), a3 = _mm_setzero_pd();
+    size_t i = 0;
+    for (; i + LANES <= n; i += LANES) {
+        a0 = _mm_add_pd(a0, _mm_loadu_pd(x + i));
+        a1 = _mm_add_pd(a1, _mm_loadu_pd(x + i + 2));
+        a2 = _mm_add_pd(a2, _mm_loadu_pd(x + i + 4));
+        a3 = _mm_add_pd(a3, _mm_loadu_pd(x + i + 6));
+    }
+    double lanes[LANES];
+    _mm_storeu_pd(lanes, a0);
+    _mm_storeu_pd(lanes + 2, a1);
+    _mm_storeu_pd(lanes + 4, a2);
+    _mm_storeu_pd(lanes + 6, a3);
+    double total = combineLanes(lanes);
+    for (; i < n; i++) total += x[i];
+    return total;
+}
+
+__attribute__((target("sse2")))
+static double squaredDeviationsSse2(const double* x, size_t n, double mean) {
+    __m128d m = _mm_set1_pd(mean);
+    __m128d a0 = _mm_setzero_pd(), a1 = _mm_setzero_pd(), a2 = _mm_setzero_pd(), a3 = _mm_setzero_pd();
+    size_t i = 0;
+    for (; i + LANES <= n; i += LANES) {
+        __m128d d0 = _mm_sub_pd(_mm_loadu_pd(x + i), m);
+        __m128d d1 = _mm_sub_pd(_mm_loadu_pd(x + i + 2), m);
+        __m128d d2 = _mm_sub_pd(_mm_loadu_pd(x + i + 4), m);
+        __m128d d3 = _mm_sub_pd(_mm_loadu_pd(x + i + 6), m);
+        a0 = _mm_add_pd(a0, _mm_mul_pd(d0, d0));
+        a1 = _mm_add_pd(a1, _mm_mul_pd(d1, d1));
+        a2 = _mm_add_pd(a2, _mm_mul_pd(d2, d2));
+        a3 = _mm_add_pd(a3, _mm_mul_pd(d3, d3));
+    }
+    double lanes[LANES];
+    _mm_storeu_pd(lanes, a0);
+    _mm_storeu_pd(lanes + 2, a1);
+    _mm_storeu_pd(lanes + 4, a2);
+    _mm_storeu_pd(lanes + 6, a3);
+    double total = combineLanes(lanes);
+    for (; i < n; i++) {
+        double d = x[i] - mean;
+        total += d * d;
+    }
+    return total;
+}
+
+__attribute__((target("sse2")))
+static double minSse2(const double* x, size_t n) {
+    if (n < 2) return x[0];
+    __m128d m = _mm_loadu_pd(x);
+    size_t i = 2;
+    for (; i + 2 <= n; i += 2) m = _mm_min_pd(m, _mm_loadu_pd(x + i));
+    double lanes[2];
+    _mm_storeu_pd(lanes, m);
+    double result = std::min(lanes[0], lanes[1]);
+    for (; i < n; i++) result = std::min(result, x[i]);
+    return result;
+}
+
+__attribute__((target("sse2")))
+static double maxSse2(const double* x, size_t n) {
+    if (n < 2) return x[0];
+    __m128d m = _mm_loadu_pd(x);
+    size_t i = 2;
+    for (; i + 2 <= n; i += 2) m = _mm_max_pd(m, _mm_loadu_pd(x + i));
+    double lanes[2];
+    _mm_storeu_pd(lanes, m);
+    double result = std::max(lanes[0], lanes[1]);
+    for (; i < n; i++) result = std::max(result, x[i]);
+    return result;
+}
+
+__attribute__((target("sse2")))
+static size_t countWithinSse2(const double* x, size_t n, double center, double threshold) {
+    __m128d c = _mm_set1_pd(center);
+    __m128d t = _mm_set1_pd(threshold);
+    __m128d sign = _mm_set1_pd(-0.0);
+    __m128i matches = _mm_setzero_si128();  // each true compare lane is -1
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        __m128d distance = _mm_andnot_pd(sign, _mm_sub_pd(_mm_loadu_pd(x + i), c));
+        matches = _mm_sub_epi64(matches, _mm_castpd_si128(_mm_cmplt_pd(distance, t)));
+    }
+    uint64_t lanes[2];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), matches);
+    return lanes[0] + lanes[1] + countWithinScalar(x + i, n - i, center, threshold);
+}
+
+__attribute__((target("sse2")))
+static size_t trueRangeSse2(const double* high, const double* low, const double* prevClose,
+                            size_t n, double* out) {
+    __m128d sign = _mm_set1_pd(-0.0);
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        __m128d h = _mm_loadu_pd(high + i);
+        __m128d l = _mm_loadu_pd(low + i);
+        __m128d pc = _mm_loadu_pd(prevClose + i);
+        __m128d range = _mm_sub_pd(h, l);
+        __m128d upGap = _mm_andnot_pd(sign, _mm_sub_pd(h, pc));
+        __m128d downGap = _mm_andnot_pd(sign, _mm_sub_pd(l, pc));
+        _mm_storeu_pd(out + i, _mm_max_pd(_mm_max_pd(range, upGap), downGap));
+    }
+    return i;
+}
+
+__attribute__((target("sse2")))
+static size_t simulatedTrueRangeSse2(const double* close, const double* prevClose, double range,
+                                     size_t n, double* out) {
+    __m128d sign = _mm_set1_pd(-0.0);
+    __m128d up = _mm_set1_pd(1 + range);
+    __m128d down = _mm_set1_pd(1 - range);
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        __m128d c = _mm_loadu_pd(close + i);
+        __m128d pc = _mm_loadu_pd(prevClose + i);
+        __m128d h = _mm_mul_pd(c, up);
+        __m128d l = _mm_mul_pd(c, down);
+        __m128d upGap = _mm_andnot_pd(sign, _mm_sub_pd(h, pc));
+        __m128d downGap = _mm_andnot_pd(sign, _mm_sub_pd(l, pc));
+        _mm_storeu_pd(out + i, _mm_max_pd(_mm_max_pd(_mm_sub_pd(h, l), upGap), downGap));
+    }
+    return i;
+}
+
+// AVX2: two 4-wide accumulators cover the 8 lanes
+
+__attribute__((target("avx2")))
+static double sumAvx2(const double* x, size_t n) {
+    __m256d a0 = _mm256_setzero_pd(), a1 = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + LANES <= n; i += LANES) {
+        a0 = _mm256_add_pd(a0, _mm256_loadu_pd(x + i));
+        a1 = _mm256_add_pd(a1, _mm256_loadu_pd(x + i + 4));
+    }
+    double lanes[LANES];
+    _mm256_storeu_pd(lanes, a0);
+    _mm256_storeu_pd(lanes + 4, a1);
+    double total = combineLanes(lanes);
+    for (; i < n; i++) total += x[i];
+    return total;
+}
+
+__attribute__((target("avx2")))
+static double squaredDeviationsAvx2(const double* x, size_t n, double mean) {
+    __m256d m = _mm256_set1_pd(mean);
+    __m256d a0 = _mm256_setzero_pd(), a1 = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + LANES <= n; i += LANES) {
+        __m256d d0 = _mm256_sub_pd(_mm256_loadu_pd(x + i), m);
+        __m256d d1 = _mm256_sub_pd(_mm256_loadu_pd(x + i + 4), m);
+        a0 = _mm256_add_pd(a0, _mm256_mul_pd(d0, d0));
+        a1 = _mm256_add_pd(a1, _mm256_mul_pd(d1, d1));
+    }
+    double lanes[LANES];
+    _mm256_storeu_pd(lanes, a0);
+    _mm256_storeu_pd(lanes + 4, a1);
+    double total = combineLanes(lanes);
+    for (; i < n; i++) {
+        double d = x[i] - mean;
+        total += d * d;
+    }
+    return total;
+}
+
+__attribute__((target("avx2")))
+static double minAvx2(const double* x, size_t n) {
+    if (n < 4) return minScalar(x, n);
+    __m256d m = _mm256_loadu_pd(x);
+    size_t i = 4;
+    for (; i + 4 <= n; i += 4) m = _mm256_min_pd(m, _mm256_loadu_pd(x + i));
+    double lanes[4];
+    _mm256_storeu_pd(lanes, m);
+    double result = std::min(std::min(lanes[0], lanes[1]), std::min(lanes[2], lanes[3]));
+    for (; i < n; i++) result = std::min(result, x[i]);
+    return result;
+}
+
+__attribute__((target("avx2")))
+static double maxAvx2(const double* x, size_t n) {
+    if (n < 4) return maxScalar(x, n);
+    __m256d m = _mm256_loadu_pd(x);
+    size_t i = 4;
+    for (; i + 4 <= n; i += 4) m = _mm256_max_pd(m, _mm256_loadu_pd(x + i));
+    double lanes[4];
+    _mm256_storeu_pd(lanes, m);
+    double result = std::max(std::max(lanes[0], lanes[1]), std::max(lanes[2], lanes[3]));
+    for (; i < n; i++) result = std::max(result, x[i]);
+    return result;
+}
+
+__attribute__((target("avx2")))
+static size_t countWithinAvx2(const double* x, size_t n, double center, double threshold) {
+    __m256d c = _mm256_set1_pd(center);
+    __m256d t = _mm256_set1_pd(threshold);
+    __m256d sign = _mm256_set1_pd(-0.0);
+    __m256i matches = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d distance = _mm256_andnot_pd(sign, _mm256_sub_pd(_mm256_loadu_pd(x + i), c));
+        matches = _mm256_sub_epi64(matches, _mm256_castpd_si256(_mm256_cmp_pd(distance, t, _CMP_LT_OQ)));
+    }
+    uint64_t lanes[4];
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), matches);
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3] + countWithinScalar(x + i, n - i, center, threshold);
+}
+
+__attribute__((target("avx2")))
+static size_t trueRangeAvx2(const double* high, const double* low, const double* prevClose,
+                            size_t n, double* out) {
+    __m256d sign = _mm256_set1_pd(-0.0);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d h = _mm256_loadu_pd(high + i);
+        __m256d l = _mm256_loadu_pd(low + i);
+        __m256d pc = _mm256_loadu_pd(prevClose + i);
+        __m256d range = _mm256_sub_pd(h, l);
+        __m256d upGap = _mm256_andnot_pd(sign, _mm256_sub_pd(h, pc));
+        __m256d downGap = _mm256_andnot_pd(sign, _mm256_sub_pd(l, pc));
+        _mm256_storeu_pd(out + i, _mm256_max_pd(_mm256_max_pd(range, upGap), downGap));
+    }
+    return i;
+}
+
+__attribute__((target("avx2")))
+static size_t simulatedTrueRangeAvx2(const double* close, const double* prevClose, double range,
+                                     size_t n, double* out) {
+    __m256d sign = _mm256_set1_pd(-0.0);
+    __m256d up = _mm256_set1_pd(1 + range);
+    __m256d down = _mm256_set1_pd(1 - range);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d c = _mm256_loadu_pd(close + i);
+        __m256d pc = _mm256_loadu_pd(prevClose + i);
+        __m256d h = _mm256_mul_pd(c, up);
+        __m256d l = _mm256_mul_pd(c, down);
+        __m256d upGap = _mm256_andnot_pd(sign, _mm256_sub_pd(h, pc));
+        __m256d downGap = _mm256_andnot_pd(sign, _mm256_sub_pd(l, pc));
+        _mm256_storeu_pd(out + i, _mm256_max_pd(_mm256_max_pd(_mm256_sub_pd(h, l), upGap), downGap));
+    }
+    return i;
+}
+
+// AVX-512: one 8-wide accumulator is exactly the 8 lanes
+
+// GCC 12's AVX-512 headers trip -W(maybe-)uninitialized on their own
+// _mm512_undefined_*() placeholders
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+
+__attribute__((target("avx512f")))
+static double sumAvx512(const double* x, size_t n) {
+    __m512d a = _mm512_setzero_pd();
+    size_t i = 0;
+    for (; i + LANES <= n; i += LANES) a = _mm512_add_pd(a, _mm512_loadu_pd(x + i));
+    double lanes[LANES];
+    _mm512_storeu_pd(lanes, a);
+    double total = combineLanes(lanes);
+    for (; i < n; i++) total += x[i];
+    return total;
+}
+
+__attribute__((target("avx512f")))
+static double squaredDeviationsAvx512(const double* x, size_t n, double mean) {
+    __m512d m = _mm512_set1_pd(mean);
+    __m512d a = _mm512_setzero_pd();
+    size_t i = 0;
+    for (; i + LANES <= n; i += LANES) {
+        __m512d d = _mm512_sub_pd(_mm512_loadu_pd(x + i), m);
+        a = _mm512_add_pd(a, _mm512_mul_pd(d, d));
+    }
+    double lanes[LANES];
+    _mm512_storeu_pd(lanes, a);
+    double total = combineLanes(lanes);
+    for (; i < n; i++) {
+        double d = x[i] - mean;
+        total += d * d;
+    }
+    return total;
+}
+
+__attribute__((target("avx512f")))
+static double minAvx512(const double* x, size_t n) {
+    if (n < 8) return minAvx2(x, n);
+    __m512d m = _mm512_loadu_pd(x);
+    size_t i = 8;
+    for (; i + 8 <= n; i += 8) m = _mm512_min_pd(m, _mm512_loadu_pd(x + i));
+    double result = _mm512_reduce_min_pd(m);
+    for (; i < n; i++) result = std::min(result, x[i]);
+    return result;
+}
+
+__attribute__((target("avx512f")))
+static double maxAvx512(const double* x, size_t n) {
+    if (n < 8) return maxAvx2(x, n);
+    __m512d m = _mm512_loadu_pd(x);
+    size_t i = 8;
+    for (; i + 8 <= n; i += 8) m = _mm512_max_pd(m, _mm512_loadu_pd(x + i));
+    double result = _mm512_reduce_max_pd(m);
+    for (; i < n; i++) result = std::max(result, x[i]);
+    return result;
+}
+
+__attribute__((target("avx512f")))
+static size_t countWithinAvx512(const double* x, size_t n, double center, double threshold) {
+    __m512d c = _mm512_set1_pd(center);
+    __m512d t = _mm512_set1_pd(threshold);
+    __m512i matches = _mm512_setzero_si512();
+    __m512i one = _mm512_set1_epi64(1);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m512d distance = _mm512_abs_pd(_mm512_sub_pd(_mm512_loadu_pd(x + i), c));
+        __mmask8 within = _mm512_cmp_pd_mask(distance, t, _CMP_LT_OQ);
+        matches = _mm512_mask_add_epi64(matches, within, matches, one);
+    }
+    return _mm512_reduce_add_epi64(matches) + countWithinScalar(x + i, n - i, center, threshold);
+}
+
+__attribute__((target("avx512f")))
+static size_t trueRangeAvx512(const double* high, const double* low, const double* prevClose,
+                              size_t n, double* out) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m512d h = _mm512_loadu_pd(high + i);
+        __m512d l = _mm512_loadu_pd(low + i);
+        __m512d pc = _mm512_loadu_pd(prevClose + i);
+        __m512d range = _mm512_sub_pd(h, l);
+        __m512d upGap = _mm512_abs_pd(_mm512_sub_pd(h, pc));
+        __m512d downGap = _mm512_abs_pd(_mm512_sub_pd(l, pc));
+        _mm512_storeu_pd(out + i, _mm512_max_pd(_mm512_max_pd(range, upGap), downGap));
+    }
+    return i;
+}
+
+__attribute__((target("avx512f")))
+static size_t simulatedTrueRangeAvx512(const double* close, const double* prevClose, double range,
+                                       size_t n, double* out) {
+    __m512d up = _mm512_set1_pd(1 + range);
+    __m512d down = _mm512_set1_pd(1 - range);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m512d c = _mm512_loadu_pd(close + i);
+        __m512d pc = _mm512_loadu_pd(prevClose + i);
+        __m512d h = _mm512_mul_pd(c, up);
+        __m512d l = _mm512_mul_pd(c, down);
+        __m512d upGap = _mm512_abs_pd(_mm512_sub_pd(h, pc));
+        __m512d downGap = _mm512_abs_pd(_mm512_sub_pd(l, pc));
+        _mm512_storeu_pd(out + i, _mm512_max_pd(_mm512_max_pd(_mm512_sub_pd(h, l), upGap), downGap));
+    }
+    return i;
+}
+
+#pragma GCC diagnostic pop
+
+#endif
+
+double windowSum(const double* x, size_t n) {
+    switch (simdLevel()) {
+#ifdef WINDOW_KERNELS_X86
+        case SimdLevel::AVX512: return sumAvx512(x, n);
+        case SimdLevel::AVX2: return sumAvx2(x, n);
+        case SimdLevel::SSE2: return sumSse2(x, n);
+#endif
+        default: return sumScalar(x, n);
+    }
+}
+
+double windowMean(const double* x, size_t n) {
+    return windowSum(x, n) / n;
+}
+
+double windowVariance(const double* x, size_t n) {
+    double mean = windowMean(x, n);
+    switch (simdLevel()) {
+#ifdef WINDOW_KERNELS_X86
+        case SimdLevel::AVX512: return squaredDeviationsAvx512(x, n, mean) / n;
+        case SimdLevel::AVX2: return squaredDeviationsAvx2(x, n, mean) / n;
+        case SimdLevel::SSE2: return squaredDeviationsSse2(x, n, mean) / n;
+#endif
+        default: return squaredDeviationsScalar(x, n, mean) / n;
+    }
+}
+
+double windowMin(const double* x, size_t n) {
+    switch (simdLevel()) {
+#ifdef WINDOW_KERNELS_X86
+        case SimdLevel::AVX512: return minAvx512(x, n);
+        case SimdLevel::AVX2: return minAvx2(x, n);
+        case SimdLevel::SSE2: return minSse2(x, n);
+#endif
+        default: return minScalar(x, n);
+    }
+}
+
+double windowMax(const double* x, size_t n) {
+    switch (simdLevel()) {
+#ifdef WINDOW_KERNELS_X86
+        case SimdLevel::AVX512: return maxAvx512(x, n);
+        case SimdLevel::AVX2: return maxAvx2(x, n);
+        case SimdLevel::SSE2: return maxSse2(x, n);
+#endif
+        default: return maxScalar(x, n);
+    }
+}
+
+size_t countWithin(const double* x, size_t n, double center, double threshold) {
+    switch (simdLevel()) {
+#ifdef WINDOW_KERNELS_X86
+        case SimdLevel::AVX512: return countWithinAvx512(x, n, center, threshold);
+        case SimdLevel::AVX2: return countWithinAvx2(x, n, center, threshold);
+        case SimdLevel::SSE2: return countWithinSse2(x, n, center, threshold);
+#endif
+        default: return countWithinScalar(x, n, center, threshold);
+    }
+}
+
+void trueRange(const double* high, const double* low, const double* prevClose, size_t n, double* out) {
+    size_t done = 0;
+    switch (simdLevel()) {
+#ifdef WINDOW_KERNELS_X86
+        case SimdLevel::AVX512: done = trueRangeAvx512(high, low, prevClose, n, out); break;
+        case SimdLevel::AVX2: done = trueRangeAvx2(high, low, prevClose, n, out); break;
+        case SimdLevel::SSE2: done = trueRangeSse2(high, low, prevClose, n, out); break;
+#endif
+        default: break;
+    }
+    trueRangeScalar(high, low, prevClose, done, n, out);
+}
+
+void simulatedTrueRange(const double* close, const double* prevClose, double range, size_t n, double* out) {
+    size_t done = 0;
+    switch (simdLevel()) {
+#ifdef WINDOW_KERNELS_X86
+        case SimdLevel::AVX512: done = simulatedTrueRangeAvx512(close, prevClose, range, n, out); break;
+        case SimdLevel::AVX2: done = simulatedTrueRangeAvx2(close, prevClose, range, n, out); break;
+        case SimdLevel::SSE2: done = simulatedTrueRangeSse2(close, prevClose, range, n, out); break;
+#endif
+        default: break;
+    }
+    simulatedTrueRangeScalar(close, prevClose, range, done, n, out);
+}
@@ -0,0 +1,30 @@
+// window_kernels.h
+#pragma once
+#include <cstddef>
+
+// Vectorized reductions over a window of values, e.g. the trailing `period`
+// entries of a price history. Each call dispatches on simdLevel() to an
+// AVX-512, AVX2, SSE2 or scalar implementation.
+//
+// Sums are accumulated in 8 interleaved lanes (lane j takes x[j], x[j+8], ...)
+// that are combined in a fixed order, so every implementation returns the
+// same bits. Windows shorter than 8 are summed front to back, exactly like
+// std::accumulate.
+
+double windowSum(const double* x, size_t n);
+double windowMean(const double* x, size_t n);
+double windowVariance(const double* x, size_t n);  // population variance
+
+// n must be > 0
+double windowMin(const double* x, size_t n);
+double windowMax(const double* x, size_t n);
+
+// Number of values with |x[i] - center| < threshold
+size_t countWithin(const double* x, size_t n, double center, double threshold);
+
+// out[i] = max(high[i] - low[i], |high[i] - prevClose[i]|, |low[i] - prevClose[i]|)
+// Pass prevClose = close - 1 with the other columns starting at bar 1.
+void trueRange(const double* high, const double* low, const double* prevClose, size_t n, double* out);
+
+// trueRange() over a high/low of close * (1 +/- range)
+void simulatedTrueRange(const double* close, const double* prevClose, double range, size_t n, double* out);
@@ -0,0 +1,122 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <future>
+#include <chrono>
+#include <cstdlib>
+#include <curl/curl.h>
+#include "async_http.h"
+#include "connection_pool.h"
+
+using Clock = std::chrono::steady_clock;
+
+static double msSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+static size_t discardBody(void*, size_t size, size_t nmemb, void*) {
+    return size * nmemb;
+}
+
+// One blocking request on a pooled handle, as send_public_request does it
+static bool blockingGet(const std::string& url) {
+    ConnectionPool::Handle handle = ConnectionPool::getInstance().acquire();
+    if (!handle) return false;
+    curl_easy_setopt(handle.get(), CURLOPT_URL, url.c_str());
+    curl_easy_setopt(handle.get(), CURLOPT_HTTPGET, 1L);
+    curl_easy_setopt(handle.get(), CURLOPT_WRITEFUNCTION, discardBody);
+    CURLcode res = curl_easy_perform(handle.get());
+    if (res != CURLE_OK) std::cerr << url << ": " << curl_easy_strerror(res) << std::endl;
+    return res == CURLE_OK;
+}
+
+static HttpRequest get(const std::string& url) {
+    HttpRequest request;
+    request.url = url;
+    return request;
+}
+
+// `count` ticker requests one after another, then all submitted at once to
+// the async engine; false if any failed
+static bool compare(const std::string& url, size_t count) {
+    Clock::time_point start = Clock::now();
+    for (size_t i = 0; i < count; i++) {
+        if (!blockingGet(url)) return false;
+    }
+    double sequentialMs = msSince(start);
+
+    AsyncHttpClient& client = AsyncHttpClient::getInstance();
+    start = Clock::now();
+    std::vector<std::future<HttpResponse>> futures;
+    for (size_t i = 0; i < count; i++) futures.push_back(client.submit(get(url)));
+    for (std::future<HttpResponse>& future : futures) {
+        HttpResponse response = future.get();
+        if (!response.ok() || response.status != 200) {
+            std::cerr << url << ": " << curl_easy_strerror(response.result) << ", status " << response.status
+                      << std::endl;
+            return false;
+        }
+    }
+    double asyncMs = msSince(start);
+
+    std::cout << count << " requests: sequential " << sequentialMs << " ms, async " << asyncMs << " ms ("
+              << sequentialMs / asyncMs << "x)" << std::endl;
+    return true;
+}
+
+// A request retrying against a dead port must not hold up the others: the
+// loop waits out its backoff on a timer, not in a sleeping call
+static bool retryDoesNotBlock(const std::string& url, const std::string& deadUrl) {
+    HttpRequest dead = get(deadUrl);
+    dead.retry.attempts = 3;
+    dead.retry.backoff = std::chrono::milliseconds(200);
+
+    AsyncHttpClient& client = AsyncHttpClient::getInstance();
+    Clock::time_point start = Clock::now();
+    std::future<HttpResponse> failing = client.submit(dead);
+    std::future<HttpResponse> live = client.submit(get(url));
+    HttpResponse liveResponse = live.get();
+    double liveMs = msSince(start);
+    HttpResponse failedResponse = failing.get();
+    double deadMs = msSince(start);
+
+    std::cout << "Dead port: " << failedResponse.attempts << " tries in " << deadMs
+              << " ms; a concurrent request completed in " << liveMs << " ms" << std::endl;
+    if (!liveResponse.ok() || failedResponse.ok() || liveMs >= deadMs) {
+        std::cerr << "The request to the live server waited for the retries" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// Sequential blocking requests against the same requests in flight at once
+// on AsyncHttpClient (max_host_connections apply), and a retry running next
+// to a live request. Meant for a stand-in with injected latency, e.g.
+//   limit_server --port 8080 --delay 50 &
+//   async_bench [--url http://127.0.0.1:8080] [--dead-port 9] [counts...]
+// Counts default to 32 and 64 requests.
+int main(int argc, char* argv[]) {
+    std::string base = "http://127.0.0.1:8080";
+    std::string deadPort = "9";
+    std::vector<size_t> counts;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--url" && i + 1 < argc) base = argv[++i];
+        else if (arg == "--dead-port" && i + 1 < argc) deadPort = argv[++i];
+        else if (std::strtoul(arg.c_str(), nullptr, 10) > 0) counts.push_back(std::strtoul(arg.c_str(), nullptr, 10));
+        else {
+            std::cerr << "Usage: " << argv[0] << " [--url http://127.0.0.1:8080] [--dead-port 9] [counts...]"
+                      << std::endl;
+            return 1;
+        }
+    }
+    if (counts.empty()) counts = {32, 64};
+    const std::string url = base + "/api/v3/ticker/price?symbol=BTCUSDT";
+
+    // Connect once so no run pays for the first connection alone
+    if (!blockingGet(url)) return 1;
+    for (size_t count : counts) {
+        if (!compare(url, count)) return 1;
+    }
+    return retryDoesNotBlock(url, "http://127.0.0.1:" + deadPort + "/api/v3/ticker/price") ? 0 : 1;
+}
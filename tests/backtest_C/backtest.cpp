@@ -7,22 +7,71 @@
 #include "order_manager.h"
 #include "enhanced_strategy.h"
 
-int main() {
+static bool sameTrade(const TradeResult& a, const TradeResult& b) {
+    return a.type == b.type && a.entryTime == b.entryTime && a.exitTime == b.exitTime &&
+           a.entryPrice == b.entryPrice && a.exitPrice == b.exitPrice &&
+           a.quantity == b.quantity && a.profit == b.profit;
+}
+
+// Runs the per-bar and vectorized signal paths over the same data and
+// checks that they produce exactly the same trades
+static int compareSignalPaths(BinanceAPI& api, OrderManager& orderManager, const std::string& dataFile) {
+    EnhancedTradingStrategy perBarStrategy(api, orderManager, "BTCUSDT", 12, 26, 9, 14, 70, 30);
+    EnhancedTradingStrategy vectorStrategy(api, orderManager, "BTCUSDT", 12, 26, 9, 14, 70, 30);
+    Backtester perBar(perBarStrategy);
+    Backtester vectorized(vectorStrategy);
+    perBar.loadHistoricalData(dataFile);
+    vectorized.loadHistoricalData(dataFile);
+    perBar.run();
+    vectorized.runVectorized();
+
+    const std::vector<TradeResult>& expected = perBar.getTrades();
+    const std::vector<TradeResult>& actual = vectorized.getTrades();
+    for (size_t i = 0; i < std::max(expected.size(), actual.size()); i++) {
+        if (i >= expected.size() || i >= actual.size() || !sameTrade(expected[i], actual[i])) {
+            std::cerr << "Signal paths diverge at trade " << i << " (per-bar: " << expected.size()
+                      << " trades, vectorized: " << actual.size() << " trades)" << std::endl;
+            return 1;
+        }
+    }
+    std::cout << "Per-bar and vectorized (" << signalKernelIsa() << ") signals agree on all "
+              << expected.size() << " trades" << std::endl;
+    return 0;
+}
+
+// Usage: backtest [--vectorized | --compare] [data file]
+int main(int argc, char* argv[]) {
     BinanceAPI api;
     OrderManager orderManager;
-    
+
+    std::string dataFile = "tests/historical_data/BTCUSDT_1m_historical_data.csv";
+    bool vectorized = false;
+    bool compare = false;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--vectorized") vectorized = true;
+        else if (arg == "--compare") compare = true;
+        else dataFile = arg;  // CSV or a bar store written by convert_bars
+    }
+
+    if (compare) {
+        return compareSignalPaths(api, orderManager, dataFile);
+    }
+
     // Create enhanced strategy with parameters
     EnhancedTradingStrategy strategy(api, orderManager, "BTCUSDT",
                                    12, 26, 9,   // MACD parameters
                                    14, 70, 30); // RSI parameters
-    
+
     // Initialize backtester with strategy
     Backtester backtester(strategy);
-    
+
     // Load and run backtest
-    backtester.loadHistoricalData("tests/historical_data/BTCUSDT_1m_historical_data.csv");
-    backtester.run();
-    backtester.generateReport();
-    
-    return 0;
-}
\ No newline at end of file
+    backtester.loadHistoricalData(dataFile);
+    if (vectorized) {
+        backtester.runVectorized();
+    } else {
+        backtester.run();
+    }
+    return backtester.generateReport() ? 0 : 1;
+}
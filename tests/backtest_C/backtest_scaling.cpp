@@ -0,0 +1,136 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "api.h"
+#include "backtester.h"
+#include "bar_store.h"
+#include "order_manager.h"
+#include "enhanced_strategy.h"
+
+// Random-walk 1m bars, mean-reverting around 30000 so the strategy keeps
+// trading at any length; the same seed always gives the same bars
+static BarTable syntheticBars(size_t count, uint64_t seed) {
+    BarTable table;
+    table.reserve(count);
+    std::mt19937_64 rng(seed);
+    std::normal_distribution<double> move(0.0, 0.0015);
+    std::uniform_real_distribution<double> wick(0.0, 0.001);
+    std::lognormal_distribution<double> volume(3.0, 0.8);
+
+    int64_t ts = 1577836800;   // 2020-01-01 00:00:00
+    double close = 30000.0;
+    for (size_t i = 0; i < count; i++) {
+        double open = close;
+        close = open * std::exp(move(rng) - 0.001 * std::log(open / 30000.0));
+        double high = std::max(open, close) * (1.0 + wick(rng));
+        double low = std::min(open, close) * (1.0 - wick(rng));
+        table.append(ts, open, high, low, close, volume(rng));
+        ts += 60;
+    }
+    return table;
+}
+
+static bool writeSyntheticStore(const std::string& filename, size_t count) {
+    BarTable table = syntheticBars(count, 42);
+    if (!BarStore::write(filename, table.columns())) return false;
+    std::cout << "Wrote " << count << " synthetic bars to " << filename << std::endl;
+    return true;
+}
+
+struct Timing {
+    size_t bars = 0;
+    double loadSeconds = 0;
+    double runSeconds = 0;
+    int trades = 0;
+};
+
+// Maps the store and runs the per-bar backtest over it with a fresh strategy
+static bool timeBacktest(BinanceAPI& api, OrderManager& orderManager, const std::string& filename, Timing& timing) {
+    EnhancedTradingStrategy strategy(api, orderManager, "BTCUSDT", 12, 26, 9, 14, 70, 30);
+    Backtester backtester(strategy);
+
+    auto start = std::chrono::steady_clock::now();
+    backtester.loadHistoricalData(filename);
+    auto loaded = std::chrono::steady_clock::now();
+    backtester.run();
+    auto done = std::chrono::steady_clock::now();
+
+    timing.bars = strategy.getIndicatorStats().bars;
+    timing.loadSeconds = std::chrono::duration<double>(loaded - start).count();
+    timing.runSeconds = std::chrono::duration<double>(done - loaded).count();
+    timing.trades = backtester.getResults().totalTrades;
+    return timing.bars > 0;
+}
+
+// Writes a synthetic bar store:
+//   backtest_scaling --write 1000000 BTCUSDT_synthetic.bars
+// or writes stores of each size (default 1k, 10k, 100k, 1M and 10M bars)
+// into a scratch directory, times a backtest over each and checks the time
+// per bar stays flat, i.e. runtime grows linearly with the number of bars:
+//   backtest_scaling [--dir /tmp] [bars...]
+// Sizes below 100k are reported but not checked; their fixed costs dominate.
+int main(int argc, char* argv[]) {
+    if (argc == 4 && std::strcmp(argv[1], "--write") == 0) {
+        return writeSyntheticStore(argv[3], std::strtoull(argv[2], nullptr, 10)) ? 0 : 1;
+    }
+
+    std::string dir = "/tmp";
+    std::vector<size_t> sizes;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--dir") == 0 && i + 1 < argc) {
+            dir = argv[++i];
+        } else {
+            size_t bars = std::strtoull(argv[i], nullptr, 10);
+            if (bars == 0) {
+                std::cerr << "Usage: " << argv[0] << " --write <bars> <output.bars>\n"
+                          << "       " << argv[0] << " [--dir <scratch dir>] [bars...]" << std::endl;
+                return 1;
+            }
+            sizes.push_back(bars);
+        }
+    }
+    if (sizes.empty()) sizes = {1000, 10000, 100000, 1000000, 10000000};
+
+    BinanceAPI api;
+    OrderManager orderManager;
+
+    const size_t checkedFrom = 100000;
+    const double maxGrowth = 1.5;   // allowed rise in ns/bar over the first checked size
+    double baseline = 0;
+    bool linear = true;
+    for (size_t bars : sizes) {
+        std::string filename = dir + "/backtest_scaling_" + std::to_string(bars) + ".bars";
+        if (!writeSyntheticStore(filename, bars)) return 1;
+
+        Timing timing;
+        bool ok = timeBacktest(api, orderManager, filename, timing);
+        std::remove(filename.c_str());
+        if (!ok || timing.bars != bars) {
+            std::cerr << "Backtest over " << filename << " processed " << timing.bars << " bars" << std::endl;
+            return 1;
+        }
+
+        double nsPerBar = timing.runSeconds * 1e9 / bars;
+        std::cout << bars << " bars: load " << timing.loadSeconds * 1000 << " ms, run "
+                  << timing.runSeconds * 1000 << " ms, " << nsPerBar << " ns/bar, "
+                  << timing.trades << " trades" << std::endl;
+
+        if (bars < checkedFrom) continue;
+        if (baseline == 0) {
+            baseline = nsPerBar;
+        } else if (nsPerBar > baseline * maxGrowth) {
+            std::cerr << "Not linear: " << nsPerBar << " ns/bar at " << bars << " bars, "
+                      << baseline << " ns/bar at the first checked size" << std::endl;
+            linear = false;
+        }
+    }
+    if (!linear) return 1;
+    if (baseline > 0) std::cout << "Runtime linear in bars (ns/bar within " << maxGrowth << "x)" << std::endl;
+    return 0;
+}
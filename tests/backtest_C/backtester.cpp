@@ -1,115 +1,189 @@
 #include "backtester.h"
-#include <fstream>
-#include <sstream>
+#include "window_kernels.h"
 #include <iostream>
 #include <cmath>
 #include <algorithm>
 #include <numeric>
+#include <memory>
 
 void Backtester::loadHistoricalData(const std::string& filename) {
-    std::ifstream file(filename);
-    std::string line;
+    barStore.close();
+    barTable = BarTable();
+    bars = BarColumns();
     
-    // Skip header
-    std::getline(file, line);
-    
-    while (std::getline(file, line)) {
-        std::stringstream ss(line);
-        std::string token;
-        HistoricalBar bar;
-        
-        std::getline(ss, bar.timestamp, ',');
-        std::getline(ss, token, ','); bar.open = std::stod(token);
-        std::getline(ss, token, ','); bar.high = std::stod(token);
-        std::getline(ss, token, ','); bar.low = std::stod(token);
-        std::getline(ss, token, ','); bar.close = std::stod(token);
-        std::getline(ss, token, ','); bar.volume = std::stod(token);
-        
-        historicalData.push_back(bar);
+    // Binary bar stores are mapped in place; CSV is parsed into owned columns
+    if (BarStore::isBarStore(filename)) {
+        if (barStore.open(filename)) {
+            bars = barStore.columns();
+        }
+    } else if (loadBarsCsv(filename, barTable)) {
+        bars = barTable.columns();
     }
 }
 
+void Backtester::setHistoricalData(const BarColumns& data) {
+    barStore.close();
+    barTable = BarTable();
+    bars = data;
+}
+
 void Backtester::simulateTrade(const HistoricalBar& bar) {
     strategy->updateMarketData(bar.close, bar.volume);
     
     if (strategy->shouldEnterLong() && !inPosition) {
-        // Risk only 1% of capital per trade
-        double riskAmount = capital * 0.01;
-        double atr = calculateATR(14, bar);
-        double stopLoss = 2 * atr;  // 2 ATR stop loss
-        
-        // Calculate position size based on risk
-        double quantity = riskAmount / stopLoss;
-        quantity = std::floor(quantity * 1000) / 1000;  // Round to 3 decimals
-        
-        if (quantity * bar.close > capital * 0.1) {  // Max 10% of capital per trade
-            quantity = (capital * 0.1) / bar.close;
-        }
-        
-        // Record trade
-        TradeResult trade;
-        trade.entryPrice = bar.close;
-        trade.type = "LONG";
-        trade.entryTime = bar.timestamp;
-        trade.quantity = quantity;
-        
-        capital -= quantity * bar.close * (1 + fees);
-        currentPosition = quantity;
-        inPosition = true;
-        trades.push_back(trade);
+        openLong(bar);
     }
     else if (strategy->shouldExitLong() && inPosition) {
-        trades.back().exitPrice = bar.close;
-        trades.back().exitTime = bar.timestamp;
-        
-        double exitValue = currentPosition * bar.close * (1 - fees);
-        capital += exitValue;
-        
-        trades.back().profit = exitValue - 
-            (trades.back().quantity * trades.back().entryPrice * (1 + fees));
-        
-        currentPosition = 0;
-        inPosition = false;
+        closeLong(bar);
+    }
+}
+
+void Backtester::openLong(const HistoricalBar& bar) {
+    // Risk only 1% of capital per trade
+    double riskAmount = capital.toDouble() * 0.01;
+    double stopLoss = 2 * atr.value();  // 2 ATR stop loss
+    
+    // Calculate position size based on risk, rounded to 3 decimals
+    Decimal quantity = Decimal::fromDouble(riskAmount / stopLoss).roundDown(quantityStep);
+    
+    if (quantity.toDouble() * bar.close > capital.toDouble() * 0.1) {  // Max 10% of capital per trade
+        quantity = Decimal::fromDouble((capital.toDouble() * 0.1) / bar.close);
     }
+    Decimal price = Decimal::fromDouble(bar.close);
+    
+    // Record trade
+    TradeResult trade;
+    trade.entryPrice = price;
+    trade.type = "LONG";
+    trade.entryTime = bar.timestamp;
+    trade.quantity = quantity;
+    
+    Decimal cost = quantity * price;
+    capital -= cost + cost * fees;
+    currentPosition = quantity;
+    inPosition = true;
+    trades.push_back(trade);
+}
+
+void Backtester::closeLong(const HistoricalBar& bar) {
+    TradeResult& trade = trades.back();
+    trade.exitPrice = Decimal::fromDouble(bar.close);
+    trade.exitTime = bar.timestamp;
+    
+    Decimal proceeds = currentPosition * trade.exitPrice;
+    Decimal exitValue = proceeds - proceeds * fees;
+    capital += exitValue;
+    
+    Decimal cost = trade.quantity * trade.entryPrice;
+    trade.profit = exitValue - (cost + cost * fees);
+    
+    currentPosition = Decimal();
+    inPosition = false;
 }
 
 void Backtester::run() {
-    for (const auto& bar : historicalData) {
+    signalMode = "per-bar";
+    atr = ATRIndicator(ATR_PERIOD);
+    for (size_t i = 0; i < bars.count; i++) {
+        HistoricalBar bar = barAt(i);
+        atr.update(bar.high, bar.low, bar.close);
         simulateTrade(bar);
     }
 }
 
-void Backtester::generateReport() {
+void Backtester::runVectorized(IndicatorCache* cache) {
+    std::unique_ptr<IndicatorCache> ownCache;
+    if (!cache) {
+        ownCache = std::make_unique<IndicatorCache>(bars);
+        cache = ownCache.get();
+    }
+    if (cache->size() != bars.count) {
+        std::cerr << "Indicator cache covers " << cache->size() << " bars, expected "
+                  << bars.count << std::endl;
+        return;
+    }
+    
+    signalMode = signalKernelIsa();
+    EnhancedTradingStrategy::LongSignals signals = strategy->evaluateLongSignals(*cache);
+    
+    atr = ATRIndicator(ATR_PERIOD);
+    for (size_t i = 0; i < bars.count; i++) {
+        HistoricalBar bar = barAt(i);
+        atr.update(bar.high, bar.low, bar.close);
+        
+        if (signals.enter.test(i) && !inPosition) {
+            openLong(bar);
+        }
+        else if (signals.exit.test(i) && inPosition) {
+            closeLong(bar);
+        }
+    }
+}
+
+BacktestResult Backtester::getResults() const {
     // Calculate key metrics
     int totalTrades = trades.size();
     int profitableTrades = std::count_if(trades.begin(), trades.end(),
-        [](const TradeResult& trade) { return trade.profit > 0; });
-    
-    double totalProfit = std::accumulate(trades.begin(), trades.end(), 0.0,
-        [](double sum, const TradeResult& trade) { return sum + trade.profit; });
+        [](const TradeResult& trade) { return trade.profit > Decimal(); });
     
-    double winRate = (double)profitableTrades / totalTrades * 100;
-    double maxDrawdown = calculateDrawdown();
-    double sharpeRatio = calculateSharpeRatio();
+    BacktestResult result;
+    result.finalCapital = capital.toDouble();
+    result.totalReturn = (capital - initialCapital).toDouble() / initialCapital.toDouble() * 100;
+    result.totalTrades = totalTrades;
+    result.winRate = (double)profitableTrades / totalTrades * 100;
+    result.maxDrawdown = calculateDrawdown();
+    result.sharpeRatio = calculateSharpeRatio();
+    return result;
+}
+
+bool Backtester::generateReport() {
+    BacktestResult result = getResults();
     
     // Print report
     std::cout << "\n=== Backtesting Results ===\n";
-    std::cout << "Initial Capital: $" << initialCapital << "\n";
-    std::cout << "Final Capital: $" << capital << "\n";
-    std::cout << "Total Return: " << ((capital - initialCapital) / initialCapital * 100) << "%\n";
-    std::cout << "Total Trades: " << totalTrades << "\n";
-    std::cout << "Win Rate: " << winRate << "%\n";
-    std::cout << "Max Drawdown: " << maxDrawdown << "%\n";
-    std::cout << "Sharpe Ratio: " << sharpeRatio << "\n";
+    std::cout << "Initial Capital: $" << initialCapital.toDouble() << "\n";
+    std::cout << "Final Capital: $" << result.finalCapital << "\n";
+    std::cout << "Total Return: " << result.totalReturn << "%\n";
+    std::cout << "Total Trades: " << result.totalTrades << "\n";
+    std::cout << "Win Rate: " << result.winRate << "%\n";
+    std::cout << "Max Drawdown: " << result.maxDrawdown << "%\n";
+    std::cout << "Sharpe Ratio: " << result.sharpeRatio << "\n";
+    
+    std::cout << "Signal Evaluation: " << signalMode << "\n";
+    
+    // Indicator work: the snapshot is shared by every signal check in a bar
+    EnhancedTradingStrategy::IndicatorStats stats = strategy->getIndicatorStats();
+    std::cout << "Bars Processed: " << stats.bars << "\n";
+    std::cout << "Indicator Snapshots: " << stats.snapshotBuilds
+              << " (" << stats.snapshotReads << " signal reads)\n";
+    if (stats.fromCache) {
+        std::cout << "Indicator Updates: none, values read from the indicator cache\n";
+        return true;
+    }
+    
+    // Each streaming indicator must see every bar exactly once
+    bool oncePerBar = true;
+    for (int i = 0; i < EnhancedTradingStrategy::INDICATORS; i++) {
+        if (stats.updates[i] != stats.bars) {
+            std::cerr << "Indicator " << EnhancedTradingStrategy::indicatorName(i) << " updated "
+                      << stats.updates[i] << " times over " << stats.bars << " bars" << std::endl;
+            oncePerBar = false;
+        }
+    }
+    if (oncePerBar) {
+        std::cout << "Indicator Updates: " << EnhancedTradingStrategy::INDICATORS
+                  << " indicators, each once per bar\n";
+    }
+    return oncePerBar;
 }
 
-double Backtester::calculateDrawdown() {
-    double maxCapital = initialCapital;
+double Backtester::calculateDrawdown() const {
+    double maxCapital = initialCapital.toDouble();
     double maxDrawdown = 0;
     
     for (const auto& trade : trades) {
-        double currentCapital = capital + 
-            (currentPosition * trade.exitPrice * (1 - fees));
+        Decimal proceeds = currentPosition * trade.exitPrice;
+        double currentCapital = (capital + proceeds - proceeds * fees).toDouble();
         
         maxCapital = std::max(maxCapital, currentCapital);
         double drawdown = (maxCapital - currentCapital) / maxCapital * 100;
@@ -119,25 +193,18 @@ double Backtester::calculateDrawdown() {
     return maxDrawdown;
 }
 
-double Backtester::calculateSharpeRatio() {
+double Backtester::calculateSharpeRatio() const {
     std::vector<double> returns;
-    double prevCapital = initialCapital;
+    double prevCapital = initialCapital.toDouble();
     
     for (const auto& trade : trades) {
-        double currentCapital = prevCapital + trade.profit;
+        double currentCapital = prevCapital + trade.profit.toDouble();
         double returnPct = (currentCapital - prevCapital) / prevCapital;
         returns.push_back(returnPct);
         prevCapital = currentCapital;
     }
     
-    double meanReturn = std::accumulate(returns.begin(), returns.end(), 0.0) / returns.size();
-    
-    double variance = 0;
-    for (double r : returns) {
-        variance += std::pow(r - meanReturn, 2);
-    }
-    variance /= returns.size();
-    
-    double stdDev = std::sqrt(variance);
+    double meanReturn = windowMean(returns.data(), returns.size());
+    double stdDev = std::sqrt(windowVariance(returns.data(), returns.size()));
     return meanReturn / stdDev * std::sqrt(252);  // Annualized Sharpe Ratio
 }
\ No newline at end of file
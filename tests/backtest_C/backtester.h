@@ -3,31 +3,63 @@
 #include <vector>
 #include <string>
 #include <map>
+#include <cstdint>
+#include <algorithm>
 #include "enhanced_strategy.h"
+#include "indicators.h"
+#include "bar_store.h"
+#include "decimal.h"
 
+// Prices, quantities and money are exact; fees are rounded to 1e-8
 struct TradeResult {
-    double entryPrice;
-    double exitPrice;
+    Decimal entryPrice;
+    Decimal exitPrice;
     std::string type;  // "LONG" or "SHORT"
-    std::string entryTime;
-    std::string exitTime;
-    double profit;
-    double quantity;
+    int64_t entryTime = 0;  // epoch seconds
+    int64_t exitTime = 0;
+    Decimal profit;    // after fees on both sides
+    Decimal quantity;
+};
+
+struct BacktestResult {
+    double finalCapital;
+    double totalReturn;  // %
+    int totalTrades;
+    double winRate;      // %
+    double maxDrawdown;  // %
+    double sharpeRatio;
 };
 
 class Backtester {
 public:
     // Changed constructor to use EnhancedTradingStrategy
     Backtester(EnhancedTradingStrategy& strategy, double initialCapital = 10000.0)
-        : strategy(&strategy), capital(initialCapital), initialCapital(initialCapital) {}
+        : strategy(&strategy)
+        , capital(Decimal::fromDouble(initialCapital))
+        , initialCapital(Decimal::fromDouble(initialCapital)) {}
 
+    // Accepts either a bar store (see convert_bars) or a CSV file
     void loadHistoricalData(const std::string& filename);
+    
+    // Use bar data owned by the caller, e.g. one dataset shared by a parameter sweep
+    void setHistoricalData(const BarColumns& data);
+    
     void run();
-    void generateReport();
+    
+    // Same trades as run(), but the strategy's long entry/exit signals are
+    // evaluated for the whole dataset up front and the simulation just walks
+    // them. Uses `cache` when given, otherwise a private one over the loaded bars.
+    void runVectorized(IndicatorCache* cache = nullptr);
+    
+    BacktestResult getResults() const;
+    const std::vector<TradeResult>& getTrades() const { return trades; }
+    // Prints the results; false if an indicator was not updated exactly
+    // once per bar
+    bool generateReport();
 
 private:
     struct HistoricalBar {
-        std::string timestamp;
+        int64_t timestamp;
         double open;
         double high;
         double low;
@@ -35,49 +67,37 @@ private:
         double volume;
     };
 
-    // Add ATR calculation helper functions
-    double calculateTR(const HistoricalBar& current, const HistoricalBar& prev) const {
-        double hl = current.high - current.low;
-        double hc = std::abs(current.high - prev.close);
-        double lc = std::abs(current.low - prev.close);
-        return std::max({hl, hc, lc});
-    }
-    
-    double calculateATR(int period, const HistoricalBar& bar) const {
-        if (historicalData.empty() || period <= 0) return 0.0;
-        
-        size_t currentIndex = 0;
-        // Find current bar's index
-        for (size_t i = 0; i < historicalData.size(); i++) {
-            if (historicalData[i].timestamp == bar.timestamp) {
-                currentIndex = i;
-                break;
-            }
-        }
-        
-        if (currentIndex < period) return 0.0;
-        
-        // Calculate initial TR sum
-        double trSum = 0.0;
-        for (size_t i = currentIndex - period + 1; i <= currentIndex; i++) {
-            trSum += calculateTR(historicalData[i], historicalData[i-1]);
-        }
-        
-        return trSum / period;
+    HistoricalBar barAt(size_t i) const {
+        return {bars.timestamp[i], bars.open[i], bars.high[i],
+                bars.low[i], bars.close[i], bars.volume[i]};
     }
 
     EnhancedTradingStrategy* strategy;
-    std::vector<HistoricalBar> historicalData;
+    
+    // Historical data: columns point into either the mapped store or the CSV table
+    BarStore barStore;
+    BarTable barTable;
+    BarColumns bars;
+    
+    // Rolling ATR over the bars fed so far, used for position sizing
+    static constexpr int ATR_PERIOD = 14;
+    ATRIndicator atr{ATR_PERIOD};
+    
     std::vector<TradeResult> trades;
-    double capital;
-    double initialCapital;
+    Decimal capital;
+    Decimal initialCapital;
     
     // Portfolio tracking
-    double currentPosition = 0.0;
+    Decimal currentPosition;
     bool inPosition = false;
-    double fees = 0.001;  // 0.1% trading fee
+    Decimal fees = Decimal::fromUnits(Decimal::SCALE / 1000);  // 0.1% trading fee
+    Decimal quantityStep = Decimal::fromUnits(Decimal::SCALE / 1000);  // risk-based sizes round down to 0.001
+    
+    const char* signalMode = "per-bar";
 
     void simulateTrade(const HistoricalBar& bar);
-    double calculateDrawdown();
-    double calculateSharpeRatio();
+    void openLong(const HistoricalBar& bar);
+    void closeLong(const HistoricalBar& bar);
+    double calculateDrawdown() const;
+    double calculateSharpeRatio() const;
 };
\ No newline at end of file
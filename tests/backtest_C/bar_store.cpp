@@ -0,0 +1,430 @@
+// bar_store.cpp
+#include "bar_store.h"
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+#include <charconv>
+#include <thread>
+#include <cstring>
+#include <cstdio>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace {
+
+const char BAR_STORE_MAGIC[8] = {'C', 'B', 'B', 'A', 'R', 'S', 0, 0};
+const uint32_t BAR_STORE_VERSION = 1;
+const uint32_t BAR_STORE_COLUMNS = 6;
+const uint64_t COLUMN_ALIGNMENT = 64;
+
+uint64_t alignUp(uint64_t value) {
+    return (value + COLUMN_ALIGNMENT - 1) & ~(COLUMN_ALIGNMENT - 1);
+}
+
+// Days since 1970-01-01 for a proleptic Gregorian date
+int64_t daysFromCivil(int64_t y, unsigned m, unsigned d) {
+    y -= m <= 2;
+    const int64_t era = (y >= 0 ? y : y - 399) / 400;
+    const unsigned yoe = static_cast<unsigned>(y - era * 400);
+    const unsigned doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + static_cast<int64_t>(doe) - 719468;
+}
+
+bool parseDigits(const char* text, size_t count, unsigned& value) {
+    value = 0;
+    for (size_t i = 0; i < count; i++) {
+        unsigned digit = static_cast<unsigned>(text[i] - '0');
+        if (digit > 9) return false;
+        value = value * 10 + digit;
+    }
+    return true;
+}
+
+} // namespace
+
+bool parseTimestamp(const char* text, size_t length, int64_t& epochSeconds) {
+    // YYYY-MM-DD HH:MM:SS
+    if (length < 19 || text[4] != '-' || text[7] != '-' ||
+        (text[10] != ' ' && text[10] != 'T') || text[13] != ':' || text[16] != ':') {
+        return false;
+    }
+
+    unsigned year, month, day, hour, minute, second;
+    if (!parseDigits(text, 4, year) || !parseDigits(text + 5, 2, month) ||
+        !parseDigits(text + 8, 2, day) || !parseDigits(text + 11, 2, hour) ||
+        !parseDigits(text + 14, 2, minute) || !parseDigits(text + 17, 2, second)) {
+        return false;
+    }
+    if (month < 1 || month > 12 || day < 1 || day > 31) return false;
+
+    epochSeconds = daysFromCivil(year, month, day) * 86400 +
+                   hour * 3600 + minute * 60 + second;
+    return true;
+}
+
+std::string formatTimestamp(int64_t epochSeconds) {
+    int64_t days = epochSeconds / 86400;
+    int64_t secs = epochSeconds % 86400;
+    if (secs < 0) {
+        secs += 86400;
+        days--;
+    }
+
+    // Inverse of daysFromCivil
+    days += 719468;
+    const int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+    const unsigned doe = static_cast<unsigned>(days - era * 146097);
+    const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const unsigned mp = (5 * doy + 2) / 153;
+    const unsigned day = doy - (153 * mp + 2) / 5 + 1;
+    const unsigned month = mp < 10 ? mp + 3 : mp - 9;
+    const int64_t year = static_cast<int64_t>(yoe) + era * 400 + (month <= 2);
+
+    char buffer[64];
+    std::snprintf(buffer, sizeof(buffer), "%04lld-%02u-%02u %02u:%02u:%02u",
+                  static_cast<long long>(year), month, day,
+                  static_cast<unsigned>(secs / 3600),
+                  static_cast<unsigned>(secs / 60 % 60),
+                  static_cast<unsigned>(secs % 60));
+    return buffer;
+}
+
+void BarTable::reserve(size_t n) {
+    timestamp.reserve(n);
+    open.reserve(n);
+    high.reserve(n);
+    low.reserve(n);
+    close.reserve(n);
+    volume.reserve(n);
+}
+
+void BarTable::append(int64_t ts, double o, double h, double l, double c, double v) {
+    timestamp.push_back(ts);
+    open.push_back(o);
+    high.push_back(h);
+    low.push_back(l);
+    close.push_back(c);
+    volume.push_back(v);
+}
+
+BarColumns BarTable::columns() const {
+    BarColumns bars;
+    bars.count = size();
+    bars.timestamp = SeriesView<int64_t>(timestamp.data(), timestamp.size());
+    bars.open = SeriesView<double>(open.data(), open.size());
+    bars.high = SeriesView<double>(high.data(), high.size());
+    bars.low = SeriesView<double>(low.data(), low.size());
+    bars.close = SeriesView<double>(close.data(), close.size());
+    bars.volume = SeriesView<double>(volume.data(), volume.size());
+    return bars;
+}
+
+namespace {
+
+// Smallest slice of a CSV file worth handing to its own thread
+const size_t MIN_CSV_CHUNK = 1 << 20;
+
+struct CsvChunk {
+    const char* begin;
+    const char* end;
+    size_t firstRow;  // output slot of the chunk's first line
+    size_t lines;
+    size_t parsed;
+    size_t rejected;
+};
+
+const char* skipLine(const char* p, const char* end) {
+    const char* newline = static_cast<const char*>(std::memchr(p, '\n', end - p));
+    return newline ? newline + 1 : end;
+}
+
+size_t countLines(const char* p, const char* end) {
+    size_t lines = 0;
+    while (p < end) {
+        p = skipLine(p, end);
+        lines++;
+    }
+    return lines;
+}
+
+bool parseField(const char*& p, const char* end, double& value) {
+    auto result = std::from_chars(p, end, value);
+    if (result.ec != std::errc()) return false;
+    p = result.ptr;
+    if (p < end && *p == ',') p++;
+    return true;
+}
+
+// timestamp,open,high,low,close,volume without any intermediate strings
+bool parseCsvRow(const char* p, const char* end, int64_t& ts, double values[5]) {
+    const char* comma = static_cast<const char*>(std::memchr(p, ',', end - p));
+    if (!comma || !parseTimestamp(p, comma - p, ts)) return false;
+    p = comma + 1;
+    for (int i = 0; i < 5; i++) {
+        if (!parseField(p, end, values[i])) return false;
+    }
+    return true;
+}
+
+void parseCsvChunk(CsvChunk& chunk, BarTable& table) {
+    size_t row = chunk.firstRow;
+    const char* p = chunk.begin;
+    while (p < chunk.end) {
+        const char* next = skipLine(p, chunk.end);
+        const char* lineEnd = next;
+        while (lineEnd > p && (lineEnd[-1] == '\n' || lineEnd[-1] == '\r')) lineEnd--;
+
+        if (lineEnd > p) {
+            int64_t ts;
+            double values[5];
+            if (parseCsvRow(p, lineEnd, ts, values)) {
+                table.timestamp[row] = ts;
+                table.open[row] = values[0];
+                table.high[row] = values[1];
+                table.low[row] = values[2];
+                table.close[row] = values[3];
+                table.volume[row] = values[4];
+                row++;
+            } else {
+                chunk.rejected++;
+            }
+        }
+        p = next;
+    }
+    chunk.parsed = row - chunk.firstRow;
+}
+
+template <typename T>
+void compactColumn(std::vector<T>& column, const std::vector<CsvChunk>& chunks) {
+    size_t out = 0;
+    for (const auto& chunk : chunks) {
+        if (out != chunk.firstRow) {
+            std::memmove(column.data() + out, column.data() + chunk.firstRow, chunk.parsed * sizeof(T));
+        }
+        out += chunk.parsed;
+    }
+    column.resize(out);
+}
+
+} // namespace
+
+bool loadBarsCsv(const std::string& filename, BarTable& table, unsigned threads) {
+    MappedFile file;
+    if (!file.open(filename)) return false;
+
+    // Skip header
+    const char* end = file.data() + file.size();
+    const char* body = skipLine(file.data(), end);
+    size_t bodySize = end - body;
+
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    size_t chunkCount = std::max<size_t>(1, std::min<size_t>(threads, bodySize / MIN_CSV_CHUNK));
+
+    // Split on line boundaries
+    std::vector<CsvChunk> chunks(chunkCount);
+    const char* p = body;
+    for (size_t i = 0; i < chunkCount; i++) {
+        const char* target = (i + 1 == chunkCount) ? end : body + bodySize * (i + 1) / chunkCount;
+        const char* chunkEnd = (target >= end || target <= p) ? std::max(target, p) : skipLine(target - 1, end);
+        chunks[i] = {p, chunkEnd, 0, 0, 0, 0};
+        p = chunkEnd;
+    }
+
+    auto forEachChunk = [&](auto&& work) {
+        std::vector<std::thread> workers;
+        for (size_t i = 1; i < chunkCount; i++) {
+            workers.emplace_back(work, std::ref(chunks[i]));
+        }
+        work(chunks[0]);
+        for (auto& worker : workers) worker.join();
+    };
+
+    // Pass 1: count lines so every chunk knows where its rows go
+    forEachChunk([](CsvChunk& chunk) { chunk.lines = countLines(chunk.begin, chunk.end); });
+    size_t totalLines = 0;
+    for (auto& chunk : chunks) {
+        chunk.firstRow = totalLines;
+        totalLines += chunk.lines;
+    }
+
+    // Pass 2: parse directly into the preallocated columns
+    size_t base = table.size();
+    table.timestamp.resize(base + totalLines);
+    table.open.resize(base + totalLines);
+    table.high.resize(base + totalLines);
+    table.low.resize(base + totalLines);
+    table.close.resize(base + totalLines);
+    table.volume.resize(base + totalLines);
+    for (auto& chunk : chunks) chunk.firstRow += base;
+
+    forEachChunk([&table](CsvChunk& chunk) { parseCsvChunk(chunk, table); });
+
+    // Drop the slots of blank or malformed lines
+    size_t rejected = 0;
+    for (const auto& chunk : chunks) rejected += chunk.rejected;
+    chunks.insert(chunks.begin(), CsvChunk{nullptr, nullptr, 0, base, base, 0});
+    compactColumn(table.timestamp, chunks);
+    compactColumn(table.open, chunks);
+    compactColumn(table.high, chunks);
+    compactColumn(table.low, chunks);
+    compactColumn(table.close, chunks);
+    compactColumn(table.volume, chunks);
+
+    if (rejected > 0) {
+        std::cerr << "Skipped " << rejected << " malformed rows in " << filename << std::endl;
+    }
+    return true;
+}
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+void MappedFile::close() {
+    if (mapping) {
+        munmap(mapping, mappingSize);
+        mapping = nullptr;
+        mappingSize = 0;
+    }
+}
+
+bool MappedFile::open(const std::string& filename) {
+    close();
+
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "Failed to open " << filename << std::endl;
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        std::cerr << "Empty or unreadable file: " << filename << std::endl;
+        ::close(fd);
+        return false;
+    }
+
+    size_t size = static_cast<size_t>(st.st_size);
+    void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED) {
+        std::cerr << "Failed to map " << filename << std::endl;
+        return false;
+    }
+
+    // Files are walked front to back
+    madvise(data, size, MADV_SEQUENTIAL);
+
+    mapping = data;
+    mappingSize = size;
+    return true;
+}
+
+BarStore::~BarStore() {
+    close();
+}
+
+void BarStore::close() {
+    file.close();
+    bars = BarColumns();
+}
+
+bool BarStore::isBarStore(const std::string& filename) {
+    std::ifstream file(filename, std::ios::binary);
+    char magic[sizeof(BAR_STORE_MAGIC)] = {};
+    file.read(magic, sizeof(magic));
+    return file && std::memcmp(magic, BAR_STORE_MAGIC, sizeof(magic)) == 0;
+}
+
+bool BarStore::open(const std::string& filename) {
+    close();
+
+    if (!file.open(filename)) return false;
+
+    size_t size = file.size();
+    const BarStoreHeader* header = reinterpret_cast<const BarStoreHeader*>(file.data());
+    bool valid = size >= sizeof(BarStoreHeader) &&
+                 std::memcmp(header->magic, BAR_STORE_MAGIC, sizeof(BAR_STORE_MAGIC)) == 0 &&
+                 header->version == BAR_STORE_VERSION &&
+                 header->columnCount == BAR_STORE_COLUMNS;
+    for (uint32_t i = 0; valid && i < BAR_STORE_COLUMNS; i++) {
+        valid = header->offsets[i] % sizeof(double) == 0 &&
+                header->offsets[i] <= size &&
+                header->count <= (size - header->offsets[i]) / sizeof(double);
+    }
+    if (!valid) {
+        std::cerr << "Invalid bar store: " << filename << std::endl;
+        file.close();
+        return false;
+    }
+
+    const char* base = file.data();
+    size_t count = static_cast<size_t>(header->count);
+    auto column = [&](int i) {
+        return SeriesView<double>(reinterpret_cast<const double*>(base + header->offsets[i]), count);
+    };
+    bars.count = count;
+    bars.timestamp = SeriesView<int64_t>(reinterpret_cast<const int64_t*>(base + header->offsets[0]), count);
+    bars.open = column(1);
+    bars.high = column(2);
+    bars.low = column(3);
+    bars.close = column(4);
+    bars.volume = column(5);
+    return true;
+}
+
+bool BarStore::write(const std::string& filename, const BarColumns& bars) {
+    std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        std::cerr << "Failed to create bar store " << filename << std::endl;
+        return false;
+    }
+
+    BarStoreHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, BAR_STORE_MAGIC, sizeof(BAR_STORE_MAGIC));
+    header.version = BAR_STORE_VERSION;
+    header.columnCount = BAR_STORE_COLUMNS;
+    header.count = bars.count;
+
+    uint64_t columnBytes = bars.count * sizeof(double);
+    uint64_t offset = alignUp(sizeof(BarStoreHeader));
+    for (uint32_t i = 0; i < BAR_STORE_COLUMNS; i++) {
+        header.offsets[i] = offset;
+        offset = alignUp(offset + columnBytes);
+    }
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    const char* columns[BAR_STORE_COLUMNS] = {
+        reinterpret_cast<const char*>(bars.timestamp.data()),
+        reinterpret_cast<const char*>(bars.open.data()),
+        reinterpret_cast<const char*>(bars.high.data()),
+        reinterpret_cast<const char*>(bars.low.data()),
+        reinterpret_cast<const char*>(bars.close.data()),
+        reinterpret_cast<const char*>(bars.volume.data())
+    };
+    const char padding[COLUMN_ALIGNMENT] = {};
+    uint64_t written = sizeof(header);
+    for (uint32_t i = 0; i < BAR_STORE_COLUMNS; i++) {
+        file.write(padding, header.offsets[i] - written);
+        if (columnBytes > 0) file.write(columns[i], columnBytes);
+        written = header.offsets[i] + columnBytes;
+    }
+
+    if (!file) {
+        std::cerr << "Failed to write bar store " << filename << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool BarStore::convertCsv(const std::string& csvFilename, const std::string& filename) {
+    BarTable table;
+    if (!loadBarsCsv(csvFilename, table)) return false;
+    return write(filename, table.columns());
+}
@@ -0,0 +1,88 @@
+// bar_store.h
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "bar_columns.h"
+
+// Owned columns, used for data parsed from CSV
+struct BarTable {
+    std::vector<int64_t> timestamp;
+    std::vector<double> open;
+    std::vector<double> high;
+    std::vector<double> low;
+    std::vector<double> close;
+    std::vector<double> volume;
+
+    void reserve(size_t n);
+    void append(int64_t ts, double o, double h, double l, double c, double v);
+    size_t size() const { return timestamp.size(); }
+    BarColumns columns() const;
+};
+
+// On-disk layout (native little-endian):
+//   BarStoreHeader (128 bytes)
+//   int64 timestamps[count], then open/high/low/close/volume double[count],
+//   each column starting on a 64-byte boundary at the offset in the header.
+struct BarStoreHeader {
+    char magic[8];          // "CBBARS\0\0"
+    uint32_t version;
+    uint32_t columnCount;
+    uint64_t count;
+    uint64_t offsets[6];    // timestamp, open, high, low, close, volume
+    uint8_t reserved[56];
+};
+static_assert(sizeof(BarStoreHeader) == 128, "bar store header must stay 128 bytes");
+
+// Read-only memory mapping of a whole file
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const std::string& filename);
+    void close();
+    bool isOpen() const { return mapping != nullptr; }
+    const char* data() const { return static_cast<const char*>(mapping); }
+    size_t size() const { return mappingSize; }
+
+private:
+    void* mapping = nullptr;
+    size_t mappingSize = 0;
+};
+
+// Read-only, memory-mapped columnar bar file
+class BarStore {
+public:
+    BarStore() = default;
+    ~BarStore();
+    BarStore(const BarStore&) = delete;
+    BarStore& operator=(const BarStore&) = delete;
+
+    bool open(const std::string& filename);
+    void close();
+    bool isOpen() const { return file.isOpen(); }
+    const BarColumns& columns() const { return bars; }
+
+    static bool isBarStore(const std::string& filename);
+    static bool write(const std::string& filename, const BarColumns& bars);
+
+    // Convert a timestamp,open,high,low,close,volume CSV into a bar store
+    static bool convertCsv(const std::string& csvFilename, const std::string& filename);
+
+private:
+    MappedFile file;
+    BarColumns bars;
+};
+
+// Load a timestamp,open,high,low,close,volume CSV (with header row).
+// The file is mapped, split on line boundaries and parsed by up to
+// `threads` workers (0 = one per core) straight into the table's columns.
+bool loadBarsCsv(const std::string& filename, BarTable& table, unsigned threads = 0);
+
+// "YYYY-MM-DD HH:MM:SS" (UTC) <-> epoch seconds; parse returns false on malformed input
+bool parseTimestamp(const char* text, size_t length, int64_t& epochSeconds);
+std::string formatTimestamp(int64_t epochSeconds);
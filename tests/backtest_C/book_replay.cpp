@@ -0,0 +1,238 @@
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cmath>
+#include <algorithm>
+#include "order_book.h"
+
+// Replays recorded depth data (tests/historical_data/get_depth.py) through
+// OrderBook the way OrderBookFeed drives it, then times the book queries:
+//   book_replay BTCUSDT_depth.jsonl [fill_quantity] [--expect file]
+// One JSON text per line, in arrival order: /api/v3/depth snapshots (they
+// have "lastUpdateId") and <symbol>@depth stream events. A snapshot is
+// applied while the book waits for one and skipped otherwise. With
+// --expect the final book, the counts and the fill estimates must match
+// the file (see tests/historical_data/BTCUSDT_depth_fixture.expected), or
+// the exit status is 1.
+
+using Clock = std::chrono::steady_clock;
+
+struct ReplayCounts {
+    size_t applied = 0, buffered = 0, stale = 0, gaps = 0;
+    size_t snapshotsApplied = 0, snapshotsFailed = 0, snapshotsSkipped = 0;
+};
+
+static bool near(double a, double b) {
+    return std::fabs(a - b) <= 1e-9 * std::max(1.0, std::fabs(b));
+}
+
+// Compare the replay with an --expect file, one check per line:
+//   update <id>
+//   events <applied> <buffered> <stale> <gaps>
+//   snapshots <applied> <too old> <skipped>
+//   bid|ask <price> <quantity>       every level of that side, none missing
+//   best <bid price> <ask price>
+//   fill buy|sell <quantity> <average price> <worst price> <levels>
+// Prints each mismatch; false if there was one
+static bool checkExpected(const std::string& path, const OrderBook& book, const ReplayCounts& counts) {
+    std::ifstream in(path);
+    if (!in) {
+        std::cerr << "Cannot open " << path << std::endl;
+        return false;
+    }
+    size_t mismatches = 0;
+    size_t levels[2] = {0, 0};
+    auto mismatch = [&](const std::string& line, const std::string& got) {
+        std::cerr << "Expected " << line << ", got " << got << std::endl;
+        mismatches++;
+    };
+
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.empty() || line[0] == '#') continue;
+        std::istringstream fields(line);
+        std::string kind;
+        fields >> kind;
+        if (kind == "update") {
+            int64_t id = 0;
+            fields >> id;
+            if (book.lastUpdateId() != id) mismatch(line, std::to_string(book.lastUpdateId()));
+        } else if (kind == "events") {
+            size_t applied = 0, buffered = 0, stale = 0, gaps = 0;
+            fields >> applied >> buffered >> stale >> gaps;
+            if (applied != counts.applied || buffered != counts.buffered || stale != counts.stale || gaps != counts.gaps) {
+                mismatch(line, std::to_string(counts.applied) + " " + std::to_string(counts.buffered) + " " +
+                               std::to_string(counts.stale) + " " + std::to_string(counts.gaps));
+            }
+        } else if (kind == "snapshots") {
+            size_t applied = 0, failed = 0, skipped = 0;
+            fields >> applied >> failed >> skipped;
+            if (applied != counts.snapshotsApplied || failed != counts.snapshotsFailed ||
+                skipped != counts.snapshotsSkipped) {
+                mismatch(line, std::to_string(counts.snapshotsApplied) + " " + std::to_string(counts.snapshotsFailed) +
+                               " " + std::to_string(counts.snapshotsSkipped));
+            }
+        } else if (kind == "bid" || kind == "ask") {
+            double price = 0, quantity = 0;
+            fields >> price >> quantity;
+            BookSide side = kind == "bid" ? BookSide::Bid : BookSide::Ask;
+            levels[side == BookSide::Bid ? 0 : 1]++;
+            double actual = book.quantityAt(side, price);
+            if (!near(actual, quantity)) mismatch(line, std::to_string(actual));
+        } else if (kind == "best") {
+            double bid = 0, ask = 0;
+            fields >> bid >> ask;
+            if (!near(book.bestBid().price, bid) || !near(book.bestAsk().price, ask)) {
+                mismatch(line, std::to_string(book.bestBid().price) + " " + std::to_string(book.bestAsk().price));
+            }
+        } else if (kind == "fill") {
+            std::string side;
+            double quantity = 0, average = 0, worst = 0;
+            int levelCount = 0;
+            fields >> side >> quantity >> average >> worst >> levelCount;
+            FillEstimate fill = book.estimateFill(side == "buy", quantity);
+            if (!fill.complete() || !near(fill.averagePrice, average) || !near(fill.worstPrice, worst) ||
+                fill.levels != levelCount) {
+                std::ostringstream got;
+                got << std::setprecision(15) << fill.filled << " filled, " << fill.averagePrice << " "
+                    << fill.worstPrice << " " << fill.levels;
+                mismatch(line, got.str());
+            }
+        } else {
+            std::cerr << "Unknown line in " << path << ": " << line << std::endl;
+            mismatches++;
+        }
+        if (fields.fail()) {
+            std::cerr << "Unreadable line in " << path << ": " << line << std::endl;
+            mismatches++;
+        }
+    }
+
+    // The listed levels must be all there are
+    if (book.depth(BookSide::Bid) != levels[0] || book.depth(BookSide::Ask) != levels[1]) {
+        std::cerr << "Expected " << levels[0] << " bids and " << levels[1] << " asks, got "
+                  << book.depth(BookSide::Bid) << " and " << book.depth(BookSide::Ask) << std::endl;
+        mismatches++;
+    }
+    std::cout << "Checked against " << path << ": " << mismatches << " mismatches" << std::endl;
+    return mismatches == 0;
+}
+
+// Nanoseconds per call of `query` over `rounds` calls
+template <typename Query>
+static double timeQuery(size_t rounds, Query query) {
+    auto start = Clock::now();
+    for (size_t i = 0; i < rounds; i++) query(i);
+    return std::chrono::duration<double, std::nano>(Clock::now() - start).count() / rounds;
+}
+
+int main(int argc, char* argv[]) {
+    std::string expectPath;
+    if (argc >= 4 && std::string(argv[argc - 2]) == "--expect") {
+        expectPath = argv[argc - 1];
+        argc -= 2;
+    }
+    if (argc < 2 || argc > 3) {
+        std::cerr << "Usage: " << argv[0] << " <depth.jsonl> [fill_quantity] [--expect file]" << std::endl;
+        return 1;
+    }
+    double fillQuantity = argc == 3 ? std::stod(argv[2]) : 1.0;
+
+    std::ifstream in(argv[1]);
+    if (!in) {
+        std::cerr << "Cannot open " << argv[1] << std::endl;
+        return 1;
+    }
+
+    OrderBook book;
+    size_t lines = 0, badLines = 0;
+    ReplayCounts counts;
+    std::vector<double> queryPrices;   // prices seen in updates, for quantityAt
+    double decodeNs = 0;
+
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.empty()) continue;
+        lines++;
+        if (line.find("\"lastUpdateId\"") != std::string::npos) {
+            DepthSnapshot snapshot;
+            if (!decodeDepthSnapshot(line, snapshot)) {
+                badLines++;
+                continue;
+            }
+            if (book.synced()) {
+                counts.snapshotsSkipped++;
+            } else if (book.applySnapshot(std::move(snapshot))) {
+                counts.snapshotsApplied++;
+            } else {
+                counts.snapshotsFailed++;
+            }
+            continue;
+        }
+
+        DepthUpdate update;
+        auto start = Clock::now();
+        bool decoded = decodeDepthUpdate(line, update);
+        decodeNs += std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+        if (!decoded) {
+            badLines++;
+            continue;
+        }
+        for (const DepthLevel& level : update.bids) {
+            if (queryPrices.size() < 4096) queryPrices.push_back(level.price);
+        }
+        switch (book.applyUpdate(std::move(update))) {
+            case OrderBook::Update::Applied: counts.applied++; break;
+            case OrderBook::Update::Buffered: counts.buffered++; break;
+            case OrderBook::Update::Stale: counts.stale++; break;
+            case OrderBook::Update::Gap:
+                counts.gaps++;
+                std::cout << "Gap at line " << lines << ", waiting for the next snapshot" << std::endl;
+                break;
+        }
+    }
+
+    size_t events = counts.applied + counts.buffered + counts.stale + counts.gaps;
+    std::cout << "Replayed " << lines << " lines: " << events << " events (" << counts.applied << " applied, "
+              << counts.buffered << " buffered, " << counts.stale << " stale, " << counts.gaps << " gaps), "
+              << counts.snapshotsApplied << " snapshots applied, " << counts.snapshotsFailed << " too old, "
+              << counts.snapshotsSkipped << " skipped, " << badLines << " unreadable" << std::endl;
+    if (events > 0) {
+        std::cout << "Decode: " << decodeNs / events << " ns per event" << std::endl;
+    }
+    if (!book.synced()) {
+        std::cout << "Book not synced at the end (" << book.buffered() << " events buffered)" << std::endl;
+        return 1;
+    }
+
+    DepthLevel bid = book.bestBid();
+    DepthLevel ask = book.bestAsk();
+    std::cout << std::setprecision(10) << "Book at update " << book.lastUpdateId() << ": " << book.depth(BookSide::Bid) << " bids, "
+              << book.depth(BookSide::Ask) << " asks, best " << bid.quantity << " @ " << bid.price
+              << " / " << ask.quantity << " @ " << ask.price << std::endl;
+    for (bool buy : {true, false}) {
+        FillEstimate fill = book.estimateFill(buy, fillQuantity);
+        std::cout << (buy ? "Buy " : "Sell ") << fillQuantity << ": " << fill.filled << " filled over "
+                  << fill.levels << " levels, average " << fill.averagePrice << ", worst " << fill.worstPrice
+                  << ", slippage " << fill.slippage * 100 << "%" << std::endl;
+    }
+
+    if (!expectPath.empty() && (badLines != 0 || !checkExpected(expectPath, book, counts))) return 1;
+
+    // Query latency on the final book
+    if (queryPrices.empty()) queryPrices.push_back(bid.price);
+    const size_t rounds = 1000000;
+    volatile double sink = 0;
+    double topNs = timeQuery(rounds, [&](size_t) { sink = book.bestBid().price + book.bestAsk().price; });
+    double atNs = timeQuery(rounds, [&](size_t i) {
+        sink = book.quantityAt(BookSide::Bid, queryPrices[i % queryPrices.size()]);
+    });
+    double fillNs = timeQuery(rounds, [&](size_t i) { sink = book.estimateFill(i & 1, fillQuantity).averagePrice; });
+    std::cout << std::setprecision(4) << "Queries: best bid+ask " << topNs << " ns, quantityAt " << atNs << " ns, estimateFill("
+              << fillQuantity << ") " << fillNs << " ns" << std::endl;
+    return 0;
+}
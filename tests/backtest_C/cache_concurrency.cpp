@@ -0,0 +1,147 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include "api.h"
+#include "market_data_cache.h"
+#include "seqlock.h"
+
+using Clock = std::chrono::steady_clock;
+
+// Eight copies of one counter: a read that mixes two stores shows up as
+// words that differ
+struct Stamp {
+    uint64_t words[8];
+};
+
+// One writer stores as fast as it can while `readers` threads load; every
+// load must see a single store, and never an older one than the last it saw
+static bool tortureSeqLock(unsigned readers, std::chrono::milliseconds duration) {
+    SeqLock<Stamp> value;
+    std::atomic<bool> stop{false};
+    std::atomic<uint64_t> reads{0};
+    std::atomic<uint64_t> torn{0};
+    std::atomic<uint64_t> backwards{0};
+
+    std::vector<std::thread> threads;
+    for (unsigned r = 0; r < readers; r++) {
+        threads.emplace_back([&] {
+            uint64_t count = 0, tornCount = 0, backwardsCount = 0, last = 0;
+            while (!stop.load(std::memory_order_relaxed)) {
+                Stamp stamp = value.load();
+                for (uint64_t word : stamp.words) {
+                    if (word != stamp.words[0]) {
+                        tornCount++;
+                        break;
+                    }
+                }
+                if (stamp.words[0] < last) backwardsCount++;
+                last = stamp.words[0];
+                count++;
+            }
+            reads += count;
+            torn += tornCount;
+            backwards += backwardsCount;
+        });
+    }
+
+    uint64_t stores = 0;
+    Clock::time_point end = Clock::now() + duration;
+    while (Clock::now() < end) {
+        for (int i = 0; i < 64; i++) {
+            Stamp stamp;
+            stores++;
+            for (uint64_t& word : stamp.words) word = stores;
+            value.store(stamp);
+        }
+    }
+    stop = true;
+    for (std::thread& thread : threads) thread.join();
+
+    std::cout << "SeqLock, 1 writer and " << readers << " readers for " << duration.count() << " ms: " << stores
+              << " stores, " << reads << " reads, " << torn << " torn, " << backwards << " older than a previous read"
+              << std::endl;
+    return reads > 0 && torn == 0 && backwards == 0 && value.version() == stores;
+}
+
+// `callers` threads ask the cold cache for the same price at once; one
+// fetches it and the rest must wait for that fetch
+static bool checkCoalescing(BinanceAPI& api, unsigned callers) {
+    MarketDataCache& cache = MarketDataCache::getInstance();
+    const std::string symbol = "BTCUSDT";
+    MarketDataCache::Stats::Counters before = cache.getStats().kinds[MarketDataCache::PriceData];
+
+    std::atomic<bool> go{false};
+    std::atomic<unsigned> failed{0};
+    std::vector<double> prices(callers);
+    std::vector<std::thread> threads;
+    for (unsigned c = 0; c < callers; c++) {
+        threads.emplace_back([&, c] {
+            while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+            PriceQuote quote;
+            if (cache.lastPrice(api, symbol, quote)) prices[c] = quote.price;
+            else failed++;
+        });
+    }
+    Clock::time_point start = Clock::now();
+    go.store(true, std::memory_order_release);
+    for (std::thread& thread : threads) thread.join();
+    double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+    MarketDataCache::Stats::Counters after = cache.getStats().kinds[MarketDataCache::PriceData];
+    uint64_t coalesced = after.coalesced - before.coalesced;
+    uint64_t hits = after.hits - before.hits;
+    // A caller that finds the fetch finished before it takes the entry lock
+    // is served without a fetch of its own
+    uint64_t fetches = callers - coalesced - hits;
+    std::cout << callers << " concurrent cold callers: " << after.misses - before.misses << " misses, " << coalesced
+              << " coalesced, " << hits << " hits, " << failed << " failed, all done in " << ms << " ms" << std::endl;
+
+    bool samePrice = true;
+    for (double price : prices) samePrice &= price == prices[0];
+    if (failed != 0 || !samePrice || coalesced + 1 < callers || after.failures != before.failures) {
+        std::cerr << "Expected one fetch shared by all callers" << std::endl;
+        return false;
+    }
+
+    // The value is fresh now, so the next read must not fetch
+    PriceQuote quote;
+    uint64_t hitsBefore = cache.getStats().kinds[MarketDataCache::PriceData].hits;
+    if (!cache.lastPrice(api, symbol, quote) ||
+        cache.getStats().kinds[MarketDataCache::PriceData].hits != hitsBefore + 1) {
+        std::cerr << "A read within the TTL was not a hit" << std::endl;
+        return false;
+    }
+    return fetches <= 1;
+}
+
+// SeqLock torture test, then concurrent cold reads of MarketDataCache that
+// must share one REST fetch. The second part goes to the configured
+// base_url; point it at a stand-in with latency, so the callers overlap the
+// fetch:
+//   limit_server --port 8080 --delay 50 &
+//   cache_concurrency [--readers 3] [--ms 2000] [--callers 16]
+int main(int argc, char* argv[]) {
+    unsigned readers = 3;
+    unsigned callers = 16;
+    long ms = 2000;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--readers" && i + 1 < argc) readers = std::stoul(argv[++i]);
+        else if (arg == "--ms" && i + 1 < argc) ms = std::stol(argv[++i]);
+        else if (arg == "--callers" && i + 1 < argc) callers = std::stoul(argv[++i]);
+        else {
+            std::cerr << "Usage: " << argv[0]
+                      << " [--readers 3] [--ms 2000] [--callers 16]" << std::endl;
+            return 1;
+        }
+    }
+
+    if (!tortureSeqLock(readers, std::chrono::milliseconds(ms))) return 1;
+
+    BinanceAPI api;
+    return checkCoalescing(api, callers) ? 0 : 1;
+}
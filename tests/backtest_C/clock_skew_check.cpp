@@ -0,0 +1,82 @@
+#include <iostream>
+#include <string>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include "api.h"
+#include "clock_sync.h"
+#include "response_decoder.h"
+
+static int64_t systemMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+// Signed requests against a stand-in whose clock is `skewMs` off the local
+// one: before the first sample timestamps follow the local clock, after it
+// the estimate must be within half the sample's round trip of the skew,
+// timestamps must follow the exchange clock at once (also when it is behind
+// the stamps already issued), and every signed request must pass. Run it
+// against a stand-in on this host with the same skew, from a directory
+// whose config.json points base_url at it:
+//   limit_server --port 8080 --skew -3000 &
+//   clock_skew_check [--skew -3000] [--requests 20]
+int main(int argc, char* argv[]) {
+    int64_t skewMs = -3000;
+    int requests = 20;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--skew" && i + 1 < argc) skewMs = std::stoll(argv[++i]);
+        else if (arg == "--requests" && i + 1 < argc) requests = std::stoi(argv[++i]);
+        else {
+            std::cerr << "Usage: " << argv[0] << " [--skew -3000] [--requests 20]" << std::endl;
+            return 1;
+        }
+    }
+
+    BinanceAPI api;
+    ClockSync& clock = ClockSync::getInstance();
+
+    // The first sample takes a round trip, so this is normally the local clock
+    bool syncedBefore = clock.getStats().synced;
+    int64_t localStamp = clock.exchangeTimeMs() - systemMs();
+    if (!clock.waitForSync(std::chrono::seconds(10))) {
+        std::cerr << "No clock estimate from the stand-in" << std::endl;
+        return 1;
+    }
+    int64_t syncedStamp = clock.exchangeTimeMs() - systemMs();
+    ClockSync::Stats stats = clock.getStats();
+
+    // The stand-in reports whole ms
+    double offsetError = std::abs(stats.offsetMs - skewMs);
+    double allowedMs = stats.rttMs / 2 + 1;
+    std::cout << "Stand-in skew " << skewMs << " ms: estimate " << stats.offsetMs << " ms (off by " << offsetError
+              << " ms, round trip " << stats.rttMs << " ms, " << stats.samples << " samples)" << std::endl;
+    std::cout << "Timestamp minus local clock: " << localStamp
+              << (syncedBefore ? " ms (already synced)" : " ms before the first sample, ") << syncedStamp
+              << " ms after it" << std::endl;
+
+    bool ok = true;
+    if (offsetError > allowedMs) {
+        ok = false;
+        std::cerr << "The offset estimate is more than half the round trip off" << std::endl;
+    }
+    if (std::abs(syncedStamp - skewMs) > allowedMs + 1) {
+        ok = false;
+        std::cerr << "Timestamps did not follow the estimate" << std::endl;
+    }
+
+    int rejected = 0;
+    for (int i = 0; i < requests; i++) {
+        std::string body = api.send_signed_request("/api/v3/account", "");
+        ApiError error;
+        if (body.empty() || decodeApiError(body, error)) {
+            if (rejected++ == 0) std::cerr << "Signed request failed: " << body << std::endl;
+        }
+    }
+    uint64_t resyncs = clock.getStats().resyncs - stats.resyncs;
+    std::cout << requests << " signed requests: " << rejected << " rejected, " << resyncs << " resyncs asked for"
+              << std::endl;
+    if (rejected != 0 || resyncs != 0) ok = false;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,134 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <cstring>
+#include <chrono>
+#include <sys/stat.h>
+#include "bar_store.h"
+
+// The backtester's loader before the bar store (getline, stringstream and
+// std::stod per field), kept as the baseline for --compare. Timestamps were
+// kept as text then; they are parsed here so the columns can be compared.
+static bool loadBarsStringstream(const std::string& filename, BarTable& table) {
+    std::ifstream file(filename);
+    if (!file) {
+        std::cerr << "Cannot open " << filename << std::endl;
+        return false;
+    }
+    std::string line;
+
+    // Skip header
+    std::getline(file, line);
+
+    while (std::getline(file, line)) {
+        std::stringstream ss(line);
+        std::string timestamp;
+        std::string token;
+        double open, high, low, close, volume;
+
+        std::getline(ss, timestamp, ',');
+        std::getline(ss, token, ','); open = std::stod(token);
+        std::getline(ss, token, ','); high = std::stod(token);
+        std::getline(ss, token, ','); low = std::stod(token);
+        std::getline(ss, token, ','); close = std::stod(token);
+        std::getline(ss, token, ','); volume = std::stod(token);
+
+        int64_t epochSeconds = 0;
+        if (!parseTimestamp(timestamp.data(), timestamp.size(), epochSeconds)) {
+            std::cerr << "Bad timestamp: " << timestamp << std::endl;
+            return false;
+        }
+        table.append(epochSeconds, open, high, low, close, volume);
+    }
+    return true;
+}
+
+template <typename T>
+static bool sameColumn(const char* name, const std::vector<T>& a, const std::vector<T>& b) {
+    // Bitwise, so -0.0 vs 0.0 or a differently rounded last digit counts
+    if (a.size() == b.size() && std::memcmp(a.data(), b.data(), a.size() * sizeof(T)) == 0) return true;
+    std::cerr << "Column " << name << " differs" << std::endl;
+    return false;
+}
+
+// Best of `runs` loads, in seconds
+template <typename Loader>
+static double timeLoad(Loader load, int runs, BarTable& table) {
+    double best = 0;
+    for (int i = 0; i < runs; i++) {
+        table = BarTable();
+        auto start = std::chrono::steady_clock::now();
+        if (!load(table)) return -1;
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (i == 0 || seconds < best) best = seconds;
+    }
+    return best;
+}
+
+static void report(const char* name, double seconds, size_t rows, double megabytes) {
+    std::cout << name << ": " << rows << " rows in " << seconds * 1000 << " ms, "
+              << megabytes / seconds << " MB/s, " << rows / seconds << " rows/s" << std::endl;
+}
+
+// Times both loaders on the same file and checks they give identical columns
+static int compareLoaders(const std::string& csvFilename, double megabytes) {
+    const int runs = 3;
+    BarTable baseline;
+    BarTable parallel;
+    double baselineSeconds = timeLoad([&](BarTable& t) { return loadBarsStringstream(csvFilename, t); }, runs, baseline);
+    double parallelSeconds = timeLoad([&](BarTable& t) { return loadBarsCsv(csvFilename, t); }, runs, parallel);
+    if (baselineSeconds < 0 || parallelSeconds < 0) return 1;
+
+    report("stringstream", baselineSeconds, baseline.size(), megabytes);
+    report("parallel from_chars", parallelSeconds, parallel.size(), megabytes);
+    std::cout << "Speedup: " << baselineSeconds / parallelSeconds << "x (best of " << runs << ")" << std::endl;
+
+    bool same = sameColumn("timestamp", baseline.timestamp, parallel.timestamp) &
+                sameColumn("open", baseline.open, parallel.open) &
+                sameColumn("high", baseline.high, parallel.high) &
+                sameColumn("low", baseline.low, parallel.low) &
+                sameColumn("close", baseline.close, parallel.close) &
+                sameColumn("volume", baseline.volume, parallel.volume);
+    if (!same) return 1;
+    std::cout << "Columns bit-identical" << std::endl;
+    return 0;
+}
+
+// Converts historical CSV data into the columnar bar store format:
+//   convert_bars tests/historical_data/BTCUSDT_1m_historical_data.csv BTCUSDT_1m.bars
+// or, with --compare, times the parallel loader against the old
+// stringstream one and checks both produce the same columns:
+//   convert_bars --compare tests/historical_data/BTCUSDT_1m_historical_data.csv
+int main(int argc, char* argv[]) {
+    bool compare = argc == 3 && std::strcmp(argv[1], "--compare") == 0;
+    if (argc != 3) {
+        std::cerr << "Usage: " << argv[0] << " <input.csv> <output.bars>\n"
+                  << "       " << argv[0] << " --compare <input.csv>" << std::endl;
+        return 1;
+    }
+    const char* csvFilename = compare ? argv[2] : argv[1];
+    struct stat st;
+    double megabytes = stat(csvFilename, &st) == 0 ? st.st_size / 1e6 : 0.0;
+    if (compare) {
+        return compareLoaders(csvFilename, megabytes);
+    }
+
+    // Parse (timed, so ingestion throughput is visible on large dumps)
+    auto start = std::chrono::steady_clock::now();
+    BarTable table;
+    if (!loadBarsCsv(argv[1], table)) {
+        return 1;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "Parsed " << table.size() << " rows (" << megabytes << " MB) in "
+              << seconds * 1000 << " ms: " << megabytes / seconds << " MB/s, "
+              << table.size() / seconds << " rows/s" << std::endl;
+
+    if (!BarStore::write(argv[2], table.columns())) {
+        return 1;
+    }
+    std::cout << "Wrote " << table.size() << " bars to " << argv[2] << std::endl;
+    return 0;
+}
@@ -0,0 +1,136 @@
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <charconv>
+#include <cstdio>
+#include <cstdlib>
+#include "decimal.h"
+
+// Every value of `count` random ones, at magnitudes from 1e-8 to the top of
+// the range, must come back unchanged from format() and from text()
+static bool checkRoundTrip(size_t count) {
+    std::mt19937_64 random(42);
+    char buffer[Decimal::MAX_CHARS];
+    size_t failures = 0;
+    for (size_t i = 0; i < count; i++) {
+        int64_t units = static_cast<int64_t>(random() >> (1 + random() % 63));
+        if (random() & 1) units = -units;
+        Decimal value = Decimal::fromUnits(units);
+
+        Decimal parsed;
+        char* end = value.format(buffer, buffer + sizeof(buffer));
+        bool ok = end && Decimal::parse(std::string_view(buffer, end - buffer), parsed) && parsed == value;
+        Decimal shortest;
+        ok &= Decimal::parse(value.text(), shortest) && shortest == value;
+        if (!ok && failures++ < 5) {
+            std::cerr << "Round trip of " << units << " units: "
+                      << (end ? std::string(buffer, end - buffer) : std::string("(no fit)")) << " / "
+                      << std::string_view(value.text()) << std::endl;
+        }
+    }
+    std::cout << count << " random values through format/text and parse: " << failures << " changed" << std::endl;
+    return failures == 0;
+}
+
+// Prices and quantities as the exchange writes them
+static std::vector<std::string> exchangeStrings(size_t count) {
+    std::mt19937_64 random(7);
+    std::vector<std::string> out;
+    for (size_t i = 0; i < count; i++) {
+        char text[32];
+        int length = std::snprintf(text, sizeof(text), "%llu.%08llu",
+                                   static_cast<unsigned long long>(random() % 100000),
+                                   static_cast<unsigned long long>(random() % 100000000));
+        out.emplace_back(text, length);
+    }
+    return out;
+}
+
+// Best of three, in ns per value
+template <typename Call>
+static double timeCall(Call call, size_t iterations) {
+    double best = 0;
+    for (int run = 0; run < 3; run++) {
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < iterations; i++) call(i);
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        if (run == 0 || ns < best) best = ns;
+    }
+    return best / iterations;
+}
+
+// Checks that Decimal text round-trips exactly, then times parse() and
+// format() on exchange-style strings against the stream and double code
+// they replaced:
+//   decimal_bench [--values 2000000] [--passes 1000]
+int main(int argc, char* argv[]) {
+    size_t values = 2000000;
+    size_t passes = 1000;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--values" && i + 1 < argc) values = std::strtoul(argv[++i], nullptr, 10);
+        else if (arg == "--passes" && i + 1 < argc) passes = std::strtoul(argv[++i], nullptr, 10);
+        else {
+            std::cerr << "Usage: " << argv[0] << " [--values 2000000] [--passes 1000]" << std::endl;
+            return 1;
+        }
+    }
+    if (!checkRoundTrip(values)) return 1;
+
+    const std::vector<std::string> strings = exchangeStrings(1000);
+    std::vector<double> doubles;
+    std::vector<Decimal> decimals;
+    for (const std::string& text : strings) {
+        Decimal value;
+        if (!Decimal::parse(text, value)) {
+            std::cerr << "Cannot parse " << text << std::endl;
+            return 1;
+        }
+        decimals.push_back(value);
+        doubles.push_back(std::stod(text));
+    }
+    const size_t iterations = passes * strings.size();
+    auto at = [&strings](size_t i) -> const std::string& { return strings[i % strings.size()]; };
+
+    double sink = 0;
+    double stodNs = timeCall([&](size_t i) { sink += std::stod(at(i)); }, iterations);
+    double fromCharsNs = timeCall([&](size_t i) {
+        const std::string& text = at(i);
+        double value = 0;
+        std::from_chars(text.data(), text.data() + text.size(), value);
+        sink += value;
+    }, iterations);
+    double parseNs = timeCall([&](size_t i) {
+        Decimal value;
+        Decimal::parse(at(i), value);
+        sink += value.units();
+    }, iterations);
+
+    char buffer[64];
+    double streamNs = timeCall([&](size_t i) {
+        std::ostringstream out;
+        out << std::fixed << std::setprecision(8) << doubles[i % doubles.size()];
+        sink += out.str().size();
+    }, iterations);
+    double toCharsNs = timeCall([&](size_t i) {
+        std::to_chars_result result = std::to_chars(buffer, buffer + sizeof(buffer), doubles[i % doubles.size()],
+                                                    std::chars_format::fixed, 8);
+        sink += result.ptr - buffer;
+    }, iterations);
+    double formatNs = timeCall([&](size_t i) {
+        char* end = decimals[i % decimals.size()].format(buffer, buffer + sizeof(buffer));
+        sink += end - buffer;
+    }, iterations);
+
+    std::cout << strings.size() << " exchange-style values (\"" << strings[0] << "\"), " << passes
+              << " passes (best of 3):\n"
+              << "  parse:  std::stod " << stodNs << " ns, from_chars(double) " << fromCharsNs << " ns, Decimal "
+              << parseNs << " ns\n"
+              << "  format: ostringstream fixed(8) " << streamNs << " ns, to_chars(double) " << toCharsNs
+              << " ns, Decimal " << formatNs << " ns" << std::endl;
+    return sink != 0 ? 0 : 1;
+}
@@ -0,0 +1,255 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <new>
+#include <nlohmann/json.hpp>
+#include "response_decoder.h"
+
+using json = nlohmann::json;
+
+// Every heap allocation in the process goes through these while counting.
+// GCC sees nlohmann's inlined new paired with our free and warns; they match.
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+static bool counting = false;
+static size_t allocations = 0;
+
+void* operator new(size_t size) {
+    if (counting) allocations++;
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+void* operator new[](size_t size) {
+    return operator new(size);
+}
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+void operator delete[](void* p) noexcept {
+    std::free(p);
+}
+void operator delete(void* p, size_t) noexcept {
+    std::free(p);
+}
+void operator delete[](void* p, size_t) noexcept {
+    std::free(p);
+}
+
+// The DOM code the decoders replaced: parse everything, read a few fields,
+// std::stod the numeric strings
+static TickerPrice domTicker(const std::string& body) {
+    json j = json::parse(body);
+    TickerPrice out;
+    out.symbol = j["symbol"].get<std::string>();
+    out.price = std::stod(j["price"].get<std::string>());
+    return out;
+}
+
+struct DomOrderAck {
+    std::string symbol;
+    int64_t orderId = 0;
+    std::string clientOrderId;
+    std::string status;
+    double price = 0;
+    double origQty = 0;
+    double executedQty = 0;
+    double cummulativeQuoteQty = 0;
+    double firstFillPrice = 0;
+    double averageFillPrice = 0;
+    int64_t transactTime = 0;
+};
+
+static DomOrderAck domOrderAck(const std::string& body) {
+    json j = json::parse(body);
+    DomOrderAck out;
+    out.symbol = j["symbol"].get<std::string>();
+    out.orderId = j["orderId"].get<int64_t>();
+    out.clientOrderId = j["clientOrderId"].get<std::string>();
+    out.status = j["status"].get<std::string>();
+    out.price = std::stod(j["price"].get<std::string>());
+    out.origQty = std::stod(j["origQty"].get<std::string>());
+    out.executedQty = std::stod(j["executedQty"].get<std::string>());
+    out.cummulativeQuoteQty = std::stod(j["cummulativeQuoteQty"].get<std::string>());
+    out.transactTime = j["transactTime"].get<int64_t>();
+    double quantity = 0, notional = 0;
+    for (const json& fill : j["fills"]) {
+        double price = std::stod(fill["price"].get<std::string>());
+        double qty = std::stod(fill["qty"].get<std::string>());
+        if (quantity == 0) out.firstFillPrice = price;
+        quantity += qty;
+        notional += price * qty;
+    }
+    if (quantity > 0) out.averageFillPrice = notional / quantity;
+    return out;
+}
+
+static AccountBalances domAccount(const std::string& body) {
+    json j = json::parse(body);
+    AccountBalances out;
+    out.canTrade = j["canTrade"].get<bool>();
+    out.accountType = j["accountType"].get<std::string>();
+    for (const json& balance : j["balances"]) {
+        double free = std::stod(balance["free"].get<std::string>());
+        double locked = std::stod(balance["locked"].get<std::string>());
+        if (free == 0 && locked == 0) continue;
+        out.balances.push_back({balance["asset"].get<std::string>(), free, locked});
+    }
+    return out;
+}
+
+static DepthSnapshot domDepth(const std::string& body) {
+    json j = json::parse(body);
+    DepthSnapshot out;
+    out.lastUpdateId = j["lastUpdateId"].get<int64_t>();
+    for (const json& level : j["bids"]) {
+        out.bids.push_back({std::stod(level[0].get<std::string>()), std::stod(level[1].get<std::string>())});
+    }
+    for (const json& level : j["asks"]) {
+        out.asks.push_back({std::stod(level[0].get<std::string>()), std::stod(level[1].get<std::string>())});
+    }
+    return out;
+}
+
+// Field checks, decoder against DOM
+static bool same(const TickerPrice& a, const TickerPrice& b) {
+    return a.symbol == b.symbol && a.price == b.price;
+}
+
+static bool same(const OrderAck& a, const DomOrderAck& b) {
+    return a.symbol == b.symbol && a.orderId == b.orderId && a.clientOrderId == b.clientOrderId &&
+           a.status == b.status && a.price == Decimal::fromDouble(b.price) &&
+           a.origQty == Decimal::fromDouble(b.origQty) && a.executedQty == Decimal::fromDouble(b.executedQty) &&
+           a.cummulativeQuoteQty == Decimal::fromDouble(b.cummulativeQuoteQty) &&
+           a.firstFillPrice == Decimal::fromDouble(b.firstFillPrice) &&
+           std::abs(a.averageFillPrice - b.averageFillPrice) < 1e-9 * b.averageFillPrice &&
+           a.updateTime == b.transactTime;
+}
+
+static bool same(const AccountBalances& a, const AccountBalances& b) {
+    if (a.canTrade != b.canTrade || a.accountType != b.accountType || a.balances.size() != b.balances.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.balances.size(); i++) {
+        const AccountBalances::Balance& x = a.balances[i];
+        const AccountBalances::Balance& y = b.balances[i];
+        if (x.asset != y.asset || x.free != y.free || x.locked != y.locked) return false;
+    }
+    return true;
+}
+
+static bool sameLevels(const std::vector<DepthLevel>& a, const std::vector<DepthLevel>& b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); i++) {
+        if (a[i].price != b[i].price || a[i].quantity != b[i].quantity) return false;
+    }
+    return true;
+}
+
+static bool same(const DepthSnapshot& a, const DepthSnapshot& b) {
+    return a.lastUpdateId == b.lastUpdateId && sameLevels(a.bids, b.bids) && sameLevels(a.asks, b.asks);
+}
+
+struct Measurement {
+    double ns;
+    size_t allocations;   // of one call
+};
+
+// Allocations of one call after a warm-up call, then best of three timed runs
+template <typename Call>
+static Measurement measure(Call call, size_t iterations) {
+    call();
+    allocations = 0;
+    counting = true;
+    call();
+    counting = false;
+    Measurement result{0, allocations};
+
+    for (int run = 0; run < 3; run++) {
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < iterations; i++) call();
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        if (run == 0 || ns < result.ns) result.ns = ns;
+    }
+    result.ns /= iterations;
+    return result;
+}
+
+static void report(const std::string& name, size_t bytes, const Measurement& dom, const Measurement& decoder) {
+    std::cout << name << " (" << bytes << " B): DOM " << dom.ns << " ns, " << dom.allocations
+              << " allocations; decoder " << decoder.ns << " ns, " << decoder.allocations << " allocations ("
+              << dom.ns / decoder.ns << "x)" << std::endl;
+}
+
+static bool readFile(const std::string& filename, std::string& out) {
+    std::ifstream file(filename);
+    if (!file) {
+        std::cerr << "Cannot open " << filename << std::endl;
+        return false;
+    }
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    out = buffer.str();
+    return true;
+}
+
+// Decodes the recorded responses in tests/responses with the typed decoders
+// and with the nlohmann DOM code they replaced, checks both read the same
+// values and reports time and heap allocations per response. Both fill a
+// new struct per response, as the callers do:
+//   decoder_bench [responses dir] [--iterations 2000]
+int main(int argc, char* argv[]) {
+    std::string dir = "tests/responses";
+    size_t iterations = 2000;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--iterations" && i + 1 < argc) iterations = std::strtoul(argv[++i], nullptr, 10);
+        else dir = arg;
+    }
+
+    std::string ticker, ack, account, depth;
+    if (!readFile(dir + "/ticker_price.json", ticker) || !readFile(dir + "/order_ack.json", ack) ||
+        !readFile(dir + "/account.json", account) || !readFile(dir + "/depth.json", depth)) {
+        return 1;
+    }
+
+    TickerPrice tickerOut;
+    OrderAck ackOut;
+    AccountBalances accountOut;
+    DepthSnapshot depthOut;
+    if (!decodeTickerPrice(ticker, tickerOut) || !decodeOrderAck(ack, ackOut) ||
+        !decodeAccountBalances(account, accountOut) || !decodeDepthSnapshot(depth, depthOut)) {
+        std::cerr << "A recorded response did not decode" << std::endl;
+        return 1;
+    }
+    bool ok = true;
+    if (!same(tickerOut, domTicker(ticker))) ok = false, std::cerr << "ticker_price differs" << std::endl;
+    if (!same(ackOut, domOrderAck(ack))) ok = false, std::cerr << "order_ack differs" << std::endl;
+    if (!same(accountOut, domAccount(account))) ok = false, std::cerr << "account differs" << std::endl;
+    if (!same(depthOut, domDepth(depth))) ok = false, std::cerr << "depth differs" << std::endl;
+    if (!ok) return 1;
+    std::cout << "Decoders and DOM agree on every field" << std::endl;
+
+    size_t sink = 0;
+    Measurement dom = measure([&] { sink += domTicker(ticker).symbol.size(); }, iterations * 10);
+    Measurement decoder = measure([&] { TickerPrice out; sink += decodeTickerPrice(ticker, out); }, iterations * 10);
+    report("ticker price", ticker.size(), dom, decoder);
+
+    dom = measure([&] { sink += domOrderAck(ack).orderId; }, iterations);
+    decoder = measure([&] { OrderAck out; sink += decodeOrderAck(ack, out); }, iterations);
+    report("order ack, " + std::to_string(ackOut.fillCount) + " fills", ack.size(), dom, decoder);
+
+    dom = measure([&] { sink += domAccount(account).balances.size(); }, iterations / 10 + 1);
+    decoder = measure([&] { AccountBalances out; sink += decodeAccountBalances(account, out); }, iterations / 10 + 1);
+    report("account, " + std::to_string(accountOut.balances.size()) + " non-zero balances", account.size(), dom,
+           decoder);
+
+    dom = measure([&] { sink += domDepth(depth).lastUpdateId; }, iterations / 2 + 1);
+    decoder = measure([&] { DepthSnapshot out; sink += decodeDepthSnapshot(depth, out); }, iterations / 2 + 1);
+    report("depth, " + std::to_string(depthOut.bids.size()) + "+" + std::to_string(depthOut.asks.size()) + " levels",
+           depth.size(), dom, decoder);
+    return sink > 0 ? 0 : 1;
+}
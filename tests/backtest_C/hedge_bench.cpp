@@ -0,0 +1,229 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <algorithm>
+#include <cstdint>
+#include "api.h"
+#include "async_http.h"
+#include "config/config.h"
+#include "response_decoder.h"
+
+using Clock = std::chrono::steady_clock;
+
+static double msSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// One GET: when it was answered, and when its hedge copy went out (if it did)
+struct Timing {
+    Clock::time_point submitted;
+    double latencyMs = 0;
+    double hedgeAfterMs = -1;
+    int attempts = 0;
+    bool hedged = false;
+    bool ok = false;
+};
+
+struct Run {
+    std::vector<Timing> timings;
+    double p50Ms = 0;
+    double p99Ms = 0;
+    double p95LowMs = 0;     // lowest and highest p95 of the endpoint during the run
+    double p95HighMs = 0;
+};
+
+static double endpointP95(const std::string& endpoint) {
+    for (const LatencyTracker::Summary& summary : AsyncHttpClient::getInstance().getStats().latency) {
+        if (summary.endpoint == endpoint) return summary.p95Ms;
+    }
+    return 0;
+}
+
+// `count` GETs of `url`, `concurrency` at a time, leaving the connections
+// above that free for hedge copies
+static Run runGets(const std::string& url, const std::string& endpoint, size_t count, size_t concurrency,
+                   const RetryPolicy& retry) {
+    AsyncHttpClient& client = AsyncHttpClient::getInstance();
+    Run run;
+    run.timings.resize(count);
+    run.p95LowMs = run.p95HighMs = endpointP95(endpoint);
+
+    std::mutex mutex;
+    std::condition_variable done;
+    size_t finished = 0;
+    for (size_t wave = 0; wave < count; wave += concurrency) {
+        size_t end = std::min(count, wave + concurrency);
+        for (size_t i = wave; i < end; i++) {
+            HttpRequest request;
+            request.url = url;
+            request.retry = retry;
+            Timing& timing = run.timings[i];
+            // Asked on the loop thread just before the hedge copy is sent
+            request.admitExtra = [&timing] {
+                timing.hedgeAfterMs = msSince(timing.submitted);
+                return true;
+            };
+            timing.submitted = Clock::now();
+            client.submit(std::move(request), [&, i](HttpResponse& response) {
+                Timing& timing = run.timings[i];
+                timing.latencyMs = msSince(timing.submitted);
+                timing.attempts = response.attempts;
+                timing.hedged = response.hedged;
+                timing.ok = response.ok() && response.status == 200;
+                std::lock_guard<std::mutex> lock(mutex);
+                finished++;
+                done.notify_all();
+            });
+        }
+        std::unique_lock<std::mutex> lock(mutex);
+        done.wait(lock, [&] { return finished == end; });
+        lock.unlock();
+
+        double p95 = endpointP95(endpoint);
+        run.p95LowMs = std::min(run.p95LowMs, p95);
+        run.p95HighMs = std::max(run.p95HighMs, p95);
+    }
+
+    std::vector<double> latencies;
+    for (const Timing& timing : run.timings) latencies.push_back(timing.latencyMs);
+    std::sort(latencies.begin(), latencies.end());
+    run.p50Ms = latencies[count / 2];
+    run.p99Ms = latencies[count * 99 / 100];
+    return run;
+}
+
+// The same GETs without and with hedging: copies go out no sooner than the
+// endpoint's p95, the first answer is the one returned, the copy that lost is
+// dropped, and the tail comes down
+static bool checkHedging(const std::string& base, size_t count, double tailMs) {
+    AsyncHttpClient& client = AsyncHttpClient::getInstance();
+    const std::string endpoint = base + "/api/v3/ticker/price";
+    const std::string url = endpoint + "?symbol=BTCUSDT";
+
+    RetryPolicy plain;
+    Run unhedged = runGets(url, endpoint, count, 4, plain);
+
+    RetryPolicy hedging;
+    hedging.hedge = true;
+    hedging.minHedgeDelay = std::chrono::milliseconds(1);   // so the p95 alone decides
+    AsyncHttpClient::Stats before = client.getStats();
+    Run hedged = runGets(url, endpoint, count, 4, hedging);
+    AsyncHttpClient::Stats after = client.getStats();
+
+    size_t failed = 0, copies = 0, wins = 0, early = 0, slow = 0;
+    std::vector<double> hedgeDelays;
+    for (const Timing& timing : unhedged.timings) failed += !timing.ok;
+    for (const Timing& timing : hedged.timings) {
+        failed += !timing.ok;
+        if (timing.hedgeAfterMs < 0) continue;
+        copies++;
+        wins += timing.hedged;
+        hedgeDelays.push_back(timing.hedgeAfterMs);
+        // The p95 in use is refreshed every few replies, so it may trail the
+        // lowest one seen between waves a little
+        early += timing.hedgeAfterMs < hedged.p95LowMs - 1;
+        // Only losing both draws of the tail leaves a raced request slow
+        slow += timing.latencyMs >= tailMs;
+    }
+    std::sort(hedgeDelays.begin(), hedgeDelays.end());
+    double medianDelayMs = hedgeDelays.empty() ? 0 : hedgeDelays[hedgeDelays.size() / 2];
+    uint64_t sent = after.hedges - before.hedges;
+    uint64_t hedgeWins = after.hedgeWins - before.hedgeWins;
+    uint64_t cancelled = after.cancelled - before.cancelled;
+
+    std::cout << count << " GETs, " << tailMs << " ms tail: unhedged p50 " << unhedged.p50Ms << " ms, p99 "
+              << unhedged.p99Ms << " ms; hedged p50 " << hedged.p50Ms << " ms, p99 " << hedged.p99Ms << " ms"
+              << std::endl;
+    std::cout << sent << " hedge copies (endpoint p95 " << hedged.p95LowMs << "-" << hedged.p95HighMs
+              << " ms, copies sent after " << (hedgeDelays.empty() ? 0 : hedgeDelays.front()) << " ms at the "
+              << "earliest, median " << medianDelayMs << " ms), " << hedgeWins << " answered first, " << cancelled
+              << " losing copies dropped, " << slow << " raced requests still slow, " << failed << " failed"
+              << std::endl;
+
+    bool ok = true;
+    if (failed != 0 || client.inFlight() != 0) {
+        ok = false;
+        std::cerr << "Requests failed or were left in flight" << std::endl;
+    }
+    if (sent == 0 || sent != copies || early != 0 || medianDelayMs > hedged.p95HighMs + 5) {
+        ok = false;
+        std::cerr << "Hedge copies did not go out right after the endpoint's p95" << std::endl;
+    }
+    if (wins != hedgeWins || wins == 0 || slow * 10 > copies + 10) {
+        ok = false;
+        std::cerr << "Raced requests did not get the first answer" << std::endl;
+    }
+    if (cancelled != copies) {
+        ok = false;
+        std::cerr << "Expected one copy dropped per raced request" << std::endl;
+    }
+    if (hedged.p99Ms * 2 > unhedged.p99Ms) {
+        ok = false;
+        std::cerr << "Hedging did not cut the tail" << std::endl;
+    }
+    return ok;
+}
+
+// Orders through BinanceAPI, one at a time so the stand-in numbers them in
+// sequence: its slow tail must not make the engine send any of them twice,
+// even once the endpoint has enough samples for a p95
+static bool checkOrdersNotHedged(size_t count) {
+    BinanceAPI api;
+    AsyncHttpClient& client = AsyncHttpClient::getInstance();
+    AsyncHttpClient::Stats before = client.getStats();
+
+    int64_t firstId = 0, lastId = 0;
+    size_t failed = 0;
+    for (size_t i = 0; i < count; i++) {
+        std::string query = "symbol=BTCUSDT&side=BUY&type=LIMIT&timeInForce=GTC&quantity=0.001&price=46000"
+                            "&newClientOrderId=hedge-" + std::to_string(i);
+        std::string body = api.send_signed_request_async("/api/v3/order", query, "POST").get();
+        OrderAck ack;
+        if (!decodeOrderAck(body, ack)) {
+            if (failed++ == 0) std::cerr << "Order failed: " << body << std::endl;
+            continue;
+        }
+        if (i == 0) firstId = ack.orderId;
+        lastId = ack.orderId;
+    }
+    AsyncHttpClient::Stats after = client.getStats();
+    uint64_t sent = after.hedges - before.hedges;
+    uint64_t retries = after.retries - before.retries;
+
+    std::cout << count << " orders: " << sent << " hedge copies, " << retries << " retries, the stand-in placed "
+              << lastId - firstId + 1 << " orders" << std::endl;
+    if (failed != 0 || sent != 0 || retries != 0 || lastId - firstId + 1 != static_cast<int64_t>(count)) {
+        std::cerr << "An order was sent more than once" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// Request hedging against a stand-in with a slow tail, reached through the
+// configured base_url (run from a directory whose config.json points at it);
+// --tail must match the stand-in's:
+//   limit_server --port 8080 --delay 20 --tail 300 --tail-rate 0.03 &
+//   hedge_bench [--requests 600] [--orders 60] [--tail 300]
+int main(int argc, char* argv[]) {
+    size_t requests = 600;
+    size_t orders = 60;
+    double tailMs = 300;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--requests" && i + 1 < argc) requests = std::stoul(argv[++i]);
+        else if (arg == "--orders" && i + 1 < argc) orders = std::stoul(argv[++i]);
+        else if (arg == "--tail" && i + 1 < argc) tailMs = std::stod(argv[++i]);
+        else {
+            std::cerr << "Usage: " << argv[0] << " [--requests 600] [--orders 60] [--tail 300]" << std::endl;
+            return 1;
+        }
+    }
+
+    std::string base = Config::getInstance().getSetting("base_url");
+    bool ok = checkHedging(base, requests, tailMs);
+    ok &= checkOrdersNotHedged(orders);
+    return ok ? 0 : 1;
+}
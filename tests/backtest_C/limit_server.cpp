@@ -0,0 +1,356 @@
+#include <iostream>
+#include <string>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <map>
+#include <random>
+#include <cstring>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <openssl/ssl.h>
+#include <openssl/err.h>
+#include "rate_limiter.h"
+
+// Local REST stand-in for the exchange that enforces its rate limits, so the
+// RequestScheduler can be exercised without risking a ban:
+//   limit_server [--port 8080] [--weight 6000] [--orders 100] [--delay ms] [--skew ms]
+//                [--tail ms] [--tail-rate 0.05] [--tls cert.pem key.pem]
+// Weight is counted per minute and orders per 10 seconds in fixed windows
+// aligned to the clock, as the exchange does, and every response carries
+// X-MBX-USED-WEIGHT-1M and X-MBX-ORDER-COUNT-10S. A request over a limit gets
+// 429 with Retry-After.
+// --delay adds round-trip latency, e.g. to make concurrent requests overlap.
+// --tail holds a random --tail-rate share of the responses back that much
+// longer, for the slow tail that request hedging is meant to cut.
+// --skew runs the server clock ahead (or, negative, behind) the local one;
+// signed requests are checked against it like the exchange does: rejected
+// with -1021 when the timestamp is more than 1s ahead of the server or older
+// than recvWindow (default 5000 ms).
+// Orders are kept by clientOrderId: market orders fill at once, limit orders
+// stay NEW until canceled. Market data answers are fixed (price 46402.40):
+// /api/v3/depth is a five-level book at lastUpdateId 1000, /api/v3/klines
+// the current minute and /api/v3/exchangeInfo the BTCUSDT filters of the
+// testnet.
+// --tls serves HTTPS with that certificate, e.g. a self-signed one for
+// 127.0.0.1 passed to the client as ca_bundle (see pool_latency.sh).
+// Point the bot at it with "base_url": "http://127.0.0.1:8080".
+
+// Fixed window starting on a multiple of its length in wall-clock time
+struct Window {
+    std::chrono::seconds length;
+    int64_t index = 0;
+    int used = 0;
+
+    void roll(std::chrono::system_clock::time_point now) {
+        int64_t current = now.time_since_epoch() / length;
+        if (current != index) {
+            index = current;
+            used = 0;
+        }
+    }
+    int secondsLeft(std::chrono::system_clock::time_point now) const {
+        auto left = length - now.time_since_epoch() % length;
+        return static_cast<int>(std::chrono::ceil<std::chrono::seconds>(left).count());
+    }
+};
+
+static std::mutex limitsMutex;
+static Window weightWindow{std::chrono::seconds(60)};
+static Window orderWindow{std::chrono::seconds(10)};
+static int weightLimit = 6000;
+static int orderLimit = 100;
+static int responseDelayMs = 0;
+static int64_t clockSkewMs = 0;
+static int tailDelayMs = 0;
+static double tailRate = 0.05;
+static std::atomic<long> served{0};
+static std::atomic<long> rejected{0};
+
+static SSL_CTX* tlsContext = nullptr;
+
+// Accepted socket, TLS when --tls is given
+struct Connection {
+    int fd;
+    SSL* ssl = nullptr;
+
+    ssize_t receive(char* data, size_t size) {
+        return ssl ? SSL_read(ssl, data, static_cast<int>(size)) : recv(fd, data, size, 0);
+    }
+    ssize_t sendSome(const char* data, size_t size) {
+        return ssl ? SSL_write(ssl, data, static_cast<int>(size)) : send(fd, data, size, MSG_NOSIGNAL);
+    }
+    void close() {
+        if (ssl) {
+            SSL_shutdown(ssl);
+            SSL_free(ssl);
+        }
+        ::close(fd);
+    }
+};
+
+static bool sendAll(Connection& connection, const std::string& data) {
+    size_t offset = 0;
+    while (offset < data.size()) {
+        ssize_t sent = connection.sendSome(data.data() + offset, data.size() - offset);
+        if (sent <= 0) return false;
+        offset += sent;
+    }
+    return true;
+}
+
+static int64_t serverTimeMs() {
+    auto now = std::chrono::system_clock::now().time_since_epoch();
+    return std::chrono::duration_cast<std::chrono::milliseconds>(now).count() + clockSkewMs;
+}
+
+// Numeric query parameter, `fallback` if absent
+static int64_t queryNumber(const std::string& target, const std::string& key, int64_t fallback) {
+    size_t pos = target.find("?" + key + "=");
+    if (pos == std::string::npos) pos = target.find("&" + key + "=");
+    if (pos == std::string::npos) return fallback;
+    return std::stoll(target.substr(pos + key.size() + 2));
+}
+
+// Text query parameter, "" if absent
+static std::string queryText(const std::string& target, const std::string& key) {
+    size_t pos = target.find("?" + key + "=");
+    if (pos == std::string::npos) pos = target.find("&" + key + "=");
+    if (pos == std::string::npos) return "";
+    pos += key.size() + 2;
+    return target.substr(pos, target.find('&', pos) - pos);
+}
+
+// Orders placed so far, by clientOrderId
+struct StandinOrder {
+    int64_t orderId;
+    std::string type;
+    std::string status;
+};
+static std::mutex ordersMutex;
+static std::map<std::string, StandinOrder> orders;
+static int64_t nextOrderId = 1;
+
+static std::string orderJson(const std::string& clientOrderId, const StandinOrder& order, const std::string& extra) {
+    bool filled = order.status == "FILLED";
+    return "{\"symbol\":\"BTCUSDT\",\"orderId\":" + std::to_string(order.orderId) + ",\"clientOrderId\":\"" +
+           clientOrderId + "\"," + extra + "\"transactTime\":" + std::to_string(serverTimeMs()) +
+           ",\"price\":\"" + (order.type == "LIMIT" ? "46000.00" : "0.00") + "\",\"origQty\":\"0.00100000\","
+           "\"executedQty\":\"" + (filled ? "0.00100000" : "0.00000000") + "\",\"cummulativeQuoteQty\":\"" +
+           (filled ? "46.40" : "0.00") + "\",\"status\":\"" + order.status + "\",\"type\":\"" + order.type + "\"," +
+           "\"fills\":[" + (filled ? "{\"price\":\"46402.40\",\"qty\":\"0.00100000\"}" : "") + "]}";
+}
+
+// /api/v3/order for POST (place), GET (query) and DELETE (cancel)
+static std::string orderBody(const std::string& method, const std::string& target, std::string& status) {
+    std::lock_guard<std::mutex> lock(ordersMutex);
+    if (method == "POST") {
+        std::string clientOrderId = queryText(target, "newClientOrderId");
+        if (clientOrderId.empty()) clientOrderId = "standin" + std::to_string(nextOrderId);
+        std::string type = queryText(target, "type");
+        StandinOrder order{nextOrderId++, type, type == "LIMIT" ? "NEW" : "FILLED"};
+        orders[clientOrderId] = order;
+        return orderJson(clientOrderId, order, "");
+    }
+    std::string clientOrderId = queryText(target, "origClientOrderId");
+    auto it = orders.find(clientOrderId);
+    if (it == orders.end()) {
+        status = "400 Bad Request";
+        return method == "DELETE" ? "{\"code\":-2011,\"msg\":\"Unknown order sent.\"}"
+                                  : "{\"code\":-2013,\"msg\":\"Order does not exist.\"}";
+    }
+    if (method == "DELETE") {
+        if (it->second.status != "NEW") {
+            status = "400 Bad Request";
+            return "{\"code\":-2011,\"msg\":\"Unknown order sent.\"}";
+        }
+        it->second.status = "CANCELED";
+        return orderJson("cancel" + std::to_string(it->second.orderId), it->second,
+                         "\"origClientOrderId\":\"" + clientOrderId + "\",");
+    }
+    return orderJson(clientOrderId, it->second, "");
+}
+
+static std::string responseBody(const std::string& path) {
+    if (path == "/api/v3/ticker/price") return "{\"symbol\":\"BTCUSDT\",\"price\":\"46402.40\"}";
+    if (path == "/api/v3/ticker/bookTicker") {
+        return "{\"symbol\":\"BTCUSDT\",\"bidPrice\":\"46402.40\",\"bidQty\":\"0.50000000\","
+               "\"askPrice\":\"46402.50\",\"askQty\":\"0.40000000\"}";
+    }
+    if (path == "/api/v3/klines") {
+        int64_t openTime = serverTimeMs() / 60000 * 60000;
+        return "[[" + std::to_string(openTime) + ",\"46390.00\",\"46410.00\",\"46385.10\",\"46402.40\",\"12.50000000\"," +
+               std::to_string(openTime + 59999) + ",\"580031.20\",412,\"6.1\",\"283050.7\",\"0\"]]";
+    }
+    if (path == "/api/v3/depth") {
+        return "{\"lastUpdateId\":1000,"
+               "\"bids\":[[\"46402.40\",\"0.50000000\"],[\"46402.30\",\"1.20000000\"],[\"46402.00\",\"2.00000000\"],"
+               "[\"46401.50\",\"0.75000000\"],[\"46400.00\",\"5.00000000\"]],"
+               "\"asks\":[[\"46402.50\",\"0.40000000\"],[\"46402.60\",\"1.00000000\"],[\"46403.00\",\"2.50000000\"],"
+               "[\"46404.00\",\"1.00000000\"],[\"46410.00\",\"4.00000000\"]]}";
+    }
+    if (path == "/api/v3/exchangeInfo") {
+        return "{\"timezone\":\"UTC\",\"symbols\":[{\"symbol\":\"BTCUSDT\",\"status\":\"TRADING\","
+               "\"baseAsset\":\"BTC\",\"quoteAsset\":\"USDT\",\"filters\":["
+               "{\"filterType\":\"PRICE_FILTER\",\"minPrice\":\"0.01000000\",\"maxPrice\":\"1000000.00000000\","
+               "\"tickSize\":\"0.01000000\"},"
+               "{\"filterType\":\"LOT_SIZE\",\"minQty\":\"0.00001000\",\"maxQty\":\"9000.00000000\","
+               "\"stepSize\":\"0.00001000\"},"
+               "{\"filterType\":\"MARKET_LOT_SIZE\",\"minQty\":\"0.00000000\",\"maxQty\":\"100.00000000\","
+               "\"stepSize\":\"0.00000000\"},"
+               "{\"filterType\":\"NOTIONAL\",\"minNotional\":\"5.00000000\",\"applyMinToMarket\":true,"
+               "\"maxNotional\":\"9000000.00000000\",\"applyMaxToMarket\":false,\"avgPriceMins\":5},"
+               "{\"filterType\":\"PERCENT_PRICE_BY_SIDE\",\"bidMultiplierUp\":\"5\",\"bidMultiplierDown\":\"0.2\","
+               "\"askMultiplierUp\":\"5\",\"askMultiplierDown\":\"0.2\",\"avgPriceMins\":5}]}]}";
+    }
+    if (path == "/api/v3/time") return "{\"serverTime\":" + std::to_string(serverTimeMs()) + "}";
+    if (path == "/api/v3/account") {
+        return "{\"canTrade\":true,\"accountType\":\"SPOT\",\"balances\":[{\"asset\":\"USDT\",\"free\":\"1000.00\",\"locked\":\"0.00\"}]}";
+    }
+    return "{}";
+}
+
+static void serveConnection(int fd) {
+    Connection connection{fd};
+    if (tlsContext) {
+        connection.ssl = SSL_new(tlsContext);
+        SSL_set_fd(connection.ssl, fd);
+        if (SSL_accept(connection.ssl) != 1) {
+            connection.close();
+            return;
+        }
+    }
+
+    std::string buffer;
+    char chunk[4096];
+    while (true) {
+        size_t end;
+        while ((end = buffer.find("\r\n\r\n")) == std::string::npos) {
+            ssize_t received = connection.receive(chunk, sizeof(chunk));
+            if (received <= 0 || buffer.size() > 65536) {
+                connection.close();
+                return;
+            }
+            buffer.append(chunk, received);
+        }
+        std::string request = buffer.substr(0, end);
+        buffer.erase(0, end + 4);  // requests carry their parameters in the URL, never a body
+
+        std::string line = request.substr(0, request.find("\r\n"));
+        size_t space = line.find(' ');
+        std::string method = line.substr(0, space);
+        std::string target = line.substr(space + 1, line.find(' ', space + 1) - space - 1);
+        std::string path = target.substr(0, target.find('?'));
+        RequestCost cost = requestCost(method, target);
+
+        // Half the delay on the way in and half on the way out, like network latency
+        if (responseDelayMs > 0) std::this_thread::sleep_for(std::chrono::microseconds(responseDelayMs * 500));
+
+        std::string status = "200 OK";
+        std::string body;
+        std::string extra;
+        {
+            std::lock_guard<std::mutex> lock(limitsMutex);
+            std::chrono::system_clock::time_point now = std::chrono::system_clock::now();
+            weightWindow.roll(now);
+            orderWindow.roll(now);
+            weightWindow.used += cost.weight;  // rejected requests still cost weight
+            if (weightWindow.used > weightLimit) {
+                status = "429 Too Many Requests";
+                extra = "Retry-After: " + std::to_string(weightWindow.secondsLeft(now)) + "\r\n";
+            } else if (cost.countsOrder && orderWindow.used + 1 > orderLimit) {
+                status = "429 Too Many Requests";
+                extra = "Retry-After: " + std::to_string(orderWindow.secondsLeft(now)) + "\r\n";
+            } else if (cost.countsOrder) {
+                orderWindow.used++;
+            }
+            extra += "X-MBX-USED-WEIGHT-1M: " + std::to_string(weightWindow.used) + "\r\n";
+            extra += "X-MBX-ORDER-COUNT-10S: " + std::to_string(orderWindow.used) + "\r\n";
+        }
+        int64_t timestamp = queryNumber(target, "timestamp", 0);
+        int64_t now = serverTimeMs();
+        if (status[0] == '4') {
+            body = "{\"code\":-1003,\"msg\":\"Too many requests.\"}";
+            rejected++;
+        } else if (timestamp > 0 && (timestamp > now + 1000 || now - timestamp > queryNumber(target, "recvWindow", 5000))) {
+            status = "400 Bad Request";
+            body = "{\"code\":-1021,\"msg\":\"Timestamp for this request is outside of the recvWindow.\"}";
+            rejected++;
+        } else {
+            body = path == "/api/v3/order" ? orderBody(method, target, status) : responseBody(path);
+            served++;
+        }
+
+        if (responseDelayMs > 0) std::this_thread::sleep_for(std::chrono::microseconds(responseDelayMs * 500));
+        if (tailDelayMs > 0) {
+            thread_local std::minstd_rand random(std::random_device{}());
+            if (std::uniform_real_distribution<double>(0, 1)(random) < tailRate) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(tailDelayMs));
+            }
+        }
+        std::string response = "HTTP/1.1 " + status + "\r\n"
+                               "Content-Type: application/json\r\n"
+                               "Content-Length: " + std::to_string(body.size()) + "\r\n" + extra + "\r\n" + body;
+        if (!sendAll(connection, response)) {
+            connection.close();
+            return;
+        }
+    }
+}
+
+int main(int argc, char* argv[]) {
+    int port = 8080;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--port" && i + 1 < argc) port = std::stoi(argv[++i]);
+        else if (arg == "--weight" && i + 1 < argc) weightLimit = std::stoi(argv[++i]);
+        else if (arg == "--orders" && i + 1 < argc) orderLimit = std::stoi(argv[++i]);
+        else if (arg == "--delay" && i + 1 < argc) responseDelayMs = std::stoi(argv[++i]);
+        else if (arg == "--skew" && i + 1 < argc) clockSkewMs = std::stoll(argv[++i]);
+        else if (arg == "--tail" && i + 1 < argc) tailDelayMs = std::stoi(argv[++i]);
+        else if (arg == "--tail-rate" && i + 1 < argc) tailRate = std::stod(argv[++i]);
+        else if (arg == "--tls" && i + 2 < argc) {
+            tlsContext = SSL_CTX_new(TLS_server_method());
+            if (SSL_CTX_use_certificate_chain_file(tlsContext, argv[i + 1]) != 1 ||
+                SSL_CTX_use_PrivateKey_file(tlsContext, argv[i + 2], SSL_FILETYPE_PEM) != 1) {
+                std::cerr << "Cannot load " << argv[i + 1] << " / " << argv[i + 2] << ": "
+                          << ERR_reason_error_string(ERR_get_error()) << std::endl;
+                return 1;
+            }
+            i += 2;
+        }
+    }
+
+    int listener = socket(AF_INET, SOCK_STREAM, 0);
+    int yes = 1;
+    setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons(port);
+    if (bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || listen(listener, 64) != 0) {
+        std::cerr << "Cannot listen on port " << port << ": " << strerror(errno) << std::endl;
+        return 1;
+    }
+    std::cout << "Serving on " << (tlsContext ? "https" : "http") << "://127.0.0.1:" << port << " with " << weightLimit << " weight/1m, "
+              << orderLimit << " orders/10s, clock skew " << clockSkewMs << " ms, "
+              << tailRate * 100 << "% of responses " << tailDelayMs << " ms late" << std::endl;
+
+    // Summary every 10 seconds
+    std::thread([] {
+        while (true) {
+            std::this_thread::sleep_for(std::chrono::seconds(10));
+            std::cout << "served " << served << ", rejected " << rejected << std::endl;
+        }
+    }).detach();
+
+    while (true) {
+        int fd = accept(listener, nullptr, nullptr);
+        if (fd < 0) continue;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes));
+        std::thread(serveConnection, fd).detach();
+    }
+}
@@ -0,0 +1,138 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include <cstring>
+#include <curl/curl.h>
+#include "connection_pool.h"
+
+static size_t discardBody(void*, size_t size, size_t nmemb, void*) {
+    return size * nmemb;
+}
+
+struct Options {
+    std::string url = "https://127.0.0.1:8443";
+    std::string caBundle;
+    size_t requests = 400;
+    unsigned threads = 4;
+};
+
+// One request on `curl`, as the API calls send it; microseconds, or -1
+static double timeRequest(CURL* curl, const Options& options, const std::string& target, bool post) {
+    std::string url = options.url + target;
+    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+    if (post) {
+        curl_easy_setopt(curl, CURLOPT_POST, 1L);
+        curl_easy_setopt(curl, CURLOPT_POSTFIELDS, "");
+    } else {
+        curl_easy_setopt(curl, CURLOPT_HTTPGET, 1L);
+    }
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, discardBody);
+    if (!options.caBundle.empty()) curl_easy_setopt(curl, CURLOPT_CAINFO, options.caBundle.c_str());
+
+    auto start = std::chrono::steady_clock::now();
+    CURLcode res = curl_easy_perform(curl);
+    double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    if (res != CURLE_OK) {
+        std::cerr << url << ": " << curl_easy_strerror(res) << std::endl;
+        return -1;
+    }
+    return us;
+}
+
+// Before the pool: a new easy handle, and so a new connection and TLS
+// handshake, for every request
+static double freshHandleRequest(const Options& options, const std::string& target, bool post) {
+    CURL* curl = curl_easy_init();
+    if (!curl) return -1;
+    curl_easy_setopt(curl, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_1_1);
+    curl_easy_setopt(curl, CURLOPT_TIMEOUT, 30L);
+    curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, 1L);
+    curl_easy_setopt(curl, CURLOPT_SSL_VERIFYHOST, 2L);
+    double us = timeRequest(curl, options, target, post);
+    curl_easy_cleanup(curl);
+    return us;
+}
+
+static double pooledRequest(const Options& options, const std::string& target, bool post) {
+    ConnectionPool::Handle handle = ConnectionPool::getInstance().acquire();
+    if (!handle) return -1;
+    return timeRequest(handle.get(), options, target, post);
+}
+
+static std::string orderTarget(size_t i) {
+    return "/api/v3/order?symbol=BTCUSDT&side=BUY&type=MARKET&quantity=0.001&newClientOrderId=bench" +
+           std::to_string(i);
+}
+
+// Runs `requests` requests on `threads` threads and prints p50/p99
+template <typename Request>
+static bool measure(const char* name, size_t requests, unsigned threads, Request request) {
+    std::vector<std::vector<double>> perThread(threads);
+    std::vector<std::thread> workers;
+    std::atomic<bool> failed{false};
+    for (unsigned t = 0; t < threads; t++) {
+        workers.emplace_back([&, t] {
+            for (size_t i = t; i < requests; i += threads) {
+                double us = request(i);
+                if (us < 0) {
+                    failed = true;
+                    return;
+                }
+                perThread[t].push_back(us);
+            }
+        });
+    }
+    for (std::thread& worker : workers) worker.join();
+    if (failed) return false;
+
+    std::vector<double> latencies;
+    for (const std::vector<double>& samples : perThread) latencies.insert(latencies.end(), samples.begin(), samples.end());
+    std::sort(latencies.begin(), latencies.end());
+    auto percentile = [&](double p) { return latencies[static_cast<size_t>(p * (latencies.size() - 1))]; };
+    std::cout << name << ": " << latencies.size() << " requests, p50 " << static_cast<long>(percentile(0.5))
+              << " us, p99 " << static_cast<long>(percentile(0.99)) << " us" << std::endl;
+    return true;
+}
+
+// Request latency with a new curl handle per request (the code before the
+// connection pool) against pooled, kept-alive handles, for the ticker GET and
+// an order POST; the pooled GET is also run from several threads. Run it
+// against an HTTPS stand-in such as limit_server --tls, see pool_latency.sh:
+//   pool_latency [--url https://127.0.0.1:8443] [--cacert cert.pem] [--requests 400] [--threads 4]
+int main(int argc, char* argv[]) {
+    Options options;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--url" && i + 1 < argc) options.url = argv[++i];
+        else if (arg == "--cacert" && i + 1 < argc) options.caBundle = argv[++i];
+        else if (arg == "--requests" && i + 1 < argc) options.requests = std::stoul(argv[++i]);
+        else if (arg == "--threads" && i + 1 < argc) options.threads = std::stoul(argv[++i]);
+        else {
+            std::cerr << "Usage: " << argv[0]
+                      << " [--url https://127.0.0.1:8443] [--cacert cert.pem] [--requests 400] [--threads 4]"
+                      << std::endl;
+            return 1;
+        }
+    }
+    curl_global_init(CURL_GLOBAL_DEFAULT);
+    const std::string ticker = "/api/v3/ticker/price?symbol=BTCUSDT";
+    const size_t n = options.requests;
+
+    // Open the pooled connections first so their handshakes are not counted
+    pooledRequest(options, ticker, false);
+
+    bool ok = measure("ticker GET, new handle", n, 1, [&](size_t) { return freshHandleRequest(options, ticker, false); }) &&
+              measure("ticker GET, pooled", n, 1, [&](size_t) { return pooledRequest(options, ticker, false); }) &&
+              measure("order POST, new handle", n, 1, [&](size_t i) { return freshHandleRequest(options, orderTarget(i), true); }) &&
+              measure("order POST, pooled", n, 1, [&](size_t i) { return pooledRequest(options, orderTarget(n + i), true); });
+    if (ok && options.threads > 1) {
+        std::string name = "ticker GET, pooled, " + std::to_string(options.threads) + " threads";
+        ok = measure(name.c_str(), n, options.threads, [&](size_t) { return pooledRequest(options, ticker, false); });
+    }
+    std::cout << ConnectionPool::getInstance().createdHandles() << " pooled handles created" << std::endl;
+    return ok ? 0 : 1;
+}
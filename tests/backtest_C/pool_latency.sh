@@ -0,0 +1,22 @@
+#!/bin/sh
+# Connection pool latency against a local HTTPS stand-in: makes a
+# self-signed certificate for 127.0.0.1, serves it with limit_server --tls
+# and runs pool_latency against it. Build both first (make), then from the
+# repository root:
+#   tests/backtest_C/pool_latency.sh [port] [pool_latency options...]
+set -e
+PORT=${1:-8443}
+[ $# -gt 0 ] && shift
+
+DIR=$(mktemp -d)
+trap 'kill $SERVER 2>/dev/null; rm -rf "$DIR"' EXIT
+
+openssl req -x509 -newkey rsa:2048 -nodes -days 1 -subj /CN=127.0.0.1 \
+    -addext subjectAltName=IP:127.0.0.1 -keyout "$DIR/key.pem" -out "$DIR/cert.pem" 2>/dev/null
+
+# No order limit, the benchmark places a few hundred orders in seconds
+./limit_server --port "$PORT" --orders 1000000 --tls "$DIR/cert.pem" "$DIR/key.pem" > "$DIR/server.log" &
+SERVER=$!
+sleep 0.5
+
+./pool_latency --url "https://127.0.0.1:$PORT" --cacert "$DIR/cert.pem" "$@"
@@ -0,0 +1,276 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <thread>
+#include <cstring>
+#include <cctype>
+#include <algorithm>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <openssl/evp.h>
+#include <openssl/sha.h>
+#include <nlohmann/json.hpp>
+#include "bar_store.h"
+
+// Local WebSocket stand-in for the exchange's market data streams. Replays a
+// bar CSV (or bar store) as closed klines, trades and book tickers on whatever
+// streams the client subscribes to, so MarketDataStream can be exercised and
+// timed without network access:
+//   replay_server [--port 9001] [--speed 60] [--drop-every N] [data file]
+// --speed is a multiple of real time (60 = one 1m bar per second, 0 = as fast
+// as possible). --drop-every closes the connection after every N bars to test
+// reconnects; the replay resumes where it stopped.
+
+using json = nlohmann::json;
+using Clock = std::chrono::steady_clock;
+
+static bool sendAll(int fd, const char* data, size_t length) {
+    while (length > 0) {
+        ssize_t sent = send(fd, data, length, MSG_NOSIGNAL);
+        if (sent <= 0) return false;
+        data += sent;
+        length -= sent;
+    }
+    return true;
+}
+
+static bool recvAll(int fd, char* data, size_t length) {
+    while (length > 0) {
+        ssize_t received = recv(fd, data, length, 0);
+        if (received <= 0) return false;
+        data += received;
+        length -= received;
+    }
+    return true;
+}
+
+// Server frames are never masked
+static bool sendFrame(int fd, const std::string& payload, unsigned char opcode = 0x1) {
+    std::string frame;
+    frame += static_cast<char>(0x80 | opcode);
+    if (payload.size() < 126) {
+        frame += static_cast<char>(payload.size());
+    } else if (payload.size() <= 0xFFFF) {
+        frame += static_cast<char>(126);
+        frame += static_cast<char>(payload.size() >> 8);
+        frame += static_cast<char>(payload.size() & 0xFF);
+    } else {
+        frame += static_cast<char>(127);
+        for (int shift = 56; shift >= 0; shift -= 8) {
+            frame += static_cast<char>((static_cast<uint64_t>(payload.size()) >> shift) & 0xFF);
+        }
+    }
+    frame += payload;
+    return sendAll(fd, frame.data(), frame.size());
+}
+
+// One client frame (always masked); false when the connection is gone
+static bool readFrame(int fd, unsigned char& opcode, std::string& payload) {
+    unsigned char header[2];
+    if (!recvAll(fd, reinterpret_cast<char*>(header), 2)) return false;
+    opcode = header[0] & 0x0F;
+    uint64_t length = header[1] & 0x7F;
+    if (length >= 126) {
+        unsigned char extended[8];
+        size_t bytes = length == 126 ? 2 : 8;
+        if (!recvAll(fd, reinterpret_cast<char*>(extended), bytes)) return false;
+        length = 0;
+        for (size_t i = 0; i < bytes; i++) length = (length << 8) | extended[i];
+    }
+    unsigned char mask[4] = {0, 0, 0, 0};
+    if ((header[1] & 0x80) && !recvAll(fd, reinterpret_cast<char*>(mask), 4)) return false;
+    payload.resize(length);
+    if (length > 0 && !recvAll(fd, &payload[0], length)) return false;
+    for (size_t i = 0; i < length; i++) payload[i] ^= mask[i % 4];
+    return true;
+}
+
+static bool handshake(int fd) {
+    std::string request;
+    char buffer[1024];
+    while (request.find("\r\n\r\n") == std::string::npos) {
+        ssize_t received = recv(fd, buffer, sizeof(buffer), 0);
+        if (received <= 0 || request.size() > 16384) return false;
+        request.append(buffer, received);
+    }
+
+    std::string lower = request;
+    std::transform(lower.begin(), lower.end(), lower.begin(), [](unsigned char c) { return std::tolower(c); });
+    size_t pos = lower.find("sec-websocket-key:");
+    if (pos == std::string::npos) return false;
+    pos += strlen("sec-websocket-key:");
+    size_t end = request.find("\r\n", pos);
+    std::string key = request.substr(pos, end - pos);
+    key.erase(0, key.find_first_not_of(" \t"));
+    key.erase(key.find_last_not_of(" \t") + 1);
+
+    std::string accept = key + "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
+    unsigned char digest[SHA_DIGEST_LENGTH];
+    SHA1(reinterpret_cast<const unsigned char*>(accept.data()), accept.size(), digest);
+    unsigned char encoded[64];
+    EVP_EncodeBlock(encoded, digest, SHA_DIGEST_LENGTH);
+
+    std::string response = "HTTP/1.1 101 Switching Protocols\r\n"
+                           "Upgrade: websocket\r\n"
+                           "Connection: Upgrade\r\n"
+                           "Sec-WebSocket-Accept: " + std::string(reinterpret_cast<char*>(encoded)) + "\r\n\r\n";
+    return sendAll(fd, response.data(), response.size());
+}
+
+static std::string decimal(double value) {
+    char text[32];
+    snprintf(text, sizeof(text), "%.8f", value);
+    return text;
+}
+
+// Payload for one bar on one stream, wrapped the way combined streams are
+static std::string streamMessage(const std::string& stream, const BarColumns& bars, size_t i) {
+    std::string symbol = stream.substr(0, stream.find('@'));
+    std::transform(symbol.begin(), symbol.end(), symbol.begin(), [](unsigned char c) { return std::toupper(c); });
+    std::string kind = stream.substr(stream.find('@') + 1);
+    int64_t now = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    int64_t openTime = bars.timestamp[i] * 1000;
+
+    json data;
+    if (kind.rfind("kline_", 0) == 0) {
+        data = {{"e", "kline"}, {"E", now}, {"s", symbol},
+                {"k", {{"t", openTime}, {"T", openTime + 59999}, {"s", symbol}, {"i", kind.substr(6)},
+                       {"o", decimal(bars.open[i])}, {"c", decimal(bars.close[i])},
+                       {"h", decimal(bars.high[i])}, {"l", decimal(bars.low[i])},
+                       {"v", decimal(bars.volume[i])}, {"x", true}}}};
+    } else if (kind == "trade") {
+        data = {{"e", "trade"}, {"E", now}, {"s", symbol}, {"t", i},
+                {"p", decimal(bars.close[i])}, {"q", decimal(bars.volume[i])},
+                {"T", openTime}, {"m", false}};
+    } else if (kind == "bookTicker") {
+        data = {{"u", i}, {"s", symbol},
+                {"b", decimal(bars.close[i] - 0.01)}, {"B", "1.00000000"},
+                {"a", decimal(bars.close[i] + 0.01)}, {"A", "1.00000000"}};
+    } else {
+        return "";
+    }
+    return json({{"stream", stream}, {"data", data}}).dump();
+}
+
+// Handle client frames until `deadline`; false when the client went away
+static bool serviceClient(int fd, std::vector<std::string>& streams, Clock::time_point deadline) {
+    while (true) {
+        int timeout = static_cast<int>(std::max<int64_t>(0,
+            std::chrono::duration_cast<std::chrono::milliseconds>(deadline - Clock::now()).count()));
+        pollfd fds{fd, POLLIN, 0};
+        if (poll(&fds, 1, timeout) <= 0) return true;
+
+        unsigned char opcode;
+        std::string payload;
+        if (!readFrame(fd, opcode, payload)) return false;
+        if (opcode == 0x8) {
+            sendFrame(fd, payload, 0x8);
+            return false;
+        }
+        if (opcode == 0x9) {
+            sendFrame(fd, payload, 0xA);
+        } else if (opcode == 0x1) {
+            json request = json::parse(payload, nullptr, false);
+            if (!request.is_discarded() && request.value("method", "") == "SUBSCRIBE") {
+                for (const auto& stream : request["params"]) {
+                    streams.push_back(stream.get<std::string>());
+                }
+                sendFrame(fd, json({{"result", nullptr}, {"id", request["id"]}}).dump());
+            }
+        }
+    }
+}
+
+int main(int argc, char* argv[]) {
+    std::string dataFile = "tests/historical_data/BTCUSDT_1m_historical_data.csv";
+    int port = 9001;
+    double speed = 60;
+    size_t dropEvery = 0;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--port" && i + 1 < argc) port = std::stoi(argv[++i]);
+        else if (arg == "--speed" && i + 1 < argc) speed = std::stod(argv[++i]);
+        else if (arg == "--drop-every" && i + 1 < argc) dropEvery = std::stoul(argv[++i]);
+        else dataFile = arg;
+    }
+
+    BarTable table;
+    BarStore store;
+    BarColumns bars;
+    if (BarStore::isBarStore(dataFile)) {
+        if (!store.open(dataFile)) return 1;
+        bars = store.columns();
+    } else {
+        if (!loadBarsCsv(dataFile, table)) return 1;
+        bars = table.columns();
+    }
+
+    int listener = socket(AF_INET, SOCK_STREAM, 0);
+    int yes = 1;
+    setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons(port);
+    if (bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || listen(listener, 4) != 0) {
+        std::cerr << "Cannot listen on port " << port << ": " << strerror(errno) << std::endl;
+        return 1;
+    }
+    std::cout << "Replaying " << bars.count << " bars on ws://127.0.0.1:" << port
+              << " at " << speed << "x" << std::endl;
+
+    size_t cursor = 0;
+    size_t connections = 0;
+    while (cursor < bars.count) {
+        int fd = accept(listener, nullptr, nullptr);
+        if (fd < 0) continue;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes));
+        if (!handshake(fd)) {
+            close(fd);
+            continue;
+        }
+        connections++;
+
+        // Nothing to send until the client subscribes
+        std::vector<std::string> streams;
+        Clock::time_point waitUntil = Clock::now() + std::chrono::seconds(5);
+        bool alive = true;
+        while (alive && streams.empty() && Clock::now() < waitUntil) {
+            alive = serviceClient(fd, streams, std::min(waitUntil, Clock::now() + std::chrono::milliseconds(50)));
+        }
+
+        Clock::time_point start = Clock::now();
+        int64_t startTimestamp = bars.timestamp[cursor];
+        size_t sent = 0;
+        while (alive && cursor < bars.count) {
+            Clock::time_point due = start;
+            if (speed > 0) {
+                due += std::chrono::duration_cast<Clock::duration>(
+                    std::chrono::duration<double>((bars.timestamp[cursor] - startTimestamp) / speed));
+            }
+            alive = serviceClient(fd, streams, due);
+
+            for (size_t s = 0; alive && s < streams.size(); s++) {
+                std::string message = streamMessage(streams[s], bars, cursor);
+                if (!message.empty()) alive = sendFrame(fd, message);
+            }
+            if (!alive) break;
+            cursor++;
+            sent++;
+            if (dropEvery > 0 && sent == dropEvery) break;  // simulate a dropped connection
+        }
+
+        if (cursor == bars.count) sendFrame(fd, "", 0x8);
+        close(fd);
+        std::cout << "Connection " << connections << ": sent " << sent << " bars ("
+                  << cursor << "/" << bars.count << ")" << std::endl;
+    }
+
+    close(listener);
+    return 0;
+}
@@ -0,0 +1,105 @@
+#include <iostream>
+#include <string>
+#include <chrono>
+#include <cstdlib>
+#include <new>
+#include "request_builder.h"
+#include "hmac_signer.h"
+
+// Every heap allocation in the process goes through these while counting
+static bool counting = false;
+static size_t allocations = 0;
+
+void* operator new(size_t size) {
+    if (counting) allocations++;
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+void* operator new[](size_t size) {
+    return operator new(size);
+}
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    if (counting) allocations++;
+    return std::malloc(size ? size : 1);
+}
+void* operator new[](size_t size, const std::nothrow_t& tag) noexcept {
+    return operator new(size, tag);
+}
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+void operator delete[](void* p) noexcept {
+    std::free(p);
+}
+void operator delete(void* p, size_t) noexcept {
+    std::free(p);
+}
+void operator delete[](void* p, size_t) noexcept {
+    std::free(p);
+}
+
+// The system clock, as ClockSync uses before its first sample; the real
+// clock would start its sync thread against the exchange
+static int64_t nowMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+// A limit order as OrderManager::sendOrder builds it, plus what
+// BinanceAPI::send_signed_request adds before sending
+static bool buildLimitOrder(RequestBuilder& request, const HmacSigner& signer, int64_t timestamp) {
+    request.url("https://testnet.binance.vision", "/api/v3/order");
+    request.add("symbol", "BTCUSDT")
+           .add("type", "LIMIT")
+           .add("side", "BUY")
+           .add("timeInForce", "GTC")
+           .add("quantity", Decimal::fromUnits(123456), 5)
+           .add("price", Decimal::fromUnits(4640240000000), 2)
+           .add("newClientOrderId", "cb-1700000000000-42");
+    request.add("recvWindow", static_cast<int64_t>(5000));
+    request.addTimestamp(timestamp);
+    return request.sign(signer) && request.ok();
+}
+
+// Builds, timestamps and signs a limit order through RequestBuilder with
+// operator new counting and fails if anything was allocated:
+//   request_alloc [--iterations 100000]
+int main(int argc, char* argv[]) {
+    size_t iterations = 100000;
+    if (argc == 3 && std::string(argv[1]) == "--iterations") {
+        iterations = std::strtoul(argv[2], nullptr, 10);
+    } else if (argc != 1) {
+        std::cerr << "Usage: " << argv[0] << " [--iterations 100000]" << std::endl;
+        return 1;
+    }
+
+    HmacSigner signer(std::string(64, 'k'));
+    RequestBuilder request;
+    // OpenSSL sets up its per-thread state on the first signature
+    buildLimitOrder(request, signer, nowMs());
+
+    counting = true;
+    auto start = std::chrono::steady_clock::now();
+    bool ok = true;
+    for (size_t i = 0; i < iterations; i++) {
+        ok &= buildLimitOrder(request, signer, nowMs());
+    }
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    counting = false;
+
+    // Checked after counting, this allocates
+    std::string query(request.query());
+    std::string expected = "symbol=BTCUSDT&type=LIMIT&side=BUY&timeInForce=GTC&quantity=0.00123&price=46402.40"
+                           "&newClientOrderId=cb-1700000000000-42&recvWindow=5000&timestamp=";
+    size_t signature = query.find("&signature=");
+    if (!ok || query.compare(0, expected.size(), expected) != 0 || signature == std::string::npos ||
+        query.size() - signature - 11 != HmacSigner::HEX_SIZE ||
+        signer.sign(query.substr(0, signature)) != query.substr(signature + 11)) {
+        std::cerr << "Unexpected request: " << request.str() << std::endl;
+        return 1;
+    }
+
+    std::cout << iterations << " signed limit orders, " << ns / iterations << " ns each, " << allocations
+              << " allocations" << std::endl;
+    return allocations == 0 ? 0 : 1;
+}
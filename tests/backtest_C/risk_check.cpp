@@ -0,0 +1,201 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <thread>
+#include <cstdio>
+#include <cstdlib>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "api.h"
+#include "pre_trade_risk.h"
+#include "response_decoder.h"
+
+using Clock = std::chrono::steady_clock;
+
+// Our limits under test, written to the config this tool runs with
+static const int MAX_ORDER_RATE = 1000000;
+static const char* CONFIG = "{\"settings\": {\"base_url\": \"%s\", \"min_order_size\": \"10\", "
+                            "\"max_position\": \"1\", \"max_order_rate\": \"1000000\"}}";
+
+static size_t failures = 0;
+
+static void expect(bool condition, const std::string& what) {
+    if (!condition) {
+        std::cerr << "Failed: " << what << std::endl;
+        failures++;
+    }
+}
+
+static Decimal number(const char* text) {
+    Decimal value;
+    expect(Decimal::parse(text, value), std::string("parse ") + text);
+    return value;
+}
+
+// One order that the limit_server filters (tick 0.01, step 0.00001, qty up to
+// 9000 and 100 at market, notional 5..9e6, price within 0.2x..5x) and our
+// limits must refuse for `reason`
+struct Case {
+    const char* name;
+    const char* symbol;
+    bool buy;
+    bool market;
+    const char* quantity;
+    const char* price;
+    double reference;
+    RiskReject reason;
+};
+
+static const Case CASES[] = {
+    {"symbol without filters", "ETHUSDT", true, false, "0.01", "3000", 3000, RiskReject::UnknownSymbol},
+    {"symbol in BREAK", "BTCBRK", true, false, "0.001", "46000", 46402.4, RiskReject::NotTrading},
+    {"quantity under the step", "BTCUSDT", true, false, "0.000009", "46000", 46402.4, RiskReject::QuantityTooSmall},
+    {"quantity over maxQty", "BTCUSDT", true, false, "9000.00001", "46000", 46402.4, RiskReject::QuantityTooLarge},
+    {"market quantity over the market maxQty", "BTCUSDT", false, true, "100.5", "0", 46402.4,
+     RiskReject::QuantityTooLarge},
+    {"price rounded down to 0", "BTCUSDT", true, false, "0.001", "0.009", 46402.4, RiskReject::PriceOutOfRange},
+    {"price over maxPrice", "BTCUSDT", false, false, "0.001", "1000000.01", 46402.4, RiskReject::PriceOutOfRange},
+    {"buy over 5x the market", "BTCUSDT", true, false, "0.001", "232100", 46402.4, RiskReject::PercentPrice},
+    {"sell under 0.2x the market", "BTCUSDT", false, false, "0.01", "9280", 46402.4, RiskReject::PercentPrice},
+    {"limit without a market price", "BTCUSDT", true, false, "0.001", "46000", 0, RiskReject::NoReferencePrice},
+    {"market without a market price", "BTCUSDT", true, true, "0.001", "0", 0, RiskReject::NoReferencePrice},
+    {"notional under min_order_size", "BTCUSDT", true, false, "0.0002", "46000", 46402.4,
+     RiskReject::NotionalTooSmall},
+    {"market notional under min_order_size", "BTCUSDT", true, true, "0.0002", "0", 46402.4,
+     RiskReject::NotionalTooSmall},
+    {"notional over maxNotional", "BTCUSDT", true, false, "200", "46000", 46402.4, RiskReject::NotionalTooLarge},
+    {"position over max_position", "BTCUSDT", true, false, "1.5", "46000", 46402.4, RiskReject::MaxPosition},
+};
+
+static void checkRejects(PreTradeRisk& risk) {
+    for (const Case& order : CASES) {
+        RiskCheck check = risk.check(order.symbol, order.buy, order.market, number(order.quantity),
+                                     number(order.price), order.reference);
+        expect(check.reject == order.reason, std::string(order.name) + ": expected " + riskRejectName(order.reason) +
+               ", got " + riskRejectName(check.reject));
+    }
+
+    // Filled position counts; an order that takes it back towards 0 passes
+    risk.recordFill("BTCUSDT", true, number("0.8"));
+    RiskCheck more = risk.check("BTCUSDT", true, false, number("0.3"), number("46000"), 46402.4);
+    RiskCheck back = risk.check("BTCUSDT", false, false, number("1.5"), number("46500"), 46402.4);
+    expect(more.reject == RiskReject::MaxPosition, std::string("buy to 1.1 with 1 allowed: ") +
+           riskRejectName(more.reject));
+    expect(back.ok(), std::string("sell from 0.8 to -0.7: ") + riskRejectName(back.reject));
+}
+
+// Price to the tick, down for a buy and up for a sell; quantity down to the
+// step; both with the filter's decimals
+static void checkRounding(PreTradeRisk& risk) {
+    struct Rounding {
+        bool buy;
+        bool market;
+        const char* quantity;
+        const char* price;
+        const char* sentQuantity;
+        const char* sentPrice;
+    };
+    const Rounding cases[] = {
+        {true, false, "0.001", "46402.409", "0.001", "46402.40"},
+        {false, false, "0.001", "46402.401", "0.001", "46402.41"},
+        {false, false, "0.001", "46402.40", "0.001", "46402.40"},
+        {true, false, "0.12345678", "46402.40", "0.12345", "46402.40"},
+        {false, true, "0.98765432", "0", "0.98765", "0"},
+        {false, true, "1.00001999", "0", "1.00001", "0"},
+    };
+    for (const Rounding& order : cases) {
+        RiskCheck check = risk.check("BTCUSDT", order.buy, order.market, number(order.quantity), number(order.price),
+                                     46402.4);
+        std::string name = std::string(order.buy ? "buy " : "sell ") + order.quantity + " @ " + order.price;
+        expect(check.ok(), name + ": " + riskRejectName(check.reject));
+        expect(check.quantity == number(order.sentQuantity) && check.price == number(order.sentPrice) &&
+               check.quantityDecimals == 5 && check.priceDecimals == 2,
+               name + ": expected " + order.sentQuantity + " @ " + order.sentPrice + ", got " +
+               check.quantity.toString() + " @ " + check.price.toString());
+    }
+}
+
+// A second's worth of max_order_rate checks that all pass, timed; the next
+// one within the second is over the rate
+static double timeChecks(PreTradeRisk& risk) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1100));   // empty the rate window
+    const Decimal quantity = number("0.001");
+    const Decimal price = number("46402.409");
+    size_t passed = 0;
+    Clock::time_point start = Clock::now();
+    for (int i = 0; i < MAX_ORDER_RATE; i++) passed += risk.check("BTCUSDT", i & 1, false, quantity, price, 46402.4).ok();
+    double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / MAX_ORDER_RATE;
+
+    RiskCheck over = risk.check("BTCUSDT", true, false, quantity, price, 46402.4);
+    expect(passed == MAX_ORDER_RATE, std::to_string(passed) + " of " + std::to_string(MAX_ORDER_RATE) +
+           " checks within the rate passed");
+    expect(over.reject == RiskReject::OrderRate, std::string("order over max_order_rate: ") +
+           riskRejectName(over.reject));
+    return ns;
+}
+
+// PreTradeRisk with the filters limit_server serves: every reject reason on
+// an order that should get it, tick and step rounding, and the time per
+// check. Writes the limits it tests to a config in a scratch directory and
+// runs there:
+//   limit_server --port 8080 &
+//   risk_check [--url http://127.0.0.1:8080]
+int main(int argc, char* argv[]) {
+    std::string base = "http://127.0.0.1:8080";
+    if (argc == 3 && std::string(argv[1]) == "--url") {
+        base = argv[2];
+    } else if (argc != 1) {
+        std::cerr << "Usage: " << argv[0] << " [--url http://127.0.0.1:8080]" << std::endl;
+        return 1;
+    }
+
+    char directory[] = "/tmp/risk_checkXXXXXX";
+    if (!mkdtemp(directory) || chdir(directory) != 0 || mkdir("config", 0755) != 0) {
+        std::cerr << "Cannot set up a scratch directory" << std::endl;
+        return 1;
+    }
+    {
+        char config[512];
+        std::snprintf(config, sizeof(config), CONFIG, base.c_str());
+        std::ofstream("config/config.json") << config;
+    }
+
+    BinanceAPI api;
+    PreTradeRisk risk;
+    // Config has read the file by now
+    std::remove("config/config.json");
+    rmdir("config");
+    if (chdir("/") == 0) rmdir(directory);
+
+    std::vector<SymbolInfo> infos;
+    if (!risk.loadFilters(api, {"BTCUSDT"}) ||
+        !decodeExchangeInfo(api.send_public_request("/api/v3/exchangeInfo?symbol=BTCUSDT"), infos) || infos.empty()) {
+        std::cerr << "No exchangeInfo from " << base << std::endl;
+        return 1;
+    }
+    SymbolInfo halted = infos[0];
+    halted.symbol = "BTCBRK";
+    halted.status = "BREAK";
+    risk.setFilters(halted);
+
+    checkRejects(risk);
+    checkRounding(risk);
+    double ns = timeChecks(risk);
+
+    PreTradeRisk::Stats stats = risk.getStats();
+    size_t reasons = 0;
+    for (size_t reason = 1; reason < static_cast<size_t>(RiskReject::Count); reason++) {
+        reasons += stats.rejected[reason] > 0;
+        expect(stats.rejected[reason] > 0, std::string("no order rejected for ") +
+               riskRejectName(static_cast<RiskReject>(reason)));
+    }
+    std::cout << stats.checked << " checks, " << stats.passed << " passed, " << reasons << " of "
+              << static_cast<size_t>(RiskReject::Count) - 1 << " reject reasons seen; " << ns
+              << " ns per check" << std::endl;
+    expect(ns < 1000, "a check takes under a microsecond");
+
+    std::cout << (failures == 0 ? "All checks passed" : std::to_string(failures) + " checks failed") << std::endl;
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,231 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <charconv>
+#include "async_http.h"
+#include "request_scheduler.h"
+
+using Clock = std::chrono::steady_clock;
+
+// Responses of a group of requests, in the order they arrive
+struct Batch {
+    std::mutex mutex;
+    std::condition_variable done;
+    std::vector<HttpResponse> responses;
+
+    AsyncHttpClient::Callback callback() {
+        return [this](HttpResponse& response) {
+            std::lock_guard<std::mutex> lock(mutex);
+            responses.push_back(response);
+            done.notify_all();
+        };
+    }
+    bool wait(size_t count, std::chrono::seconds timeout) {
+        std::unique_lock<std::mutex> lock(mutex);
+        return done.wait_for(lock, timeout, [&] { return responses.size() >= count; });
+    }
+};
+
+static HttpRequest request(const std::string& url, const std::string& method = "GET") {
+    HttpRequest out;
+    out.url = url;
+    out.method = method;
+    return out;
+}
+
+static long usedWeight(const HttpResponse& response) {
+    std::string_view text = response.header("X-MBX-USED-WEIGHT-1M");
+    long used = -1;
+    std::from_chars(text.data(), text.data() + text.size(), used);
+    return used;
+}
+
+// Seconds left in the current minute, the window the stand-in counts weight in
+static long secondsLeftInMinute() {
+    auto now = std::chrono::system_clock::now().time_since_epoch();
+    return 60 - std::chrono::duration_cast<std::chrono::seconds>(now).count() % 60;
+}
+
+// Identical public GETs submitted at once go out as one request: the
+// stand-in's weight count grows by one request's weight
+static bool checkCoalescing(RequestScheduler& scheduler, const std::string& base, size_t callers) {
+    const std::string url = base + "/api/v3/depth?symbol=BTCUSDT&limit=100";
+    const RequestCost cost = requestCost("GET", "/api/v3/depth?symbol=BTCUSDT&limit=100");
+    uint64_t coalescedBefore = scheduler.getStats().coalesced;
+
+    Batch batch;
+    for (size_t i = 0; i < callers; i++) scheduler.submitShared(request(url), cost, batch.callback());
+    if (!batch.wait(callers, std::chrono::seconds(10))) {
+        std::cerr << "Coalesced requests did not all complete" << std::endl;
+        return false;
+    }
+    bool same = true;
+    for (const HttpResponse& response : batch.responses) {
+        same &= response.ok() && response.status == 200 && response.body == batch.responses[0].body;
+    }
+
+    // The next request's header shows what the stand-in counted meanwhile
+    Batch next;
+    scheduler.submit(request(base + "/api/v3/ticker/price?symbol=BTCUSDT"),
+                     requestCost("GET", "/api/v3/ticker/price?symbol=BTCUSDT"), next.callback());
+    next.wait(1, std::chrono::seconds(10));
+    long counted = usedWeight(next.responses.at(0)) - usedWeight(batch.responses[0]);
+    uint64_t coalesced = scheduler.getStats().coalesced - coalescedBefore;
+
+    std::cout << callers << " identical GETs: " << coalesced << " coalesced, the stand-in counted weight "
+              << counted - 2 << " for them after the first" << std::endl;
+    if (!same || coalesced != callers - 1 || counted != 2) {
+        std::cerr << "Expected one request shared by all callers" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// Another client spends most of the minute's weight behind the scheduler's
+// back; the usage header must hold the scheduler's flood back to what is
+// left, so nothing gets a 429. While the flood waits for the next window an
+// order (which may use the reserve) goes at once, and an account request
+// queued after the flood starts ahead of it when the window opens.
+static bool checkHeaderAndPriority(RequestScheduler& scheduler, const std::string& base) {
+    AsyncHttpClient& client = AsyncHttpClient::getInstance();
+    const std::string heavy = "/api/v3/depth?symbol=BTCUSDT&limit=5000";      // weight 250
+    const std::string flood = "/api/v3/depth?symbol=BTCUSDT&limit=1000";      // weight 50
+    const std::string ticker = "/api/v3/ticker/price?symbol=BTCUSDT";
+
+    // Outside the scheduler, like another process on the same IP
+    std::vector<std::future<HttpResponse>> burned;
+    for (int i = 0; i < 18; i++) burned.push_back(client.submit(request(base + heavy)));
+    long used = 0;
+    for (std::future<HttpResponse>& future : burned) used = std::max(used, usedWeight(future.get()));
+
+    // One scheduled request brings the stand-in's count back in the header
+    Batch first;
+    scheduler.submit(request(base + ticker), requestCost("GET", ticker), first.callback());
+    first.wait(1, std::chrono::seconds(10));
+    std::cout << "Another client used " << used << " weight; the header now says "
+              << usedWeight(first.responses.at(0)) << std::endl;
+
+    // Start order of everything scheduled from here on
+    std::mutex orderMutex;
+    std::vector<std::string> started;
+    auto recordStart = [&](const std::string& name) {
+        return [&, name](HttpRequest&) {
+            std::lock_guard<std::mutex> lock(orderMutex);
+            started.push_back(name);
+            return true;
+        };
+    };
+
+    // 40 x 50 weight would be over the stand-in's limit if sent now
+    const size_t floodSize = 40;
+    Batch floodBatch;
+    for (size_t i = 0; i < floodSize; i++) {
+        scheduler.submit(request(base + flood), requestCost("GET", flood), floodBatch.callback(), recordStart("data"));
+    }
+    Clock::time_point queued = Clock::now();
+
+    Batch orderBatch;
+    const std::string order = "/api/v3/order?symbol=BTCUSDT&side=BUY&type=LIMIT&timeInForce=GTC"
+                              "&quantity=0.001&price=46000&newClientOrderId=scheduler-check";
+    scheduler.submit(request(base + order, "POST"), requestCost("POST", order), orderBatch.callback(),
+                     recordStart("order"));
+    orderBatch.wait(1, std::chrono::seconds(5));
+    double orderMs = std::chrono::duration<double, std::milli>(Clock::now() - queued).count();
+    size_t floodDoneBeforeOrder = floodBatch.responses.size();
+
+    // Queued behind the flood; once it has the order to look up
+    Batch accountBatch;
+    const std::string query = "/api/v3/order?symbol=BTCUSDT&origClientOrderId=scheduler-check";
+    size_t dataBeforeAccount;
+    {
+        std::lock_guard<std::mutex> lock(orderMutex);
+        dataBeforeAccount = started.size() - 1;    // all but the order
+    }
+    scheduler.submit(request(base + query), requestCost("GET", query), accountBatch.callback(),
+                     recordStart("account"));
+
+    if (!floodBatch.wait(floodSize, std::chrono::seconds(75)) || !accountBatch.wait(1, std::chrono::seconds(5))) {
+        std::cerr << "Queued requests did not complete" << std::endl;
+        return false;
+    }
+    double floodMs = std::chrono::duration<double, std::milli>(Clock::now() - queued).count();
+
+    size_t limited = 0;
+    for (const HttpResponse& response : floodBatch.responses) limited += response.status != 200;
+    size_t sentEarly = 0;    // data requests started before the account request
+    for (const std::string& name : started) {
+        if (name == "account") break;
+        if (name == "data") sentEarly++;
+    }
+    RequestScheduler::Stats stats = scheduler.getStats();
+
+    std::cout << floodSize << " requests of weight 50: " << sentEarly << " fit the rest of the window, all done in "
+              << floodMs << " ms, " << limited << " not 200, " << stats.limited << " 429s seen" << std::endl;
+    std::cout << "Order done in " << orderMs << " ms with " << floodDoneBeforeOrder
+              << " data requests done; the account request queued after " << dataBeforeAccount
+              << " had started and started after " << sentEarly << std::endl;
+
+    bool ok = true;
+    if (limited != 0 || stats.limited != 0) {
+        ok = false;
+        std::cerr << "The scheduler went over the weight the header reported" << std::endl;
+    }
+    if (sentEarly >= floodSize || floodMs < 1000) {
+        ok = false;
+        std::cerr << "The flood was not held back for the next window" << std::endl;
+    }
+    if (orderBatch.responses.size() != 1 || orderBatch.responses[0].status != 200 || orderMs > 1000) {
+        ok = false;
+        std::cerr << "The order waited behind market data" << std::endl;
+    }
+    if (sentEarly != dataBeforeAccount) {
+        ok = false;
+        std::cerr << "Market data queued before the account request started ahead of it" << std::endl;
+    }
+    if (accountBatch.responses[0].status != 200) {
+        ok = false;
+        std::cerr << "The order query failed: " << accountBatch.responses[0].status << " "
+                  << accountBatch.responses[0].body << std::endl;
+    }
+    return ok;
+}
+
+// RequestScheduler against the rate-limited stand-in with its default limits
+// (the scheduler's defaults too): identical GETs coalesce, usage headers
+// keep it under the limit another client nearly used up, and orders and
+// account requests go ahead of queued market data. Waits for the stand-in's
+// next weight window, so it takes up to a minute:
+//   limit_server --port 8080 --delay 20 &
+//   scheduler_check [--url http://127.0.0.1:8080]
+int main(int argc, char* argv[]) {
+    std::string base = "http://127.0.0.1:8080";
+    if (argc == 3 && std::string(argv[1]) == "--url") {
+        base = argv[2];
+    } else if (argc != 1) {
+        std::cerr << "Usage: " << argv[0] << " [--url http://127.0.0.1:8080]" << std::endl;
+        return 1;
+    }
+
+    // All of it has to happen in one weight window that nothing else has
+    // used much of yet
+    std::future<HttpResponse> probe =
+        AsyncHttpClient::getInstance().submit(request(base + "/api/v3/ticker/price?symbol=BTCUSDT"));
+    HttpResponse probed = probe.get();
+    if (!probed.ok() || probed.status != 200) {
+        std::cerr << "No stand-in at " << base << std::endl;
+        return 1;
+    }
+    if (secondsLeftInMinute() < 20 || usedWeight(probed) > 500) {
+        std::cout << "Waiting " << secondsLeftInMinute() << " s for the next weight window" << std::endl;
+        std::this_thread::sleep_for(std::chrono::seconds(secondsLeftInMinute() + 1));
+    }
+
+    RequestScheduler scheduler;
+    if (!checkCoalescing(scheduler, base, 16)) return 1;
+    return checkHeaderAndPriority(scheduler, base) ? 0 : 1;
+}
@@ -0,0 +1,75 @@
+#include <iostream>
+#include <string>
+#include <thread>
+#include <chrono>
+#include "api.h"
+#include "order_manager.h"
+#include "market_stream.h"
+#include "SMA_strategy.h"
+#include "enhanced_strategy.h"
+#include "config/config.h"
+
+// Runs a strategy on the configured market data streams (point ws_url at
+// replay_server for a local run) and reports tick-to-signal latency:
+//   stream_latency [--events N] [--enhanced]
+// Stops after N signal evaluations or once no event arrived for 10 seconds.
+template <typename Strategy>
+static void runStrategy(Strategy& strategy, MarketDataStream& stream, uint64_t events) {
+    strategy.attachMarketData(stream);
+    stream.start();
+    std::thread strategyThread(&Strategy::run, &strategy);
+
+    uint64_t lastReceived = 0;
+    auto lastProgress = std::chrono::steady_clock::now();
+    while (true) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        MarketDataStream::Stats stats = stream.getStats();
+        if (stats.signals >= events) break;
+        if (stats.received != lastReceived) {
+            lastReceived = stats.received;
+            lastProgress = std::chrono::steady_clock::now();
+        } else if (std::chrono::steady_clock::now() - lastProgress > std::chrono::seconds(10)) {
+            std::cerr << "No market data for 10 seconds, stopping" << std::endl;
+            break;
+        }
+    }
+
+    strategy.stop();
+    stream.stop();
+    strategyThread.join();
+}
+
+int main(int argc, char* argv[]) {
+    uint64_t events = 1000;
+    bool enhanced = false;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--events" && i + 1 < argc) events = std::stoull(argv[++i]);
+        else if (arg == "--enhanced") enhanced = true;
+    }
+
+    BinanceAPI api;
+    OrderManager orderManager;
+    std::string symbol = Config::getInstance().getSetting("default_market", "BTCUSDT");
+    MarketDataStream stream(MarketDataStream::configuredStreams(symbol));
+
+    if (enhanced) {
+        EnhancedTradingStrategy strategy(api, orderManager, symbol);
+        runStrategy(strategy, stream, events);
+    } else {
+        SMAStrategy strategy(api, orderManager, symbol, 10, 50);
+        runStrategy(strategy, stream, events);
+    }
+
+    MarketDataStream::Stats stats = stream.getStats();
+    std::cout << "\n=== Market Data Stream ===" << std::endl;
+    std::cout << "Events received: " << stats.received << std::endl;
+    std::cout << "Events dropped: " << stats.dropped << std::endl;
+    std::cout << "Parse errors: " << stats.parseErrors << std::endl;
+    std::cout << "Connections: " << stats.connects << std::endl;
+    std::cout << "Signals evaluated: " << stats.signals << std::endl;
+    std::cout << "Tick-to-signal latency (us): mean " << stats.latencyMeanUs
+              << ", p50 " << stats.latencyP50Us << ", p99 " << stats.latencyP99Us
+              << ", max " << stats.latencyMaxUs << std::endl;
+    return 0;
+}
@@ -0,0 +1,164 @@
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include <nlohmann/json.hpp>
+#include "api.h"
+#include "backtester.h"
+#include "order_manager.h"
+#include "enhanced_strategy.h"
+#include "indicator_cache.h"
+#include "thread_pool.h"
+
+using json = nlohmann::json;
+
+struct SweepPoint {
+    int fastEMA;
+    int slowEMA;
+    int signalEMA;
+    int rsiPeriod;
+    double rsiOverbought;
+    double rsiOversold;
+};
+
+struct SweepResult {
+    SweepPoint params;
+    BacktestResult result;
+};
+
+// The RSI axes only reach the short-side rules; the backtester trades long,
+// and the long entry and exit use RSI 14 with fixed 40/65 and 40/70 bands,
+// so sweeping them repeats the same runs
+static const char* const SHORT_ONLY_AXES[] = {"rsiPeriod", "rsiOverbought", "rsiOversold"};
+
+// Values for one grid axis, or the strategy default if the axis is missing
+template <typename T>
+std::vector<T> gridAxis(const json& grid, const std::string& key, T defaultValue) {
+    if (!grid.contains(key)) return {defaultValue};
+    return grid[key].get<std::vector<T>>();
+}
+
+std::vector<SweepPoint> buildGrid(const json& grid) {
+    std::vector<SweepPoint> points;
+    for (int fast : gridAxis(grid, "fastEMA", 12))
+    for (int slow : gridAxis(grid, "slowEMA", 26))
+    for (int signal : gridAxis(grid, "signalEMA", 9))
+    for (int rsiPeriod : gridAxis(grid, "rsiPeriod", 14))
+    for (double overbought : gridAxis(grid, "rsiOverbought", 70.0))
+    for (double oversold : gridAxis(grid, "rsiOversold", 30.0)) {
+        if (fast >= slow || oversold >= overbought) continue;  // Not a meaningful combination
+        points.push_back({fast, slow, signal, rsiPeriod, overbought, oversold});
+    }
+    return points;
+}
+
+// Runs one EnhancedTradingStrategy + Backtester per grid point over a single
+// shared copy of the bar data and prints the runs ranked by total return:
+//   sweep [config/sweep.json]
+int main(int argc, char* argv[]) {
+    std::string sweepFile = argc > 1 ? argv[1] : "config/sweep.json";
+
+    json sweep;
+    try {
+        std::ifstream file(sweepFile);
+        file >> sweep;
+    } catch (const std::exception& e) {
+        std::cerr << "Error reading " << sweepFile << ": " << e.what() << std::endl;
+        return 1;
+    }
+
+    std::string dataFile = sweep.value("data", "tests/historical_data/BTCUSDT_1m_historical_data.csv");
+    unsigned threads = sweep.value("threads", 0u);
+    size_t top = sweep.value("top", 20u);
+
+    std::vector<SweepPoint> points;
+    try {
+        json grid = sweep.value("grid", json::object());
+        for (const char* axis : SHORT_ONLY_AXES) {
+            if (grid.contains(axis) && grid[axis].size() > 1) {
+                std::cerr << "Note: " << axis << " does not affect long-only backtests" << std::endl;
+            }
+        }
+        points = buildGrid(grid);
+    } catch (const std::exception& e) {
+        std::cerr << "Invalid parameter grid: " << e.what() << std::endl;
+        return 1;
+    }
+
+    // Load the bars once; every run reads the same columns
+    BarStore store;
+    BarTable table;
+    BarColumns bars;
+    if (BarStore::isBarStore(dataFile)) {
+        if (!store.open(dataFile)) return 1;
+        bars = store.columns();
+    } else {
+        if (!loadBarsCsv(dataFile, table)) return 1;
+        bars = table.columns();
+    }
+
+    // Strategies only need these for live trading; construct them (and the
+    // Config singleton) once on this thread
+    BinanceAPI api;
+    OrderManager orderManager;
+
+    // Indicator series are shared by every run that uses the same period
+    IndicatorCache indicatorCache(bars);
+
+    std::vector<SweepResult> results(points.size());
+    auto start = std::chrono::steady_clock::now();
+    {
+        ThreadPool pool(threads);
+        std::cout << "Running " << points.size() << " backtests over " << bars.count
+                  << " bars on " << pool.size() << " threads..." << std::endl;
+
+        for (size_t i = 0; i < points.size(); i++) {
+            pool.submit([&, i] {
+                const SweepPoint& p = points[i];
+                EnhancedTradingStrategy strategy(api, orderManager, "BTCUSDT",
+                                                 p.fastEMA, p.slowEMA, p.signalEMA,
+                                                 p.rsiPeriod, p.rsiOverbought, p.rsiOversold);
+                Backtester backtester(strategy);
+                backtester.setHistoricalData(bars);
+                backtester.runVectorized(&indicatorCache);
+                results[i] = {p, backtester.getResults()};
+            });
+        }
+        pool.wait();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::stable_sort(results.begin(), results.end(), [](const SweepResult& a, const SweepResult& b) {
+        return a.result.totalReturn > b.result.totalReturn;
+    });
+
+    // Print ranked results
+    std::cout << "\n=== Parameter Sweep Results ===\n";
+    std::cout << std::left
+              << std::setw(6) << "Rank" << std::setw(6) << "Fast" << std::setw(6) << "Slow"
+              << std::setw(8) << "Signal" << std::setw(5) << "RSI" << std::setw(6) << "OB"
+              << std::setw(6) << "OS" << std::right
+              << std::setw(11) << "Return%" << std::setw(8) << "Trades" << std::setw(10) << "WinRate%"
+              << std::setw(11) << "Drawdown%" << std::setw(9) << "Sharpe" << "\n";
+    std::cout << std::fixed;
+    for (size_t i = 0; i < results.size() && i < top; i++) {
+        const SweepPoint& p = results[i].params;
+        const BacktestResult& r = results[i].result;
+        std::cout << std::left << std::setprecision(0)
+                  << std::setw(6) << i + 1 << std::setw(6) << p.fastEMA << std::setw(6) << p.slowEMA
+                  << std::setw(8) << p.signalEMA << std::setw(5) << p.rsiPeriod
+                  << std::setw(6) << p.rsiOverbought << std::setw(6) << p.rsiOversold
+                  << std::right << std::setprecision(3)
+                  << std::setw(11) << r.totalReturn << std::setw(8) << r.totalTrades
+                  << std::setw(10) << r.winRate << std::setw(11) << r.maxDrawdown
+                  << std::setw(9) << r.sharpeRatio << "\n";
+    }
+    std::cout << std::setprecision(2) << "\n" << results.size() << " runs in " << seconds
+              << " s (" << results.size() / seconds << " runs/s), "
+              << indicatorCache.computedSeries() << " distinct indicator series computed" << std::endl;
+
+    return 0;
+}
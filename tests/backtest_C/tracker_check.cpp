@@ -0,0 +1,238 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include "order_tracker.h"
+
+using Clock = std::chrono::steady_clock;
+
+static size_t failures = 0;
+
+static void expect(bool condition, const std::string& what) {
+    if (!condition) {
+        std::cerr << "Failed: " << what << std::endl;
+        failures++;
+    }
+}
+
+static Decimal quantity(const char* text) {
+    Decimal value;
+    Decimal::parse(text, value);
+    return value;
+}
+
+static TrackedOrder newOrder(const std::string& clientOrderId) {
+    TrackedOrder order;
+    order.clientOrderId = clientOrderId;
+    order.symbol = "BTCUSDT";
+    order.side = "BUY";
+    order.type = "LIMIT";
+    order.price = quantity("46000");
+    order.quantity = quantity("1");
+    return order;
+}
+
+static OrderAck ack(const std::string& clientOrderId, int64_t orderId, const char* status, const char* executed) {
+    OrderAck out;
+    out.symbol = "BTCUSDT";
+    out.clientOrderId = clientOrderId;
+    out.orderId = orderId;
+    out.status = status;
+    out.origQty = quantity("1");
+    out.executedQty = quantity(executed);
+    out.cummulativeQuoteQty = Decimal::fromDouble(out.executedQty.toDouble() * 46000);
+    return out;
+}
+
+static OrderStatus statusOf(const OrderTracker& tracker, const std::string& clientOrderId) {
+    TrackedOrder order;
+    return tracker.find(clientOrderId, order) ? order.status : OrderStatus::PendingNew;
+}
+
+// Replies that arrive late must not move an order back, in status or in
+// executed quantity, and are counted as stale
+static void checkOutOfOrder() {
+    OrderTracker tracker;
+    tracker.add(newOrder("late-new"));
+    expect(tracker.apply(ack("late-new", 1, "NEW", "0")), "NEW applies");
+    expect(tracker.apply(ack("late-new", 1, "FILLED", "1")), "FILLED applies");
+    expect(!tracker.apply(ack("late-new", 1, "PARTIALLY_FILLED", "0.5")), "PARTIALLY_FILLED after FILLED is ignored");
+    expect(!tracker.apply(ack("late-new", 1, "NEW", "0")), "NEW after FILLED is ignored");
+
+    // The fill report overtakes the order response
+    tracker.add(newOrder("fill-first"));
+    expect(tracker.apply(ack("fill-first", 2, "FILLED", "1")), "FILLED before NEW applies");
+    expect(!tracker.apply(ack("fill-first", 2, "NEW", "0")), "NEW after its fill is ignored");
+    TrackedOrder order;
+    expect(tracker.findByOrderId(2, order) && order.clientOrderId == "fill-first", "orderId learned from the fill");
+
+    // Partial fills report the executed quantity so far
+    tracker.add(newOrder("partial"));
+    Decimal filled;
+    expect(tracker.apply(ack("partial", 3, "PARTIALLY_FILLED", "0.3"), &filled) && filled == quantity("0.3"),
+           "first partial fill executes 0.3");
+    expect(tracker.apply(ack("partial", 3, "PARTIALLY_FILLED", "0.7"), &filled) && filled == quantity("0.4"),
+           "second partial fill executes 0.4 more");
+    expect(!tracker.apply(ack("partial", 3, "PARTIALLY_FILLED", "0.3")), "older partial fill is ignored");
+
+    OrderTracker::Stats stats = tracker.getStats();
+    expect(statusOf(tracker, "late-new") == OrderStatus::Filled && statusOf(tracker, "fill-first") == OrderStatus::Filled,
+           "late replies left the orders filled");
+    expect(tracker.find("partial", order) && order.executedQty == quantity("0.7"), "partial order keeps 0.7 executed");
+    expect(stats.stale == 4 && stats.applied == 5, "4 stale and 5 applied, got " + std::to_string(stats.stale) +
+           " and " + std::to_string(stats.applied));
+}
+
+// The order response and the execution report carry the same final state;
+// the second one is neither applied nor stale
+static void checkDuplicateFinal() {
+    OrderTracker tracker;
+    tracker.add(newOrder("dup"));
+    Decimal filled;
+    expect(tracker.apply(ack("dup", 10, "FILLED", "1"), &filled) && filled == quantity("1"), "fill applies");
+    expect(!tracker.apply(ack("dup", 10, "FILLED", "1"), &filled), "the same fill again is ignored");
+    expect(!tracker.apply(ack("dup", 0, "FILLED", "1")), "the same fill without orderId is ignored");
+    OrderTracker::Stats stats = tracker.getStats();
+    expect(stats.applied == 1 && stats.stale == 0, "duplicates are not counted, got " +
+           std::to_string(stats.applied) + " applied and " + std::to_string(stats.stale) + " stale");
+}
+
+// A cancel reply names the order in origClientOrderId; the execution report
+// of the same cancel and a second cancel change nothing, and a fill that
+// arrives after the cancel is stale
+static void checkCancelAfterCancel() {
+    OrderTracker tracker;
+    tracker.add(newOrder("cxl"));
+    expect(tracker.apply(ack("cxl", 20, "NEW", "0")), "NEW applies");
+
+    OrderAck reply = ack("cancel20", 20, "CANCELED", "0");
+    reply.origClientOrderId = "cxl";
+    expect(tracker.apply(reply), "cancel reply applies");
+    expect(!tracker.apply(ack("cxl", 20, "CANCELED", "0")), "cancel execution report is ignored");
+    expect(!tracker.apply(reply), "second cancel reply is ignored");
+    expect(!tracker.reject("cxl"), "a canceled order cannot be rejected");
+    uint64_t staleBefore = tracker.getStats().stale;
+    expect(!tracker.apply(ack("cxl", 20, "FILLED", "1")), "fill after cancel is ignored");
+
+    OrderTracker::Stats stats = tracker.getStats();
+    expect(statusOf(tracker, "cxl") == OrderStatus::Canceled, "order stays canceled");
+    expect(stats.applied == 2 && staleBefore == 0 && stats.stale == 1 && stats.open == 0,
+           "2 applied, stale only for the fill, got " + std::to_string(stats.applied) + " applied and " +
+           std::to_string(stats.stale) + " stale");
+}
+
+// removeClosed compacts the order vector and rebuilds both indexes: every
+// order left must still be found under both ids, updates must reach it, and
+// the removed ones must be gone
+static void checkLookupAfterRemove(size_t count) {
+    OrderTracker tracker;
+    for (size_t i = 0; i < count; i++) {
+        std::string id = "keep-" + std::to_string(i);
+        tracker.add(newOrder(id));
+        tracker.apply(ack(id, 1000 + i, i % 3 == 0 ? "NEW" : "FILLED", i % 3 == 0 ? "0" : "1"));
+    }
+    size_t removed = tracker.removeClosed(std::chrono::seconds(0));
+    size_t open = (count + 2) / 3;
+    expect(removed == count - open, "removed " + std::to_string(removed) + " of " + std::to_string(count - open));
+
+    size_t found = 0, gone = 0;
+    for (size_t i = 0; i < count; i++) {
+        std::string id = "keep-" + std::to_string(i);
+        TrackedOrder byClient, byExchange;
+        bool inClient = tracker.find(id, byClient);
+        bool inExchange = tracker.findByOrderId(1000 + i, byExchange);
+        if (i % 3 == 0) {
+            found += inClient && inExchange && byClient.clientOrderId == id && byExchange.clientOrderId == id &&
+                     byExchange.orderId == static_cast<int64_t>(1000 + i);
+        } else {
+            gone += !inClient && !inExchange;
+        }
+    }
+    expect(found == open && gone == count - open, "after removeClosed " + std::to_string(found) + " of " +
+           std::to_string(open) + " found, " + std::to_string(gone) + " of " + std::to_string(count - open) + " gone");
+
+    // Updates and new orders land where the rebuilt indexes point
+    expect(tracker.apply(ack("keep-3", 1003, "FILLED", "1")) && statusOf(tracker, "keep-3") == OrderStatus::Filled,
+           "update after removeClosed reaches the order");
+    expect(statusOf(tracker, "keep-6") == OrderStatus::New, "its neighbour is untouched");
+    expect(tracker.add(newOrder("after")) && tracker.apply(ack("after", 99, "NEW", "0")), "add after removeClosed");
+    TrackedOrder order;
+    expect(tracker.findByOrderId(99, order) && order.clientOrderId == "after", "new order found by orderId");
+    expect(!tracker.add(newOrder("keep-0")), "a kept id is still taken");
+}
+
+// `threads` writers each add, acknowledge and fill their own orders while
+// they look up orders of the others; nothing may be lost or mixed up
+static void checkConcurrent(unsigned threads, size_t perThread) {
+    OrderTracker tracker;
+    std::atomic<size_t> lookupsWrong{0};
+    std::vector<std::thread> workers;
+    Clock::time_point start = Clock::now();
+    for (unsigned t = 0; t < threads; t++) {
+        workers.emplace_back([&, t] {
+            size_t wrong = 0;
+            for (size_t i = 0; i < perThread; i++) {
+                std::string id = "t" + std::to_string(t) + "-" + std::to_string(i);
+                int64_t orderId = static_cast<int64_t>(t * perThread + i + 1);
+                tracker.add(newOrder(id));
+                tracker.apply(ack(id, orderId, "NEW", "0"));
+                tracker.apply(ack(id, orderId, "FILLED", "1"));
+
+                // Someone else's order, whatever state it is in by now
+                size_t other = (t + 1) % threads;
+                TrackedOrder order;
+                if (tracker.findByOrderId(static_cast<int64_t>(other * perThread + i / 2 + 1), order) &&
+                    order.clientOrderId != "t" + std::to_string(other) + "-" + std::to_string(i / 2)) {
+                    wrong++;
+                }
+            }
+            lookupsWrong += wrong;
+        });
+    }
+    for (std::thread& worker : workers) worker.join();
+    double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+    size_t total = threads * perThread, missing = 0;
+    for (unsigned t = 0; t < threads; t++) {
+        for (size_t i = 0; i < perThread; i++) {
+            TrackedOrder order;
+            std::string id = "t" + std::to_string(t) + "-" + std::to_string(i);
+            missing += !tracker.findByOrderId(static_cast<int64_t>(t * perThread + i + 1), order) ||
+                       order.clientOrderId != id || order.status != OrderStatus::Filled;
+        }
+    }
+    OrderTracker::Stats stats = tracker.getStats();
+    std::cout << threads << " threads, " << total << " orders added, acknowledged and filled in " << ms << " ms: "
+              << stats.tracked << " tracked, " << stats.open << " open, " << stats.applied << " applied, "
+              << stats.stale << " stale, " << missing << " missing or wrong, " << lookupsWrong
+              << " wrong concurrent lookups" << std::endl;
+    expect(stats.tracked == total && stats.open == 0 && stats.applied == 2 * total && stats.stale == 0 &&
+           stats.unknown == 0 && missing == 0 && lookupsWrong == 0, "concurrent add/apply/find");
+}
+
+// OrderTracker: out-of-order, duplicate and repeated cancel replies,
+// lookups after removeClosed, and writers and readers on several threads:
+//   tracker_check [--threads 4] [--orders 200000]
+int main(int argc, char* argv[]) {
+    unsigned threads = 4;
+    size_t orders = 200000;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--threads" && i + 1 < argc) threads = std::stoul(argv[++i]);
+        else if (arg == "--orders" && i + 1 < argc) orders = std::stoul(argv[++i]);
+        else {
+            std::cerr << "Usage: " << argv[0] << " [--threads 4] [--orders 200000]" << std::endl;
+            return 1;
+        }
+    }
+
+    checkOutOfOrder();
+    checkDuplicateFinal();
+    checkCancelAfterCancel();
+    checkLookupAfterRemove(1000);
+    checkConcurrent(threads, orders / threads);
+    std::cout << (failures == 0 ? "All checks passed" : std::to_string(failures) + " checks failed") << std::endl;
+    return failures == 0 ? 0 : 1;
+}
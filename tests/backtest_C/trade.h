@@ -1,11 +1,12 @@
 #pragma once
 #include <string>
 #include <chrono>
+#include "decimal.h"
 
 class Trade {
 public:
     Trade(const std::string& timestamp, const std::string& symbol, 
-          const std::string& side, double price, double quantity, double pnl)
+          const std::string& side, Decimal price, Decimal quantity, Decimal pnl)
         : timestamp(timestamp)
         , symbol(symbol)
         , side(side)
@@ -16,7 +17,7 @@ public:
     std::string timestamp;
     std::string symbol;
     std::string side;
-    double price;
-    double quantity;
-    double pnl;
+    Decimal price;
+    Decimal quantity;
+    Decimal pnl;
 };
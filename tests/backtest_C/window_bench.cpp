@@ -0,0 +1,196 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <numeric>
+#include <algorithm>
+#include "window_kernels.h"
+#include "cpu_features.h"
+
+// The loops the window kernels replaced, as the strategies, the backtester
+// and ATRIndicator had them
+namespace baseline {
+
+double mean(const double* x, size_t n) {
+    return std::accumulate(x, x + n, 0.0) / n;
+}
+
+double variance(const double* x, size_t n) {
+    double m = std::accumulate(x, x + n, 0.0) / n;
+    double variance = 0;
+    for (size_t i = 0; i < n; i++) {
+        variance += std::pow(x[i] - m, 2);
+    }
+    return variance / n;
+}
+
+double min(const double* x, size_t n) {
+    return *std::min_element(x, x + n);
+}
+
+double max(const double* x, size_t n) {
+    return *std::max_element(x, x + n);
+}
+
+// isSupportLevel stopped at the third touch; counting all of them is the
+// same work countWithin does
+size_t touches(const double* x, size_t n, double center, double threshold) {
+    size_t count = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (std::abs(x[i] - center) < threshold) count++;
+    }
+    return count;
+}
+
+void trueRange(const double* high, const double* low, const double* prevClose, size_t n, double* out) {
+    for (size_t i = 0; i < n; i++) {
+        double tr1 = high[i] - low[i];
+        double tr2 = std::abs(high[i] - prevClose[i]);
+        double tr3 = std::abs(low[i] - prevClose[i]);
+        out[i] = std::max({tr1, tr2, tr3});
+    }
+}
+
+}  // namespace baseline
+
+// Keeps the compiler from hoisting a call on unchanged inputs out of the loop
+static inline void clobber() {
+    asm volatile("" ::: "memory");
+}
+
+// Best of three, in ns per call
+template <typename Call>
+static double timeCall(Call call, size_t iterations) {
+    double best = 0;
+    for (int run = 0; run < 3; run++) {
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < iterations; i++) {
+            call();
+            clobber();
+        }
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        if (run == 0 || ns < best) best = ns;
+    }
+    return best / iterations;
+}
+
+static bool sameBits(double a, double b) {
+    return std::memcmp(&a, &b, sizeof(double)) == 0;
+}
+
+struct Row {
+    std::string name;
+    double baseline;
+    std::vector<double> levels;
+};
+
+static void printRows(const std::vector<Row>& rows, const std::vector<SimdLevel>& levels) {
+    std::cout << std::left << std::setw(22) << "kernel" << std::right << std::setw(11) << "original";
+    for (SimdLevel level : levels) std::cout << std::setw(11) << simdLevelName(level);
+    std::cout << "   (ns per call)\n" << std::fixed << std::setprecision(1);
+    for (const Row& row : rows) {
+        std::cout << std::left << std::setw(22) << row.name << std::right << std::setw(11) << row.baseline;
+        for (double ns : row.levels) std::cout << std::setw(11) << ns;
+        std::cout << "\n";
+    }
+    std::cout << std::defaultfloat << std::setprecision(6);
+}
+
+// Times each window kernel at every SIMD level up to the detected one,
+// against the scalar loops it replaced, and checks every level returns the
+// same bits as the scalar kernel:
+//   window_bench [window sizes...]     (default 20 200 2000)
+int main(int argc, char* argv[]) {
+    std::vector<size_t> sizes;
+    for (int i = 1; i < argc; i++) {
+        size_t n = std::strtoull(argv[i], nullptr, 10);
+        if (n == 0) {
+            std::cerr << "Usage: " << argv[0] << " [window sizes...]" << std::endl;
+            return 1;
+        }
+        sizes.push_back(n);
+    }
+    if (sizes.empty()) sizes = {20, 200, 2000};
+
+    std::vector<SimdLevel> levels;
+    for (SimdLevel level : {SimdLevel::Scalar, SimdLevel::SSE2, SimdLevel::AVX2, SimdLevel::AVX512}) {
+        if (level <= detectedSimdLevel()) levels.push_back(level);
+    }
+    std::cout << "Detected " << simdLevelName(detectedSimdLevel()) << std::endl;
+
+    std::mt19937_64 rng(7);
+    std::normal_distribution<double> move(0.0, 0.002);
+    std::uniform_real_distribution<double> wick(0.0, 0.003);
+    bool identical = true;
+
+    for (size_t n : sizes) {
+        // A price path and bars around it
+        std::vector<double> close(n + 1), high(n), low(n), out(n), expected(n);
+        close[0] = 30000.0;
+        for (size_t i = 1; i <= n; i++) close[i] = close[i - 1] * (1.0 + move(rng));
+        for (size_t i = 0; i < n; i++) {
+            high[i] = std::max(close[i], close[i + 1]) * (1.0 + wick(rng));
+            low[i] = std::min(close[i], close[i + 1]) * (1.0 - wick(rng));
+        }
+        const double* x = close.data() + 1;
+        double center = x[n - 1];
+        double threshold = center * 0.005;
+        size_t iterations = std::max<size_t>(1000, 20000000 / n);
+        double sink = 0;
+
+        std::vector<Row> rows = {
+            {"mean", timeCall([&] { sink += baseline::mean(x, n); }, iterations), {}},
+            {"variance", timeCall([&] { sink += baseline::variance(x, n); }, iterations), {}},
+            {"min", timeCall([&] { sink += baseline::min(x, n); }, iterations), {}},
+            {"max", timeCall([&] { sink += baseline::max(x, n); }, iterations), {}},
+            {"countWithin", timeCall([&] { sink += baseline::touches(x, n, center, threshold); }, iterations), {}},
+            {"trueRange", timeCall([&] { baseline::trueRange(high.data(), low.data(), close.data(), n, out.data()); },
+                                   iterations), {}},
+        };
+
+        double scalar[5] = {};
+        for (SimdLevel level : levels) {
+            limitSimdLevel(level);
+            rows[0].levels.push_back(timeCall([&] { sink += windowMean(x, n); }, iterations));
+            rows[1].levels.push_back(timeCall([&] { sink += windowVariance(x, n); }, iterations));
+            rows[2].levels.push_back(timeCall([&] { sink += windowMin(x, n); }, iterations));
+            rows[3].levels.push_back(timeCall([&] { sink += windowMax(x, n); }, iterations));
+            rows[4].levels.push_back(timeCall([&] { sink += countWithin(x, n, center, threshold); }, iterations));
+            rows[5].levels.push_back(timeCall([&] { trueRange(high.data(), low.data(), close.data(), n, out.data()); },
+                                              iterations));
+
+            double results[5] = {windowMean(x, n), windowVariance(x, n), windowMin(x, n), windowMax(x, n),
+                                 static_cast<double>(countWithin(x, n, center, threshold))};
+            trueRange(high.data(), low.data(), close.data(), n, out.data());
+            if (level == SimdLevel::Scalar) {
+                std::copy(results, results + 5, scalar);
+                expected = out;
+            }
+            for (int k = 0; k < 5; k++) {
+                if (!sameBits(results[k], scalar[k])) {
+                    std::cerr << rows[k].name << " at " << simdLevelName(level) << ", n = " << n
+                              << ": " << results[k] << " vs scalar " << scalar[k] << std::endl;
+                    identical = false;
+                }
+            }
+            if (std::memcmp(out.data(), expected.data(), n * sizeof(double)) != 0) {
+                std::cerr << "trueRange at " << simdLevelName(level) << ", n = " << n << " differs from scalar"
+                          << std::endl;
+                identical = false;
+            }
+        }
+        limitSimdLevel(SimdLevel::AVX512);
+
+        std::cout << "\nn = " << n << " (checksum " << sink << ")\n";
+        printRows(rows, levels);
+    }
+
+    if (!identical) return 1;
+    std::cout << "\nAll levels bit-identical to the scalar kernels" << std::endl;
+    return 0;
+}
@@ -0,0 +1,51 @@
+import requests
+import websocket
+import time
+
+# Records a depth snapshot plus the diff depth stream as a fixture for
+# book_replay: one JSON text per line, in the order they arrived.
+BINANCE_API_URL = "https://api.binance.us/api/v3/depth"
+BINANCE_WS_URL = "wss://stream.binance.us:9443/ws"
+
+# Parameters
+symbol = "BTCUSDT"        # Trading pair
+stream = "depth@100ms"    # Diff depth stream kind
+limit = 1000              # Levels per side in a snapshot
+duration = 300            # Seconds to record
+snapshot_every = 60       # Seconds between snapshots; book_replay uses one after a gap
+
+def fetch_snapshot():
+    # Add retry logic
+    max_retries = 3
+    for attempt in range(max_retries):
+        try:
+            response = requests.get(BINANCE_API_URL, params={"symbol": symbol, "limit": limit}, timeout=10)
+            response.raise_for_status()
+            return response.text
+        except requests.exceptions.RequestException as e:
+            if attempt == max_retries - 1:
+                raise
+            print(f"Attempt {attempt + 1} failed, retrying...")
+            time.sleep(2)
+
+ws = websocket.create_connection(f"{BINANCE_WS_URL}/{symbol.lower()}@{stream}", timeout=10)
+
+# The first event goes in before the snapshot, so the snapshot can be lined up with the stream
+filename = f"{symbol}_depth.jsonl"
+events = 0
+snapshots = 0
+with open(filename, "w") as f:
+    f.write(ws.recv() + "\n")
+    events += 1
+    start = time.time()
+    next_snapshot = start
+    while time.time() - start < duration:
+        if time.time() >= next_snapshot:
+            f.write(fetch_snapshot().replace("\n", "") + "\n")
+            snapshots += 1
+            next_snapshot += snapshot_every
+        f.write(ws.recv() + "\n")
+        events += 1
+
+ws.close()
+print(f"Recorded {events} events and {snapshots} snapshots to {filename}")